@@ -0,0 +1,480 @@
+#include "common/ipaddress.h"
+#include "common/ipaddresses.h"
+#include "common/ipprefix.h"
+#include "common/macaddress.h"
+
+#include "allocations.h"
+#include "benchmark/benchmark.h"
+
+#include <arpa/inet.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+const size_t COUNT = 4096;
+
+vector<IpAddress> makeAddresses(int family)
+{
+    mt19937 gen(1);
+    vector<IpAddress> addresses;
+
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        ip_addr_t ip;
+        ip.family = static_cast<uint8_t>(family);
+        for (auto &b : ip.ip_addr.ipv6_addr)
+            b = static_cast<unsigned char>(gen());
+        /* Route like IPv6 addresses with a run of zeros */
+        if (family == AF_INET6)
+            memset(ip.ip_addr.ipv6_addr + 6, 0, 8);
+        addresses.push_back(IpAddress(ip));
+    }
+
+    return addresses;
+}
+
+vector<string> makeStrings(int family)
+{
+    vector<string> strings;
+    for (const auto &ip : makeAddresses(family))
+        strings.push_back(ip.to_string());
+    return strings;
+}
+
+vector<string> makeMacStrings()
+{
+    mt19937 gen(2);
+    vector<string> strings;
+
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        uint8_t mac[ETHER_ADDR_LEN];
+        for (auto &b : mac)
+            b = static_cast<uint8_t>(gen());
+        strings.push_back(MacAddress(mac).to_string());
+    }
+
+    return strings;
+}
+
+vector<IpPrefix> makePrefixes(int family)
+{
+    vector<IpPrefix> prefixes;
+    for (const auto &ip : makeAddresses(family))
+        prefixes.push_back(IpPrefix(ip.to_string() + (family == AF_INET ? "/24" : "/64")).getSubnet());
+    return prefixes;
+}
+
+/* Next hop lists of routes, as in the nexthop field of ROUTE_TABLE */
+vector<string> makeNextHopLists(int family, size_t size)
+{
+    auto addresses = makeAddresses(family);
+    vector<string> lists;
+
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        string list;
+        for (size_t j = 0; j < size; j++)
+            list += (j == 0 ? "" : ",") + addresses[(i + j) % COUNT].to_string();
+        lists.push_back(list);
+    }
+
+    return lists;
+}
+
+}
+
+/* What IpAddress(const string &) did before, inet_pton on the family found by ':' */
+static void BM_IpParseInetPton(benchmark::State &state)
+{
+    auto strings = makeStrings(static_cast<int>(state.range(0)));
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        const string &str = strings[i];
+        ip_addr_t ip;
+        ip.family = str.find(':') != string::npos ? AF_INET6 : AF_INET;
+        benchmark::DoNotOptimize(inet_pton(ip.family, str.c_str(), &ip.ip_addr));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpParseInetPton)->Arg(AF_INET)->Arg(AF_INET6);
+
+static void BM_IpParse(benchmark::State &state)
+{
+    auto strings = makeStrings(static_cast<int>(state.range(0)));
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        IpAddress ip;
+        benchmark::DoNotOptimize(IpAddress::parse(strings[i].data(), strings[i].size(), ip));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpParse)->Arg(AF_INET)->Arg(AF_INET6);
+
+/* What IpAddress::to_string did before */
+static void BM_IpFormatInetNtop(benchmark::State &state)
+{
+    auto addresses = makeAddresses(static_cast<int>(state.range(0)));
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        char buf[INET6_ADDRSTRLEN];
+        ip_addr_t ip = addresses[i].getIp();
+        string str(inet_ntop(ip.family, &ip.ip_addr, buf, INET6_ADDRSTRLEN));
+        benchmark::DoNotOptimize(str);
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpFormatInetNtop)->Arg(AF_INET)->Arg(AF_INET6);
+
+static void BM_IpFormat(benchmark::State &state)
+{
+    auto addresses = makeAddresses(static_cast<int>(state.range(0)));
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        char buf[IpAddress::MAX_STRING_SIZE];
+        benchmark::DoNotOptimize(addresses[i].to_string(buf, sizeof(buf)));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpFormat)->Arg(AF_INET)->Arg(AF_INET6);
+
+static void BM_IpFormatString(benchmark::State &state)
+{
+    auto addresses = makeAddresses(static_cast<int>(state.range(0)));
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(addresses[i].to_string());
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpFormatString)->Arg(AF_INET)->Arg(AF_INET6);
+
+static void BM_IpPrefixFromString(benchmark::State &state)
+{
+    auto strings = makeStrings(static_cast<int>(state.range(0)));
+    for (auto &str : strings)
+        str += state.range(0) == AF_INET ? "/24" : "/64";
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(IpPrefix(strings[i]));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpPrefixFromString)->Arg(AF_INET)->Arg(AF_INET6);
+
+/* Per nibble parsing done by parseMacString before */
+static bool legacyParseMac(const string &str, uint8_t *mac)
+{
+    if (str.length() != 17 || str[2] != str[5] || str[5] != str[8] || str[8] != str[11] ||
+        str[11] != str[14] || (str[2] != ':' && str[2] != '-'))
+        return false;
+
+    for (int i = 0; i < ETHER_ADDR_LEN; i++)
+    {
+        uint8_t value = 0;
+        for (int j = 0; j < 2; j++)
+        {
+            char c = str[i * 3 + j];
+            value = static_cast<uint8_t>(value << 4);
+            if (c >= '0' && c <= '9')
+                value = static_cast<uint8_t>(value | (c - '0'));
+            else if (c >= 'A' && c <= 'F')
+                value = static_cast<uint8_t>(value | (c - 'A' + 0x0a));
+            else if (c >= 'a' && c <= 'f')
+                value = static_cast<uint8_t>(value | (c - 'a' + 0x0a));
+            else
+                return false;
+        }
+        mac[i] = value;
+    }
+
+    return true;
+}
+
+static void BM_MacParseLegacy(benchmark::State &state)
+{
+    auto strings = makeMacStrings();
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        uint8_t mac[ETHER_ADDR_LEN];
+        benchmark::DoNotOptimize(legacyParseMac(strings[i], mac));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MacParseLegacy);
+
+static void BM_MacParse(benchmark::State &state)
+{
+    auto strings = makeMacStrings();
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        uint8_t mac[ETHER_ADDR_LEN];
+        benchmark::DoNotOptimize(MacAddress::parseMacString(strings[i].data(), strings[i].size(), mac));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MacParse);
+
+static void BM_MacFormat(benchmark::State &state)
+{
+    auto strings = makeMacStrings();
+    vector<MacAddress> macs(strings.begin(), strings.end());
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        char buf[MacAddress::STRING_SIZE];
+        benchmark::DoNotOptimize(macs[i].to_string(buf, sizeof(buf)));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MacFormat);
+
+static void BM_IpCompare(benchmark::State &state)
+{
+    auto addresses = makeAddresses(static_cast<int>(state.range(0)));
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(addresses[i] < addresses[(i + 1) % COUNT]);
+        benchmark::DoNotOptimize(addresses[i] == addresses[(i + 1) % COUNT]);
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpCompare)->Arg(AF_INET)->Arg(AF_INET6);
+
+static void BM_IpHash(benchmark::State &state)
+{
+    auto addresses = makeAddresses(static_cast<int>(state.range(0)));
+    std::hash<IpAddress> hasher;
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(hasher(addresses[i]));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpHash)->Arg(AF_INET)->Arg(AF_INET6);
+
+static void BM_IpPrefixFormat(benchmark::State &state)
+{
+    auto prefixes = makePrefixes(static_cast<int>(state.range(0)));
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(prefixes[i].to_string());
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpPrefixFormat)->Arg(AF_INET)->Arg(AF_INET6);
+
+static void BM_IpPrefixSort(benchmark::State &state)
+{
+    auto prefixes = makePrefixes(static_cast<int>(state.range(0)));
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = prefixes;
+        state.ResumeTiming();
+
+        sort(sorted.begin(), sorted.end());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    allocations.report(state, state.iterations() * static_cast<int64_t>(COUNT));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(COUNT));
+}
+BENCHMARK(BM_IpPrefixSort)->Arg(AF_INET)->Arg(AF_INET6);
+
+/* Route lookups by prefix in the ordered and hashed containers of the daemons */
+static void BM_IpPrefixMapFind(benchmark::State &state)
+{
+    auto prefixes = makePrefixes(static_cast<int>(state.range(0)));
+    map<IpPrefix, size_t> routes;
+    for (size_t i = 0; i < COUNT; i++)
+        routes[prefixes[i]] = i;
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(routes.find(prefixes[i]));
+        i = (i + 7) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpPrefixMapFind)->Arg(AF_INET)->Arg(AF_INET6);
+
+static void BM_IpPrefixHashSetFind(benchmark::State &state)
+{
+    auto prefixes = makePrefixes(static_cast<int>(state.range(0)));
+    unordered_set<IpPrefix> routes(prefixes.begin(), prefixes.end());
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(routes.find(prefixes[i]));
+        i = (i + 7) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpPrefixHashSetFind)->Arg(AF_INET)->Arg(AF_INET6);
+
+static void BM_MacCompare(benchmark::State &state)
+{
+    auto strings = makeMacStrings();
+    vector<MacAddress> macs(strings.begin(), strings.end());
+    std::hash<MacAddress> hasher;
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(macs[i] < macs[(i + 1) % COUNT]);
+        benchmark::DoNotOptimize(macs[i] == macs[(i + 1) % COUNT]);
+        benchmark::DoNotOptimize(hasher(macs[i]));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MacCompare);
+
+/* Next hop lists of 1 to 8 members */
+static void BM_IpAddressesParse(benchmark::State &state)
+{
+    auto lists = makeNextHopLists(AF_INET, static_cast<size_t>(state.range(0)));
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(IpAddresses(lists[i]));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpAddressesParse)->Arg(1)->Arg(8);
+
+static void BM_IpAddressesFormat(benchmark::State &state)
+{
+    auto lists = makeNextHopLists(AF_INET, static_cast<size_t>(state.range(0)));
+    vector<IpAddresses> addresses(lists.begin(), lists.end());
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(addresses[i].to_string());
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpAddressesFormat)->Arg(1)->Arg(8);
+
+static void BM_IpAddressesContains(benchmark::State &state)
+{
+    auto lists = makeNextHopLists(AF_INET, static_cast<size_t>(state.range(0)));
+    vector<IpAddresses> addresses(lists.begin(), lists.end());
+    auto wanted = makeAddresses(AF_INET);
+    size_t i = 0;
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(addresses[i].contains(wanted[(i + 3) % COUNT]));
+        i = (i + 1) % COUNT;
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpAddressesContains)->Arg(1)->Arg(8);
@@ -0,0 +1,49 @@
+#include "allocations.h"
+
+#include <stdlib.h>
+#include <new>
+
+namespace
+{
+
+/* Per thread, so that counting does not share a cache line between the benchmark threads */
+thread_local uint64_t allocations = 0;
+
+void *allocate(size_t size)
+{
+    allocations++;
+
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+}
+
+uint64_t threadAllocations()
+{
+    return allocations;
+}
+
+/* Replace the global allocation functions, for the library too */
+void *operator new(size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new[](size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
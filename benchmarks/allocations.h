@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "benchmark/benchmark.h"
+
+/* Calls to operator new made by the calling thread, counted in allocations.cpp */
+uint64_t threadAllocations();
+
+/*
+ * Reports the allocations of a benchmark thread from its construction as
+ * the "allocs" counter, per item processed.
+ */
+class AllocationCounter
+{
+public:
+    AllocationCounter() : m_start(threadAllocations())
+    {
+    }
+
+    void report(benchmark::State &state, int64_t items)
+    {
+        double allocations = static_cast<double>(threadAllocations() - m_start);
+        state.counters["allocs"] = benchmark::Counter(items > 0 ? allocations / static_cast<double>(items) : 0,
+                                                      benchmark::Counter::kAvgThreads);
+    }
+
+private:
+    uint64_t m_start;
+};
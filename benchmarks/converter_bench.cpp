@@ -0,0 +1,115 @@
+#include "common/converter.h"
+
+#include "allocations.h"
+#include "benchmark/benchmark.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+/* Counter and attribute values as read from COUNTERS_DB and CONFIG_DB */
+const vector<string> VALUES = {
+    "0", "9100", "1234567", "98765432101", "18446744073709551615", "0x1F",
+};
+
+/* __to_uint64 before it was rebuilt on try_to_uint64 */
+uint64_t legacyToUint64(const string &str)
+{
+    size_t idx = 0;
+    uint64_t ret = stoul(str, &idx, 0);
+    if (str[idx])
+    {
+        throw invalid_argument("failed to convert " + str + " value to uint64_t type");
+    }
+
+    return ret;
+}
+
+}
+
+static void BM_ToUint64Legacy(benchmark::State &state)
+{
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        for (const auto &value : VALUES)
+            benchmark::DoNotOptimize(legacyToUint64(value));
+    }
+
+    allocations.report(state, state.iterations() * static_cast<int64_t>(VALUES.size()));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(VALUES.size()));
+}
+BENCHMARK(BM_ToUint64Legacy);
+
+static void BM_ToUint64(benchmark::State &state)
+{
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        for (const auto &value : VALUES)
+            benchmark::DoNotOptimize(to_uint<uint64_t>(value));
+    }
+
+    allocations.report(state, state.iterations() * static_cast<int64_t>(VALUES.size()));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(VALUES.size()));
+}
+BENCHMARK(BM_ToUint64);
+
+static void BM_TryToUint64(benchmark::State &state)
+{
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        for (const auto &value : VALUES)
+        {
+            uint64_t ret;
+            benchmark::DoNotOptimize(try_to_uint64(value.data(), value.size(), ret));
+            benchmark::DoNotOptimize(ret);
+        }
+    }
+
+    allocations.report(state, state.iterations() * static_cast<int64_t>(VALUES.size()));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(VALUES.size()));
+}
+BENCHMARK(BM_TryToUint64);
+
+/* Invalid values, where the throwing API pays for an exception */
+static void BM_ToUint64Invalid(benchmark::State &state)
+{
+    string value("n/a");
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        try
+        {
+            benchmark::DoNotOptimize(to_uint<uint64_t>(value));
+        }
+        catch (const invalid_argument &)
+        {
+        }
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_ToUint64Invalid);
+
+static void BM_TryToUint64Invalid(benchmark::State &state)
+{
+    string value("n/a");
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        uint64_t ret;
+        benchmark::DoNotOptimize(try_to_uint64(value.data(), value.size(), ret));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_TryToUint64Invalid);
@@ -0,0 +1,204 @@
+#include "common/flathashmap.h"
+#include "common/ipaddress.h"
+#include "common/macaddress.h"
+
+#include "benchmark/benchmark.h"
+
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+const size_t LOOKUPS = 65536;
+
+/* Neighbor table like IPv6 keys */
+vector<IpAddress> makeAddresses(size_t count, uint32_t seed)
+{
+    mt19937 gen(seed);
+    vector<IpAddress> addresses;
+    addresses.reserve(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        ip_addr_t ip;
+        ip.family = AF_INET6;
+        for (int j = 0; j < 16; j += 4)
+        {
+            uint32_t r = static_cast<uint32_t>(gen());
+            memcpy(&ip.ip_addr.ipv6_addr[j], &r, sizeof(r));
+        }
+        addresses.push_back(IpAddress(ip));
+    }
+
+    return addresses;
+}
+
+/* Keys present in the table, in a random order */
+vector<size_t> makeLookups(size_t count)
+{
+    mt19937 gen(3);
+    vector<size_t> lookups;
+    lookups.reserve(LOOKUPS);
+
+    for (size_t i = 0; i < LOOKUPS; i++)
+    {
+        lookups.push_back(gen() % count);
+    }
+
+    return lookups;
+}
+
+}
+
+template<typename Map>
+static void lookupAddresses(benchmark::State &state, Map &map, const vector<IpAddress> &keys)
+{
+    auto lookups = makeLookups(keys.size());
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(map.find(keys[lookups[i]]));
+        i = (i + 1) % LOOKUPS;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_FlatHashMapIpLookup(benchmark::State &state)
+{
+    auto keys = makeAddresses(static_cast<size_t>(state.range(0)), 1);
+    FlatHashMap<IpAddress, uint32_t> map;
+    for (size_t i = 0; i < keys.size(); i++)
+        map.insert(keys[i], static_cast<uint32_t>(i));
+
+    lookupAddresses(state, map, keys);
+}
+BENCHMARK(BM_FlatHashMapIpLookup)->Arg(1000)->Arg(1000000);
+
+static void BM_UnorderedMapIpLookup(benchmark::State &state)
+{
+    auto keys = makeAddresses(static_cast<size_t>(state.range(0)), 1);
+    unordered_map<IpAddress, uint32_t> map;
+    for (size_t i = 0; i < keys.size(); i++)
+        map[keys[i]] = static_cast<uint32_t>(i);
+
+    lookupAddresses(state, map, keys);
+}
+BENCHMARK(BM_UnorderedMapIpLookup)->Arg(1000)->Arg(1000000);
+
+static void BM_MapIpLookup(benchmark::State &state)
+{
+    auto keys = makeAddresses(static_cast<size_t>(state.range(0)), 1);
+    map<IpAddress, uint32_t> map;
+    for (size_t i = 0; i < keys.size(); i++)
+        map[keys[i]] = static_cast<uint32_t>(i);
+
+    lookupAddresses(state, map, keys);
+}
+BENCHMARK(BM_MapIpLookup)->Arg(1000)->Arg(1000000);
+
+/* Keyed by the address string, as tables read from the database are */
+template<typename Map>
+static void lookupStrings(benchmark::State &state)
+{
+    auto keys = makeAddresses(static_cast<size_t>(state.range(0)), 1);
+    vector<string> strings;
+    Map map;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        strings.push_back(keys[i].to_string());
+        map[strings.back()] = static_cast<uint32_t>(i);
+    }
+
+    auto lookups = makeLookups(keys.size());
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(map.find(strings[lookups[i]]));
+        i = (i + 1) % LOOKUPS;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_UnorderedMapStringLookup(benchmark::State &state)
+{
+    lookupStrings<unordered_map<string, uint32_t>>(state);
+}
+BENCHMARK(BM_UnorderedMapStringLookup)->Arg(1000)->Arg(1000000);
+
+static void BM_MapStringLookup(benchmark::State &state)
+{
+    lookupStrings<map<string, uint32_t>>(state);
+}
+BENCHMARK(BM_MapStringLookup)->Arg(1000)->Arg(1000000);
+
+static void BM_FlatHashMapIpInsert(benchmark::State &state)
+{
+    auto keys = makeAddresses(static_cast<size_t>(state.range(0)), 1);
+
+    for (auto _ : state)
+    {
+        FlatHashMap<IpAddress, uint32_t> map;
+        for (size_t i = 0; i < keys.size(); i++)
+            map.insert(keys[i], static_cast<uint32_t>(i));
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FlatHashMapIpInsert)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_UnorderedMapIpInsert(benchmark::State &state)
+{
+    auto keys = makeAddresses(static_cast<size_t>(state.range(0)), 1);
+
+    for (auto _ : state)
+    {
+        unordered_map<IpAddress, uint32_t> map;
+        for (size_t i = 0; i < keys.size(); i++)
+            map[keys[i]] = static_cast<uint32_t>(i);
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UnorderedMapIpInsert)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+/* FDB like keys */
+static void BM_FlatHashMapMacLookup(benchmark::State &state)
+{
+    mt19937 gen(4);
+    vector<MacAddress> keys;
+    FlatHashMap<MacAddress, uint32_t> map;
+
+    for (int64_t i = 0; i < state.range(0); i++)
+    {
+        uint8_t mac[ETHER_ADDR_LEN];
+        for (auto &b : mac)
+            b = static_cast<uint8_t>(gen());
+        keys.push_back(MacAddress(mac));
+        map.insert(keys.back(), static_cast<uint32_t>(i));
+    }
+
+    auto lookups = makeLookups(keys.size());
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(map.find(keys[lookups[i]]));
+        i = (i + 1) % LOOKUPS;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FlatHashMapMacLookup)->Arg(1000000);
@@ -0,0 +1,115 @@
+#include "common/ipprefixbatch.h"
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+const size_t ADDRESSES = 1000000;
+
+vector<IpAddress> makeAddresses(bool v4)
+{
+    mt19937 gen(1);
+    vector<IpAddress> addresses;
+    addresses.reserve(ADDRESSES);
+
+    for (size_t i = 0; i < ADDRESSES; i++)
+    {
+        ip_addr_t ip;
+        ip.family = v4 ? AF_INET : AF_INET6;
+        for (auto &b : ip.ip_addr.ipv6_addr)
+            b = static_cast<unsigned char>(gen());
+        addresses.push_back(IpAddress(ip));
+    }
+
+    return addresses;
+}
+
+}
+
+/* One isAddressInSubnet call per address, as done before */
+static void BM_IsAddressInSubnet(benchmark::State &state)
+{
+    bool v4 = state.range(0) == AF_INET;
+    auto addresses = makeAddresses(v4);
+    IpPrefix prefix(v4 ? "10.0.0.0/8" : "2001:db8::/32");
+
+    for (auto _ : state)
+    {
+        size_t matched = 0;
+        for (const auto &addr : addresses)
+            matched += prefix.isAddressInSubnet(addr);
+        benchmark::DoNotOptimize(matched);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ADDRESSES));
+}
+BENCHMARK(BM_IsAddressInSubnet)->Arg(AF_INET)->Arg(AF_INET6)->Unit(benchmark::kMillisecond);
+
+static void BM_IpPrefixMatcherV4(benchmark::State &state)
+{
+    auto addresses = makeAddresses(true);
+    vector<uint32_t> packed;
+    for (const auto &addr : addresses)
+        packed.push_back(addr.getV4Addr());
+
+    IpPrefixMatcher matcher(IpPrefix("10.0.0.0/8"));
+    vector<uint8_t> result(ADDRESSES);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(matcher.match(packed.data(), packed.size(), result.data()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ADDRESSES));
+}
+BENCHMARK(BM_IpPrefixMatcherV4)->Unit(benchmark::kMillisecond);
+
+static void BM_IpPrefixMatcherV6(benchmark::State &state)
+{
+    auto addresses = makeAddresses(false);
+    vector<PackedIpV6> packed;
+    for (const auto &addr : addresses)
+        packed.push_back(PackedIpV6::pack(addr));
+
+    IpPrefixMatcher matcher(IpPrefix("2001:db8::/32"));
+    vector<uint8_t> result(ADDRESSES);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(matcher.match(packed.data(), packed.size(), result.data()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ADDRESSES));
+}
+BENCHMARK(BM_IpPrefixMatcherV6)->Unit(benchmark::kMillisecond);
+
+/* Which of 1M prefixes contain one address */
+static void BM_PackedPrefixesFindContaining(benchmark::State &state)
+{
+    bool v4 = state.range(0) == AF_INET;
+    auto addresses = makeAddresses(v4);
+    PackedPrefixes prefixes(v4);
+    mt19937 gen(2);
+
+    for (const auto &addr : addresses)
+        prefixes.add(IpPrefix(addr.getIp(), static_cast<int>(gen() % (v4 ? 25 : 65))));
+
+    vector<uint8_t> result(ADDRESSES);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(prefixes.findContaining(addresses[i], result.data()));
+        i = (i + 1) % ADDRESSES;
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ADDRESSES));
+}
+BENCHMARK(BM_PackedPrefixesFindContaining)->Arg(AF_INET)->Arg(AF_INET6)->Unit(benchmark::kMillisecond);
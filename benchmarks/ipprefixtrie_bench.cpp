@@ -0,0 +1,196 @@
+#include "common/ipprefixtrie.h"
+
+#include "benchmark/benchmark.h"
+
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+const size_t PREFIXES = 1000000;
+
+/* Internet like mix of IPv4 prefix lengths, mostly /24 */
+vector<IpPrefix> makePrefixes(size_t count)
+{
+    mt19937 gen(1);
+    vector<IpPrefix> prefixes;
+    prefixes.reserve(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t r = static_cast<uint32_t>(gen()) % 100;
+        int len = r < 60 ? 24 : r < 75 ? 22 : r < 85 ? 20 : r < 95 ? 16 + static_cast<int>(gen() % 8) : 8 + static_cast<int>(gen() % 8);
+        uint32_t addr = static_cast<uint32_t>(gen()) & static_cast<uint32_t>((0xFFFFFFFFULL << (32 - len)) & 0xFFFFFFFFULL);
+        prefixes.push_back(IpPrefix(htonl(addr), len));
+    }
+
+    return prefixes;
+}
+
+vector<IpAddress> makeAddresses(size_t count)
+{
+    mt19937 gen(2);
+    vector<IpAddress> addresses;
+    addresses.reserve(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        addresses.push_back(IpAddress(htonl(static_cast<uint32_t>(gen()))));
+    }
+
+    return addresses;
+}
+
+const vector<IpPrefix> &prefixes()
+{
+    static vector<IpPrefix> p = makePrefixes(PREFIXES);
+    return p;
+}
+
+const IpPrefixTrie<uint32_t> &trie()
+{
+    static IpPrefixTrie<uint32_t> t;
+    if (t.empty())
+    {
+        uint32_t i = 0;
+        for (const auto &p : prefixes())
+            t.insert(p, i++);
+    }
+    return t;
+}
+
+const map<IpPrefix, uint32_t> &routeMap()
+{
+    static map<IpPrefix, uint32_t> m;
+    if (m.empty())
+    {
+        uint32_t i = 0;
+        for (const auto &p : prefixes())
+            m[p] = i++;
+    }
+    return m;
+}
+
+}
+
+static void BM_IpPrefixTrieInsert(benchmark::State &state)
+{
+    const auto &p = prefixes();
+
+    for (auto _ : state)
+    {
+        IpPrefixTrie<uint32_t> t;
+        uint32_t i = 0;
+        for (const auto &prefix : p)
+            t.insert(prefix, i++);
+        benchmark::DoNotOptimize(t.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(p.size()));
+}
+BENCHMARK(BM_IpPrefixTrieInsert)->Unit(benchmark::kMillisecond);
+
+static void BM_MapInsert(benchmark::State &state)
+{
+    const auto &p = prefixes();
+
+    for (auto _ : state)
+    {
+        map<IpPrefix, uint32_t> m;
+        uint32_t i = 0;
+        for (const auto &prefix : p)
+            m[prefix] = i++;
+        benchmark::DoNotOptimize(m.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(p.size()));
+}
+BENCHMARK(BM_MapInsert)->Unit(benchmark::kMillisecond);
+
+static void BM_IpPrefixTrieLongestMatch(benchmark::State &state)
+{
+    const auto &t = trie();
+    auto addresses = makeAddresses(65536);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(t.longestMatch(addresses[i]));
+        i = (i + 1) & 0xFFFF;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IpPrefixTrieLongestMatch);
+
+/* Exact match of the address masked to each length, from /32 down */
+static void BM_MapLongestMatch(benchmark::State &state)
+{
+    const auto &m = routeMap();
+    auto addresses = makeAddresses(65536);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        const uint32_t *found = nullptr;
+        uint32_t addr = ntohl(addresses[i].getV4Addr());
+        for (int len = 32; len >= 0 && found == nullptr; len--)
+        {
+            uint32_t mask = static_cast<uint32_t>((0xFFFFFFFFULL << (32 - len)) & 0xFFFFFFFFULL);
+            auto it = m.find(IpPrefix(htonl(addr & mask), len));
+            if (it != m.end())
+                found = &it->second;
+        }
+        benchmark::DoNotOptimize(found);
+        i = (i + 1) & 0xFFFF;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MapLongestMatch);
+
+/* Linear scan of all prefixes, as done with isAddressInSubnet */
+static void BM_MapLinearLongestMatch(benchmark::State &state)
+{
+    const auto &m = routeMap();
+    auto addresses = makeAddresses(256);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        const uint32_t *found = nullptr;
+        int bestLen = -1;
+        for (const auto &kv : m)
+        {
+            if (kv.first.getMaskLength() > bestLen && kv.first.isAddressInSubnet(addresses[i]))
+            {
+                found = &kv.second;
+                bestLen = kv.first.getMaskLength();
+            }
+        }
+        benchmark::DoNotOptimize(found);
+        i = (i + 1) & 0xFF;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MapLinearLongestMatch)->Unit(benchmark::kMillisecond);
+
+static void BM_IpPrefixTrieCovered(benchmark::State &state)
+{
+    const auto &t = trie();
+    IpPrefix parent("10.0.0.0/8");
+
+    for (auto _ : state)
+    {
+        size_t count = 0;
+        t.forEachCovered(parent, [&](const IpPrefix &, const uint32_t &) { count++; });
+        benchmark::DoNotOptimize(count);
+    }
+}
+BENCHMARK(BM_IpPrefixTrieCovered);
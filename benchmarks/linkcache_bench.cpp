@@ -0,0 +1,153 @@
+#include "common/linkcache.h"
+
+#include "benchmark/benchmark.h"
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <netlink/route/link.h>
+#include <linux/rtnetlink.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+/* First ifindex used for synthetic links, far from the ones of the host */
+const int BASE_IFINDEX = 10000;
+
+struct nl_msg *buildLinkMsg(int nlmsg_type, int ifindex)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(nlmsg_type, 0);
+
+    struct ifinfomsg ifi = {};
+    ifi.ifi_family = AF_UNSPEC;
+    ifi.ifi_index = ifindex;
+    nlmsg_append(msg, &ifi, sizeof(ifi), NLMSG_ALIGNTO);
+    nla_put_string(msg, IFLA_IFNAME, ("Ethernet0." + to_string(ifindex)).c_str());
+
+    return msg;
+}
+
+}
+
+/*
+ * Lookup of a known ifindex, concurrent readers share the table. The links
+ * are added by every thread with the same names and left in the table.
+ */
+static void BM_LinkCacheLookup(benchmark::State &state)
+{
+    auto &cache = LinkCache::getInstance();
+    const int base = BASE_IFINDEX + 20000;
+    const int links = 4096;
+
+    for (int i = 0; i < links; i++)
+    {
+        cache.updateLink(base + i, "Ethernet1." + to_string(i));
+    }
+
+    int i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(cache.ifindexToName(base + i));
+        i = (i + 1) % links;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LinkCacheLookup)->ThreadRange(1, 4);
+
+/*
+ * Bulk interface creation: each RTM_NEWLINK is followed by a lookup of the
+ * new ifindex, as done by sync daemons. Reports the number of full link
+ * dumps and single link kernel queries per burst.
+ */
+static void BM_LinkCacheBulkCreate(benchmark::State &state)
+{
+    auto &cache = LinkCache::getInstance();
+    const int links = static_cast<int>(state.range(0));
+    vector<struct nl_msg *> newMsgs;
+    vector<struct nl_msg *> delMsgs;
+
+    for (int i = 0; i < links; i++)
+    {
+        newMsgs.push_back(buildLinkMsg(RTM_NEWLINK, BASE_IFINDEX + i));
+        delMsgs.push_back(buildLinkMsg(RTM_DELLINK, BASE_IFINDEX + i));
+    }
+
+    uint64_t refills = cache.getRefillCount();
+    uint64_t lookups = cache.getKernelLookupCount();
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < links; i++)
+        {
+            cache.onMsg(RTM_NEWLINK, nlmsg_hdr(newMsgs[i]));
+            benchmark::DoNotOptimize(cache.ifindexToName(BASE_IFINDEX + i));
+        }
+
+        state.PauseTiming();
+        for (int i = 0; i < links; i++)
+        {
+            cache.onMsg(RTM_DELLINK, nlmsg_hdr(delMsgs[i]));
+        }
+        state.ResumeTiming();
+    }
+
+    double bursts = static_cast<double>(state.iterations());
+    state.counters["refills"] = static_cast<double>(cache.getRefillCount() - refills) / bursts;
+    state.counters["kernelLookups"] = static_cast<double>(cache.getKernelLookupCount() - lookups) / bursts;
+    state.SetItemsProcessed(state.iterations() * links);
+
+    for (int i = 0; i < links; i++)
+    {
+        nlmsg_free(newMsgs[i]);
+        nlmsg_free(delMsgs[i]);
+    }
+}
+BENCHMARK(BM_LinkCacheBulkCreate)->Arg(256)->Arg(4096);
+
+/*
+ * Previous behavior for comparison: every new ifindex misses the libnl
+ * cache and triggers a refill, a dump of all links of the host.
+ */
+static void BM_LinkCacheLegacyBulkCreate(benchmark::State &state)
+{
+    const int links = static_cast<int>(state.range(0));
+    struct nl_sock *sock = nl_socket_alloc();
+    struct nl_cache *linkCache = NULL;
+    char name[IFNAMSIZ];
+    uint64_t refills = 0;
+
+    if (nl_connect(sock, NETLINK_ROUTE) < 0 ||
+        rtnl_link_alloc_cache(sock, AF_UNSPEC, &linkCache) < 0)
+    {
+        state.SkipWithError("Unable to allocate link cache");
+        nl_socket_free(sock);
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < links; i++)
+        {
+            if (rtnl_link_i2name(linkCache, BASE_IFINDEX + i, name, sizeof(name)) == NULL)
+            {
+                nl_cache_refill(sock, linkCache);
+                refills++;
+                benchmark::DoNotOptimize(rtnl_link_i2name(linkCache, BASE_IFINDEX + i, name, sizeof(name)));
+            }
+        }
+    }
+
+    state.counters["refills"] = static_cast<double>(refills) / static_cast<double>(state.iterations());
+    state.SetItemsProcessed(state.iterations() * links);
+
+    nl_cache_free(linkCache);
+    nl_close(sock);
+    nl_socket_free(sock);
+}
+BENCHMARK(BM_LinkCacheLegacyBulkCreate)->Arg(256);
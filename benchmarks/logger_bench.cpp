@@ -0,0 +1,186 @@
+#include "common/logger.h"
+
+#include "benchmark/benchmark.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <string>
+
+using namespace swss;
+
+namespace
+{
+
+/* Send stderr to /dev/null while a benchmark runs */
+class DiscardStderr
+{
+public:
+    DiscardStderr()
+    {
+        fflush(stderr);
+        m_saved = dup(STDERR_FILENO);
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDERR_FILENO);
+        close(null);
+    }
+
+    ~DiscardStderr()
+    {
+        fflush(stderr);
+        dup2(m_saved, STDERR_FILENO);
+        close(m_saved);
+    }
+
+private:
+    int m_saved;
+};
+
+void logMessages(benchmark::State &state, Logger::Output output, bool async, Logger::OverflowPolicy policy)
+{
+    DiscardStderr discard;
+    Logger::setOutput(output);
+
+    if (async)
+        Logger::enableAsync(policy, 4096);
+
+    uint64_t dropped = Logger::getDroppedCount();
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        SWSS_LOG_NOTICE("Set route %s with next hop %s on %s, %d", "10.1.0.0/24", "10.0.0.1", "Ethernet0", i++);
+    }
+
+    state.counters["dropped"] = static_cast<double>(Logger::getDroppedCount() - dropped);
+
+    if (async)
+        Logger::disableAsync();
+
+    Logger::setOutput(Logger::SWSS_SYSLOG);
+}
+
+}
+
+static void BM_LogSyncStderr(benchmark::State &state)
+{
+    logMessages(state, Logger::SWSS_STDERR, false, Logger::SWSS_LOG_DROP);
+}
+BENCHMARK(BM_LogSyncStderr);
+
+static void BM_LogAsyncStderrDrop(benchmark::State &state)
+{
+    logMessages(state, Logger::SWSS_STDERR, true, Logger::SWSS_LOG_DROP);
+}
+BENCHMARK(BM_LogAsyncStderrDrop);
+
+static void BM_LogAsyncStderrBlock(benchmark::State &state)
+{
+    logMessages(state, Logger::SWSS_STDERR, true, Logger::SWSS_LOG_BLOCK);
+}
+BENCHMARK(BM_LogAsyncStderrBlock);
+
+static void BM_LogSyncSyslog(benchmark::State &state)
+{
+    logMessages(state, Logger::SWSS_SYSLOG, false, Logger::SWSS_LOG_DROP);
+}
+BENCHMARK(BM_LogSyncSyslog);
+
+static void BM_LogAsyncSyslogDrop(benchmark::State &state)
+{
+    logMessages(state, Logger::SWSS_SYSLOG, true, Logger::SWSS_LOG_DROP);
+}
+BENCHMARK(BM_LogAsyncSyslogDrop);
+
+/* Cost in the writing thread of a burst which fits in the ring */
+static void logBurst(benchmark::State &state, bool deferFormat)
+{
+    DiscardStderr discard;
+    Logger::setOutput(Logger::SWSS_STDERR);
+    Logger::enableAsync(Logger::SWSS_LOG_DROP, 4096, deferFormat);
+
+    uint64_t dropped = Logger::getDroppedCount();
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 1000; i++)
+            SWSS_LOG_NOTICE("Set route %s with next hop %s on %s, %d", "10.1.0.0/24", "10.0.0.1", "Ethernet0", i);
+
+        state.PauseTiming();
+        Logger::flush();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1000);
+    state.counters["dropped"] = static_cast<double>(Logger::getDroppedCount() - dropped);
+
+    Logger::disableAsync();
+    Logger::setOutput(Logger::SWSS_SYSLOG);
+}
+
+static void BM_LogAsyncBurst(benchmark::State &state)
+{
+    logBurst(state, false);
+}
+BENCHMARK(BM_LogAsyncBurst);
+
+static void BM_LogAsyncBurstDeferred(benchmark::State &state)
+{
+    logBurst(state, true);
+}
+BENCHMARK(BM_LogAsyncBurstDeferred);
+
+static void BM_LogSyncBurst(benchmark::State &state)
+{
+    DiscardStderr discard;
+    Logger::setOutput(Logger::SWSS_STDERR);
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 1000; i++)
+            SWSS_LOG_NOTICE("Set route %s with next hop %s on %s, %d", "10.1.0.0/24", "10.0.0.1", "Ethernet0", i);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1000);
+    Logger::setOutput(Logger::SWSS_SYSLOG);
+}
+BENCHMARK(BM_LogSyncBurst);
+
+static std::string describeRoute(int i)
+{
+    return "10.1." + std::to_string(i & 0xff) + ".0/24 via 10.0.0.1";
+}
+
+/* Disabled level: the check only, describeRoute is not called */
+static void BM_LogDisabledDebug(benchmark::State &state)
+{
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        SWSS_LOG_DEBUG("Set route %s", describeRoute(i++).c_str());
+    }
+
+    benchmark::DoNotOptimize(i);
+}
+BENCHMARK(BM_LogDisabledDebug);
+
+static __attribute__((noinline)) int enterFunction(int i)
+{
+    SWSS_LOG_ENTER();
+
+    return i + 1;
+}
+
+static void BM_LogDisabledEnter(benchmark::State &state)
+{
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        i = enterFunction(i);
+    }
+
+    benchmark::DoNotOptimize(i);
+}
+BENCHMARK(BM_LogDisabledEnter);
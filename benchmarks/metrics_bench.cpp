@@ -0,0 +1,67 @@
+#include "common/metrics.h"
+
+#include "benchmark/benchmark.h"
+
+using namespace swss;
+
+static Counter &benchCounter()
+{
+    return MetricsRegistry::getInstance().counter("BENCH", "counter");
+}
+
+static void BM_MetricsCounter(benchmark::State &state)
+{
+    Counter &counter = benchCounter();
+
+    for (auto _ : state)
+    {
+        counter.add();
+    }
+
+    benchmark::DoNotOptimize(counter.value());
+}
+BENCHMARK(BM_MetricsCounter)->Threads(1)->Threads(4);
+
+static void BM_MetricsHistogram(benchmark::State &state)
+{
+    Histogram &histogram = MetricsRegistry::getInstance().histogram("BENCH", "histogram");
+    uint64_t value = 0;
+
+    for (auto _ : state)
+    {
+        histogram.record(value);
+        value = (value + 7919) & 0xfffff;
+    }
+}
+BENCHMARK(BM_MetricsHistogram);
+
+/* What a table operation pays while the metrics are disabled */
+static void BM_MetricsDisabled(benchmark::State &state)
+{
+    Counter &counter = benchCounter();
+    MetricsRegistry::setEnabled(false);
+
+    for (auto _ : state)
+    {
+        if (MetricsRegistry::isEnabled())
+            counter.add();
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_MetricsDisabled);
+
+static void BM_MetricsCollect(benchmark::State &state)
+{
+    auto &registry = MetricsRegistry::getInstance();
+    for (int i = 0; i < 50; i++)
+    {
+        registry.counter("BENCH_TABLE_" + std::to_string(i), "set").add();
+        registry.histogram("BENCH_TABLE_" + std::to_string(i), "pops_batch").record(static_cast<uint64_t>(i));
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(registry.collect());
+    }
+}
+BENCHMARK(BM_MetricsCollect);
@@ -0,0 +1,247 @@
+#include "common/netlink.h"
+#include "common/netdispatcher.h"
+#include "common/netmsg.h"
+#include "common/netmsgview.h"
+
+#include "benchmark/benchmark.h"
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+class CountingHandler : public NetMsg
+{
+public:
+    void onMsg(int nlmsg_type, struct nl_object *obj) override
+    {
+        m_count++;
+    }
+
+    uint64_t m_count = 0;
+};
+
+/* Reads the attributes a link sync daemon typically needs */
+class LinkViewHandler : public RawNetMsg
+{
+public:
+    void onMsg(int nlmsg_type, const struct nlmsghdr *hdr) override
+    {
+        LinkMsgView view(hdr);
+        uint32_t mtu;
+
+        if (view.isValid() && view.getName() != nullptr && view.getMtu(mtu))
+            m_count++;
+    }
+
+    uint64_t m_count = 0;
+};
+
+struct nl_msg *buildLinkMsg(int nlmsg_type, uint16_t flags = 0)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(nlmsg_type, flags);
+    nlmsg_set_proto(msg, NETLINK_ROUTE);
+
+    struct ifinfomsg ifi = {};
+    ifi.ifi_family = AF_UNSPEC;
+    ifi.ifi_index = 42;
+    ifi.ifi_flags = IFF_UP;
+
+    nlmsg_append(msg, &ifi, sizeof(ifi), NLMSG_ALIGNTO);
+    nla_put_string(msg, IFLA_IFNAME, "Ethernet42");
+    nla_put_u32(msg, IFLA_MTU, 9100);
+
+    return msg;
+}
+
+/* Sends datagrams of netlink messages from a userspace socket to a NetLink instance */
+class NetlinkInjector
+{
+public:
+    NetlinkInjector(NetLink &netlink, int msgsPerDatagram)
+    {
+        m_fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+        if (m_fd < 0)
+            throw runtime_error("Unable to open injector netlink socket");
+
+        socklen_t len = sizeof(m_dst);
+        if (getsockname(netlink.getFd(), (struct sockaddr *)&m_dst, &len) < 0)
+            throw runtime_error("Unable to resolve netlink port id");
+
+        struct nl_msg *msg = buildLinkMsg(RTM_NEWLINK);
+        struct nlmsghdr *hdr = nlmsg_hdr(msg);
+        size_t msgLen = NLMSG_ALIGN(hdr->nlmsg_len);
+        for (int i = 0; i < msgsPerDatagram; i++)
+        {
+            const char *raw = reinterpret_cast<const char *>(hdr);
+            m_datagram.insert(m_datagram.end(), raw, raw + msgLen);
+        }
+        nlmsg_free(msg);
+    }
+
+    ~NetlinkInjector()
+    {
+        close(m_fd);
+    }
+
+    void send()
+    {
+        if (sendto(m_fd, m_datagram.data(), m_datagram.size(), 0,
+                   (struct sockaddr *)&m_dst, sizeof(m_dst)) < 0)
+            throw runtime_error("Unable to send netlink datagram");
+    }
+
+private:
+    int m_fd;
+    struct sockaddr_nl m_dst;
+    vector<char> m_datagram;
+};
+
+}
+
+/* Raw dispatch cost of a message no handler is registered for */
+static void BM_NetDispatcherUnregistered(benchmark::State &state)
+{
+    struct nl_msg *msg = buildLinkMsg(RTM_DELADDR);
+
+    for (auto _ : state)
+    {
+        NetDispatcher::getInstance().onNetlinkMessage(msg);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    nlmsg_free(msg);
+}
+BENCHMARK(BM_NetDispatcherUnregistered)->ThreadRange(1, 4);
+
+/* Dispatch and libnl parsing of a registered message */
+static void BM_NetDispatcherRegistered(benchmark::State &state)
+{
+    CountingHandler handler;
+    struct nl_msg *msg = buildLinkMsg(RTM_NEWLINK);
+    NetDispatcher::getInstance().registerMessageHandler(RTM_NEWLINK, &handler);
+
+    for (auto _ : state)
+    {
+        NetDispatcher::getInstance().onNetlinkMessage(msg);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(handler.m_count));
+    NetDispatcher::getInstance().unregisterMessageHandler(RTM_NEWLINK);
+    nlmsg_free(msg);
+}
+BENCHMARK(BM_NetDispatcherRegistered);
+
+/* Dispatch of a registered message to a raw handler reading it through LinkMsgView */
+static void BM_NetDispatcherRawRegistered(benchmark::State &state)
+{
+    LinkViewHandler handler;
+    struct nl_msg *msg = buildLinkMsg(RTM_NEWLINK);
+    NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &handler);
+
+    for (auto _ : state)
+    {
+        NetDispatcher::getInstance().onNetlinkMessage(msg);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(handler.m_count));
+    NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWLINK);
+    nlmsg_free(msg);
+}
+BENCHMARK(BM_NetDispatcherRawRegistered);
+
+/* End to end messages per second through NetLink::readData, argument is messages per datagram */
+static void BM_NetLinkReadData(benchmark::State &state)
+{
+    const int datagrams = 64;
+    CountingHandler handler;
+    NetLink netlink;
+    NetlinkInjector injector(netlink, static_cast<int>(state.range(0)));
+    NetDispatcher::getInstance().registerMessageHandler(RTM_NEWLINK, &handler);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (int i = 0; i < datagrams; i++)
+        {
+            injector.send();
+        }
+        state.ResumeTiming();
+
+        for (int i = 0; i < datagrams; i++)
+        {
+            netlink.readData();
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(handler.m_count));
+    NetDispatcher::getInstance().unregisterMessageHandler(RTM_NEWLINK);
+}
+BENCHMARK(BM_NetLinkReadData)->Arg(1)->Arg(16)->Arg(64);
+
+/* Same as BM_NetLinkReadData with a raw handler instead of libnl objects */
+static void BM_NetLinkReadDataRaw(benchmark::State &state)
+{
+    const int datagrams = 64;
+    LinkViewHandler handler;
+    NetLink netlink;
+    NetlinkInjector injector(netlink, static_cast<int>(state.range(0)));
+    NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &handler);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (int i = 0; i < datagrams; i++)
+        {
+            injector.send();
+        }
+        state.ResumeTiming();
+
+        for (int i = 0; i < datagrams; i++)
+        {
+            netlink.readData();
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(handler.m_count));
+    NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWLINK);
+}
+BENCHMARK(BM_NetLinkReadDataRaw)->Arg(1)->Arg(16)->Arg(64);
+
+/* Raw handler with recvmmsg batched receive, arguments are messages per datagram and batch size */
+static void BM_NetLinkReadDataBatched(benchmark::State &state)
+{
+    const int datagrams = 64;
+    LinkViewHandler handler;
+    NetLink netlink;
+    netlink.setBatchedRecv(static_cast<unsigned int>(state.range(1)));
+    NetlinkInjector injector(netlink, static_cast<int>(state.range(0)));
+    NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &handler);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (int i = 0; i < datagrams; i++)
+        {
+            injector.send();
+        }
+        state.ResumeTiming();
+
+        netlink.readData();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(handler.m_count));
+    NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWLINK);
+}
+BENCHMARK(BM_NetLinkReadDataBatched)->Args({1, 8})->Args({1, 64})->Args({16, 64})->Args({64, 64});
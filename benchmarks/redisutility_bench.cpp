@@ -0,0 +1,139 @@
+#include "common/redisutility.h"
+
+#include "allocations.h"
+#include "benchmark/benchmark.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+/* PORT table entry, as handled by portsorch */
+vector<FieldValueTuple> portEntry()
+{
+    return {
+        { "admin_status", "up" }, { "alias", "etp1" }, { "autoneg", "off" },
+        { "description", "ARISTA01T2:Ethernet1" }, { "fec", "rs" }, { "index", "1" },
+        { "lanes", "0,1,2,3,4,5,6,7" }, { "mtu", "9100" }, { "pfc_asym", "off" },
+        { "speed", "400000" }, { "tpid", "0x8100" }, { "role", "Ext" },
+    };
+}
+
+constexpr FieldKey ADMIN_STATUS("admin_status");
+constexpr FieldKey SPEED("speed");
+constexpr FieldKey MTU("mtu");
+constexpr FieldKey FEC("fec");
+constexpr FieldKey TPID("tpid");
+constexpr FieldKey ROLE("role");
+
+const vector<string> WANTED = { "admin_status", "speed", "mtu", "fec", "tpid", "role" };
+
+}
+
+static void BM_FvsGetValue(benchmark::State &state)
+{
+    auto fvt = portEntry();
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        for (const auto &field : WANTED)
+            benchmark::DoNotOptimize(fvsGetValue(fvt, field));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_FvsGetValue);
+
+static void BM_FvsGetValueCaseInsensitive(benchmark::State &state)
+{
+    auto fvt = portEntry();
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        for (const auto &field : WANTED)
+            benchmark::DoNotOptimize(fvsGetValue(fvt, field, true));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_FvsGetValueCaseInsensitive);
+
+/* Index built for each entry, then one lookup per wanted field */
+static void BM_FieldValueIndex(benchmark::State &state)
+{
+    auto fvt = portEntry();
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        FieldValueIndex index(fvt);
+        for (const auto &field : { ADMIN_STATUS, SPEED, MTU, FEC, TPID, ROLE })
+            benchmark::DoNotOptimize(index.find(field));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_FieldValueIndex);
+
+static void BM_FieldValueIndexCaseInsensitive(benchmark::State &state)
+{
+    auto fvt = portEntry();
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        FieldValueIndex index(fvt, true);
+        for (const auto &field : { ADMIN_STATUS, SPEED, MTU, FEC, TPID, ROLE })
+            benchmark::DoNotOptimize(index.find(field));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_FieldValueIndexCaseInsensitive);
+
+/* Every field of larger entries looked up, e.g. ACL rules or flex counters */
+static vector<FieldValueTuple> wideEntry(size_t fields)
+{
+    vector<FieldValueTuple> fvt;
+    for (size_t i = 0; i < fields; i++)
+        fvt.emplace_back("SAI_ATTR_" + to_string(i), to_string(i));
+
+    return fvt;
+}
+
+static void BM_FvsGetValueAll(benchmark::State &state)
+{
+    auto fvt = wideEntry(static_cast<size_t>(state.range(0)));
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        for (const auto &fv : fvt)
+            benchmark::DoNotOptimize(fvsGetValue(fvt, fvField(fv)));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_FvsGetValueAll)->Arg(12)->Arg(32)->Arg(128);
+
+static void BM_FieldValueIndexAll(benchmark::State &state)
+{
+    auto fvt = wideEntry(static_cast<size_t>(state.range(0)));
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        FieldValueIndex index(fvt);
+        for (const auto &fv : fvt)
+            benchmark::DoNotOptimize(index.find(fvField(fv)));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_FieldValueIndexAll)->Arg(12)->Arg(32)->Arg(128);
@@ -0,0 +1,164 @@
+#include "common/routetablesync.h"
+#include "common/netmsgview.h"
+#include "common/redispipeline.h"
+
+#include "benchmark/benchmark.h"
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <arpa/inet.h>
+#include <linux/rtnetlink.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+const char *BENCH_TABLE = "BENCH_ROUTE_TABLE";
+
+/* Database layout of the unit tests, run the benchmarks from the top directory */
+const char *DB_CONFIG_FILE = "./tests/redis_multi_db_ut_config/database_config.json";
+
+struct nl_msg *buildRouteMsg(uint32_t index)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(RTM_NEWROUTE, 0);
+
+    struct rtmsg rtm = {};
+    rtm.rtm_family = AF_INET;
+    rtm.rtm_dst_len = 32;
+    rtm.rtm_table = RT_TABLE_MAIN;
+    rtm.rtm_type = RTN_UNICAST;
+    nlmsg_append(msg, &rtm, sizeof(rtm), NLMSG_ALIGNTO);
+
+    uint32_t dst = htonl(0x0a000000 | index);
+    uint32_t gw = inet_addr("192.168.0.1");
+    nla_put(msg, RTA_DST, sizeof(dst), &dst);
+    nla_put(msg, RTA_GATEWAY, sizeof(gw), &gw);
+    nla_put_u32(msg, RTA_OIF, 1 + index % 32);
+
+    return msg;
+}
+
+string ifname(int ifindex)
+{
+    return "Ethernet" + to_string(ifindex);
+}
+
+unique_ptr<DBConnector> connect(benchmark::State &state)
+{
+    try
+    {
+        if (!SonicDBConfig::isInit())
+            SonicDBConfig::initialize(DB_CONFIG_FILE);
+
+        unique_ptr<DBConnector> db(new DBConnector("APPL_DB", 0, true));
+        RedisReply r(db.get(), "FLUSHDB", REDIS_REPLY_STATUS);
+        return db;
+    }
+    catch (const exception &e)
+    {
+        state.SkipWithError(e.what());
+        return nullptr;
+    }
+}
+
+}
+
+/*
+ * Route dump written through RouteTableSync, reports routes per second from
+ * the netlink messages to the keys accepted by redis.
+ */
+static void BM_RouteTableSyncDump(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    const uint32_t routes = static_cast<uint32_t>(state.range(0));
+    vector<struct nl_msg *> msgs;
+    for (uint32_t i = 0; i < routes; i++)
+    {
+        msgs.push_back(buildRouteMsg(i));
+    }
+
+    RedisPipeline pipeline(db.get());
+    ProducerStateTable table(&pipeline, BENCH_TABLE, true);
+
+    for (auto _ : state)
+    {
+        RouteTableSync sync(table);
+        sync.setIfNameResolver(ifname);
+
+        for (auto msg : msgs)
+        {
+            struct nlmsghdr *hdr = nlmsg_hdr(msg);
+            sync.onMsg(hdr->nlmsg_type, hdr);
+        }
+        sync.flush();
+
+        state.counters["batches"] = static_cast<double>(sync.getBatchCount());
+    }
+
+    state.SetItemsProcessed(state.iterations() * routes);
+
+    for (auto msg : msgs)
+    {
+        nlmsg_free(msg);
+    }
+}
+BENCHMARK(BM_RouteTableSyncDump)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/*
+ * Same routes written with one ProducerStateTable::set per route, as done
+ * before the batched path.
+ */
+static void BM_RouteTableLegacySet(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    const uint32_t routes = static_cast<uint32_t>(state.range(0));
+    vector<struct nl_msg *> msgs;
+    for (uint32_t i = 0; i < routes; i++)
+    {
+        msgs.push_back(buildRouteMsg(i));
+    }
+
+    RedisPipeline pipeline(db.get());
+    ProducerStateTable table(&pipeline, BENCH_TABLE, true);
+
+    for (auto _ : state)
+    {
+        for (auto msg : msgs)
+        {
+            RouteMsgView view(nlmsg_hdr(msg));
+            IpPrefix prefix;
+            IpAddress gateway;
+            uint32_t oif = 0;
+
+            view.getDst(prefix);
+            view.getGateway(gateway);
+            view.getOif(oif);
+
+            vector<FieldValueTuple> fvs;
+            fvs.emplace_back("nexthop", gateway.to_string());
+            fvs.emplace_back("ifname", ifname(static_cast<int>(oif)));
+            table.set(prefix.to_string(), fvs);
+        }
+        table.flush();
+    }
+
+    state.SetItemsProcessed(state.iterations() * routes);
+
+    for (auto msg : msgs)
+    {
+        nlmsg_free(msg);
+    }
+}
+BENCHMARK(BM_RouteTableLegacySet)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,144 @@
+#include "common/stringutility.h"
+#include "common/timestamp.h"
+#include "common/json.h"
+
+#include "allocations.h"
+#include "benchmark/benchmark.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+/* Values of a NotificationProducer message, as sent for a port state change */
+vector<FieldValueTuple> notificationValues(size_t fields)
+{
+    vector<FieldValueTuple> values;
+    for (size_t i = 0; i < fields; i++)
+    {
+        values.emplace_back("SAI_PORT_ATTR_" + to_string(i),
+                            "[{\"port_id\":\"oid:0x1000000000" + to_string(i) + "\",\"port_state\":\"SAI_PORT_OPER_STATUS_UP\"}]");
+    }
+    return values;
+}
+
+}
+
+static void BM_Join(benchmark::State &state)
+{
+    string table("VLAN_MEMBER");
+    string vlan("Vlan100");
+    string port("Ethernet4");
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(join('|', table, vlan, port));
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Join);
+
+/* A mixed number and string key, through the ostringstream of join() */
+static void BM_JoinNumber(benchmark::State &state)
+{
+    string table("BUFFER_QUEUE");
+    string port("Ethernet4");
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(join(':', table, port, 3));
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_JoinNumber);
+
+static void BM_HexToBinary(benchmark::State &state)
+{
+    /* An IPv6 address as a hex string */
+    string hex("fc00000000000000000000000000002a");
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        uint8_t buffer[16];
+        benchmark::DoNotOptimize(hex_to_binary(hex, buffer, sizeof(buffer)));
+        benchmark::DoNotOptimize(buffer);
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HexToBinary);
+
+/* Invalid input, reported through a boost exception */
+static void BM_HexToBinaryInvalid(benchmark::State &state)
+{
+    string hex("fc00000000000000000000000000002z");
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        uint8_t buffer[16];
+        benchmark::DoNotOptimize(hex_to_binary(hex, buffer, sizeof(buffer)));
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HexToBinaryInvalid);
+
+static void BM_GetTimestamp(benchmark::State &state)
+{
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(getTimestamp());
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetTimestamp);
+
+static void BM_JsonBuild(benchmark::State &state)
+{
+    auto values = notificationValues(static_cast<size_t>(state.range(0)));
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(JSon::buildJson(values));
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_JsonBuild)->Arg(1)->Arg(8);
+
+static void BM_JsonRead(benchmark::State &state)
+{
+    string json = JSon::buildJson(notificationValues(static_cast<size_t>(state.range(0))));
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        vector<FieldValueTuple> values;
+        JSon::readJson(json, values);
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    allocations.report(state, state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_JsonRead)->Arg(1)->Arg(8);
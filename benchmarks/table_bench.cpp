@@ -0,0 +1,540 @@
+#include "common/dbconnector.h"
+#include "common/redisreply.h"
+#include "common/table.h"
+#include "common/redispipeline.h"
+#include "common/producerstatetable.h"
+#include "common/consumerstatetable.h"
+#include "common/producertable.h"
+#include "common/consumertable.h"
+#include "common/subscriberstatetable.h"
+#include "common/notificationproducer.h"
+#include "common/notificationconsumer.h"
+#include "common/select.h"
+#include "common/metrics.h"
+
+#include "allocations.h"
+#include "benchmark/benchmark.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+/*
+ * Table layer against the local redis-server of the unit tests, run the
+ * benchmarks from the top directory. Besides the items per second, each
+ * benchmark reports:
+ * - p50_ns, p99_ns: latency of its operation, averaged over the threads
+ * - allocs: operator new calls per item
+ * - redis_cpu_ns: CPU time of the redis server per item
+ * Use --benchmark_format=json or --benchmark_out for the machine readable
+ * output.
+ */
+
+namespace
+{
+
+const char *BENCH_TABLE = "BENCH_TABLE";
+
+/* Database layout of the unit tests, run the benchmarks from the top directory */
+const char *DB_CONFIG_FILE = "./tests/redis_multi_db_ut_config/database_config.json";
+
+const int SELECT_TIMEOUT = 1000;
+
+unique_ptr<DBConnector> connect(benchmark::State &state)
+{
+    static mutex configMutex;
+
+    try
+    {
+        {
+            lock_guard<mutex> lock(configMutex);
+            if (!SonicDBConfig::isInit())
+                SonicDBConfig::initialize(DB_CONFIG_FILE);
+        }
+
+        unique_ptr<DBConnector> db(new DBConnector("APPL_DB", 0, true));
+
+        /* The other threads wait for the first one at the start of the loop */
+        if (state.thread_index() == 0)
+            RedisReply r(db.get(), "FLUSHDB", REDIS_REPLY_STATUS);
+
+        return db;
+    }
+    catch (const exception &e)
+    {
+        state.SkipWithError(e.what());
+        return nullptr;
+    }
+}
+
+/* used_cpu_sys + used_cpu_user of the redis server, in us */
+uint64_t redisCpu(DBConnector *db)
+{
+    RedisReply r(db, "INFO cpu", REDIS_REPLY_STRING);
+    istringstream info(r.getReply<string>());
+    string line;
+    double seconds = 0;
+
+    while (getline(info, line))
+    {
+        if (line.compare(0, 13, "used_cpu_sys:") == 0)
+            seconds += stod(line.substr(13));
+        else if (line.compare(0, 14, "used_cpu_user:") == 0)
+            seconds += stod(line.substr(14));
+    }
+
+    return static_cast<uint64_t>(seconds * 1000000);
+}
+
+/* Route like keys, distinct per thread */
+vector<string> makeKeys(int64_t count, int thread)
+{
+    vector<string> keys;
+    for (int64_t i = 0; i < count; i++)
+    {
+        keys.push_back("10." + to_string(thread) + "." + to_string(i / 256 % 256) + "." + to_string(i % 256) +
+                       "/" + to_string(32 - i / 65536));
+    }
+    return keys;
+}
+
+vector<FieldValueTuple> makeValues(int64_t fields)
+{
+    vector<FieldValueTuple> values;
+    for (int64_t i = 0; i < fields; i++)
+        values.emplace_back("field" + to_string(i), "10.0.0." + to_string(i) + "@Ethernet" + to_string(i * 4));
+    return values;
+}
+
+/*
+ * Measures a benchmark thread from its construction, just before the loop:
+ * latency of the recorded operations, allocations and, from the first
+ * thread, the CPU time of the redis server.
+ */
+class TableBenchStats
+{
+public:
+    TableBenchStats(benchmark::State &state, DBConnector *db)
+        : m_state(state)
+        , m_db(db)
+        , m_cpu(state.thread_index() == 0 ? redisCpu(db) : 0)
+    {
+    }
+
+    static inline uint64_t now()
+    {
+        return MetricsRegistry::now();
+    }
+
+    inline void record(uint64_t start)
+    {
+        m_latency.record(now() - start);
+    }
+
+    /* Items processed by the thread, every thread processes as many */
+    void report(int64_t items)
+    {
+        m_allocations.report(m_state, items);
+        m_state.SetItemsProcessed(items);
+
+        HistogramSnapshot latency = m_latency.snapshot();
+        m_state.counters["p50_ns"] = benchmark::Counter(static_cast<double>(latency.percentile(50)),
+                                                        benchmark::Counter::kAvgThreads);
+        m_state.counters["p99_ns"] = benchmark::Counter(static_cast<double>(latency.percentile(99)),
+                                                        benchmark::Counter::kAvgThreads);
+
+        /* Counters are summed over the threads */
+        if (m_state.thread_index() == 0 && items > 0)
+        {
+            double cpu = static_cast<double>(redisCpu(m_db) - m_cpu) * 1000.0;
+            m_state.counters["redis_cpu_ns"] = cpu / static_cast<double>(items * m_state.threads());
+        }
+    }
+
+private:
+    benchmark::State &m_state;
+    DBConnector *m_db;
+    uint64_t m_cpu;
+    Histogram m_latency;
+
+    /* Last, not to count the allocations of the other members */
+    AllocationCounter m_allocations;
+};
+
+/* Selects and pops until count entries were popped */
+template <typename Consumer>
+bool popAll(Select &s, Consumer &consumer, TableBenchStats &stats, int64_t count)
+{
+    deque<KeyOpFieldsValuesTuple> kcos;
+    Selectable *sel;
+
+    while (count > 0)
+    {
+        if (s.select(&sel, SELECT_TIMEOUT) != Select::OBJECT)
+            return false;
+
+        uint64_t start = stats.now();
+        consumer.pops(kcos);
+        stats.record(start);
+        count -= static_cast<int64_t>(kcos.size());
+    }
+
+    return true;
+}
+
+}
+
+/*
+ * ProducerStateTable::set() of keys written again and again, unbuffered or
+ * through a buffered pipeline flushed every batch commands, by each thread.
+ */
+static void BM_ProducerStateTableSet(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    int64_t batch = state.range(2);
+    RedisPipeline pipeline(db.get(), batch > 0 ? static_cast<size_t>(batch) : 1);
+    ProducerStateTable p(&pipeline, BENCH_TABLE, batch > 0);
+    auto keys = makeKeys(state.range(0), state.thread_index());
+    auto values = makeValues(state.range(1));
+
+    TableBenchStats stats(state, db.get());
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        uint64_t start = stats.now();
+        p.set(keys[i], values);
+        stats.record(start);
+
+        if (++i == keys.size())
+            i = 0;
+    }
+
+    p.flush();
+    stats.report(state.iterations());
+}
+BENCHMARK(BM_ProducerStateTableSet)
+    ->ArgNames({"keys", "fields", "batch"})
+    ->ArgsProduct({{1000, 50000}, {2, 16}, {0, 128}})
+    ->Threads(1)->Threads(4)
+    ->UseRealTime();
+
+/* ProducerStateTable::set() of batch keys at once */
+static void BM_ProducerStateTableBatchedSet(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    ProducerStateTable p(db.get(), BENCH_TABLE);
+    auto keys = makeKeys(state.range(0), state.thread_index());
+    auto values = makeValues(state.range(1));
+
+    vector<KeyOpFieldsValuesTuple> kfvs;
+    for (const auto &key : keys)
+        kfvs.emplace_back(key, SET_COMMAND, values);
+
+    TableBenchStats stats(state, db.get());
+
+    for (auto _ : state)
+    {
+        uint64_t start = stats.now();
+        p.set(kfvs);
+        stats.record(start);
+    }
+
+    stats.report(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ProducerStateTableBatchedSet)
+    ->ArgNames({"batch", "fields"})
+    ->ArgsProduct({{16, 256}, {2, 16}})
+    ->UseRealTime();
+
+/* ProducerTable::set(), the queue is emptied before each run only */
+static void BM_ProducerTableSet(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    int64_t batch = state.range(1);
+    RedisPipeline pipeline(db.get(), batch > 0 ? static_cast<size_t>(batch) : 1);
+    ProducerTable p(&pipeline, BENCH_TABLE, batch > 0);
+    auto keys = makeKeys(1000, state.thread_index());
+    auto values = makeValues(state.range(0));
+
+    TableBenchStats stats(state, db.get());
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        uint64_t start = stats.now();
+        p.set(keys[i], values);
+        stats.record(start);
+
+        if (++i == keys.size())
+            i = 0;
+    }
+
+    p.flush();
+    stats.report(state.iterations());
+}
+BENCHMARK(BM_ProducerTableSet)
+    ->ArgNames({"fields", "batch"})
+    ->ArgsProduct({{2, 16}, {0, 128}})
+    ->Threads(1)->Threads(4)
+    ->UseRealTime();
+
+static void BM_TableSet(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    int64_t batch = state.range(2);
+    RedisPipeline pipeline(db.get(), batch > 0 ? static_cast<size_t>(batch) : 1);
+    Table table(&pipeline, BENCH_TABLE, batch > 0);
+    auto keys = makeKeys(state.range(0), state.thread_index());
+    auto values = makeValues(state.range(1));
+
+    TableBenchStats stats(state, db.get());
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        uint64_t start = stats.now();
+        table.set(keys[i], values);
+        stats.record(start);
+
+        if (++i == keys.size())
+            i = 0;
+    }
+
+    table.flush();
+    stats.report(state.iterations());
+}
+BENCHMARK(BM_TableSet)
+    ->ArgNames({"keys", "fields", "batch"})
+    ->ArgsProduct({{1000, 50000}, {2, 16}, {0, 128}})
+    ->UseRealTime();
+
+static void BM_TableGet(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    Table table(db.get(), BENCH_TABLE);
+    auto keys = makeKeys(state.range(0), state.thread_index());
+    auto values = makeValues(state.range(1));
+    for (const auto &key : keys)
+        table.set(key, values);
+
+    TableBenchStats stats(state, db.get());
+    vector<FieldValueTuple> read;
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        uint64_t start = stats.now();
+        table.get(keys[i], read);
+        stats.record(start);
+
+        if (++i == keys.size())
+            i = 0;
+    }
+
+    stats.report(state.iterations());
+}
+BENCHMARK(BM_TableGet)
+    ->ArgNames({"keys", "fields"})
+    ->ArgsProduct({{1000}, {2, 16}})
+    ->Threads(1)->Threads(4)
+    ->UseRealTime();
+
+/*
+ * Select and ConsumerStateTable::pops() of keys written by a buffered
+ * ProducerStateTable, outside of the timing. Latency is per pops(), the
+ * redis CPU time includes the writes.
+ */
+static void BM_ConsumerStateTablePops(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    RedisPipeline pipeline(db.get());
+    ProducerStateTable p(&pipeline, BENCH_TABLE, true);
+    ConsumerStateTable c(db.get(), BENCH_TABLE, static_cast<int>(state.range(2)));
+    Select s;
+    s.addSelectable(&c);
+
+    auto keys = makeKeys(state.range(0), 0);
+    auto values = makeValues(state.range(1));
+
+    TableBenchStats stats(state, db.get());
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (const auto &key : keys)
+            p.set(key, values);
+        p.flush();
+        state.ResumeTiming();
+
+        if (!popAll(s, c, stats, state.range(0)))
+        {
+            state.SkipWithError("Missing entries");
+            break;
+        }
+    }
+
+    stats.report(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConsumerStateTablePops)
+    ->ArgNames({"keys", "fields", "pop_batch"})
+    ->ArgsProduct({{1000, 10000}, {2, 16}, {128, 8192}})
+    ->UseRealTime();
+
+/* Select and ConsumerTable::pops() of the operations of a buffered ProducerTable, as above */
+static void BM_ConsumerTablePops(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    RedisPipeline pipeline(db.get());
+    ProducerTable p(&pipeline, BENCH_TABLE, true);
+    ConsumerTable c(db.get(), BENCH_TABLE, static_cast<int>(state.range(2)));
+    Select s;
+    s.addSelectable(&c);
+
+    auto keys = makeKeys(state.range(0), 0);
+    auto values = makeValues(state.range(1));
+
+    TableBenchStats stats(state, db.get());
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (const auto &key : keys)
+            p.set(key, values);
+        p.flush();
+        state.ResumeTiming();
+
+        if (!popAll(s, c, stats, state.range(0)))
+        {
+            state.SkipWithError("Missing entries");
+            break;
+        }
+    }
+
+    stats.report(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConsumerTablePops)
+    ->ArgNames({"keys", "fields", "pop_batch"})
+    ->ArgsProduct({{1000, 10000}, {2, 16}, {128, 8192}})
+    ->UseRealTime();
+
+/* Table::set() to its keyspace notification popped by SubscriberStateTable */
+static void BM_SubscriberStateTable(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    db->config_set("notify-keyspace-events", "AKE");
+
+    Table table(db.get(), BENCH_TABLE);
+    SubscriberStateTable c(db.get(), BENCH_TABLE);
+    Select s;
+    s.addSelectable(&c);
+
+    auto keys = makeKeys(1000, 0);
+    auto values = makeValues(state.range(0));
+
+    TableBenchStats stats(state, db.get());
+    deque<KeyOpFieldsValuesTuple> kcos;
+    Selectable *sel;
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        uint64_t start = stats.now();
+        table.set(keys[i], values);
+
+        /* One event per field */
+        size_t popped = 0;
+        while (popped == 0)
+        {
+            if (s.select(&sel, SELECT_TIMEOUT) != Select::OBJECT)
+            {
+                state.SkipWithError("Missing event");
+                break;
+            }
+
+            c.pops(kcos);
+            popped = kcos.size();
+        }
+        stats.record(start);
+
+        if (++i == keys.size())
+            i = 0;
+    }
+
+    stats.report(state.iterations());
+}
+BENCHMARK(BM_SubscriberStateTable)
+    ->ArgNames({"fields"})
+    ->Arg(2)->Arg(16)
+    ->UseRealTime();
+
+/* NotificationProducer::send() to NotificationConsumer::pop() */
+static void BM_NotificationConsumer(benchmark::State &state)
+{
+    auto db = connect(state);
+    if (!db)
+        return;
+
+    NotificationConsumer c(db.get(), BENCH_TABLE);
+    NotificationProducer p(db.get(), BENCH_TABLE);
+    Select s;
+    s.addSelectable(&c);
+
+    auto values = makeValues(state.range(0));
+
+    TableBenchStats stats(state, db.get());
+    string op, data;
+    vector<FieldValueTuple> read;
+    Selectable *sel;
+
+    for (auto _ : state)
+    {
+        uint64_t start = stats.now();
+        p.send("SET", "oid:0x1000000000001", values);
+
+        if (s.select(&sel, SELECT_TIMEOUT) != Select::OBJECT)
+        {
+            state.SkipWithError("Missing notification");
+            break;
+        }
+
+        c.pop(op, data, read);
+        stats.record(start);
+    }
+
+    stats.report(state.iterations());
+}
+BENCHMARK(BM_NotificationConsumer)
+    ->ArgNames({"fields"})
+    ->Arg(2)->Arg(16)
+    ->UseRealTime();
@@ -0,0 +1,162 @@
+#include "common/tokenize.h"
+
+#include "allocations.h"
+#include "benchmark/benchmark.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+
+/* Typical table keys, split on their separator */
+struct KeyShape
+{
+    const char *key;
+    char token;
+};
+
+const KeyShape KEY_SHAPES[] = {
+    { "Ethernet0|10.0.0.1/31", '|' },
+    { "VLAN|Vlan100", '|' },
+    { "VLAN_MEMBER|Vlan100|Ethernet4", '|' },
+    { "NEIGH_TABLE:Vlan1000:fc02:1000::99", ':' },
+    { "ROUTE_TABLE:2603:10e2:400:1::/64", ':' },
+};
+
+/* tokenize() before it was rebuilt on Tokenizer */
+vector<string> legacyTokenize(const string &str, const char token)
+{
+    string tmp;
+    vector<string> ret;
+    istringstream iss(str);
+
+    while (getline(iss, tmp, token))
+        ret.push_back(tmp);
+
+    return ret;
+}
+
+vector<string> legacyTokenize(const string &str, const char token, const size_t firstN)
+{
+    vector<string> ret;
+    string tmp = str;
+    size_t i = 0;
+    auto pos = tmp.find(token);
+
+    while (pos != string::npos && i++ < firstN)
+    {
+        ret.push_back(tmp.substr(0, pos));
+        tmp = tmp.substr(pos+1);
+        pos = tmp.find(token);
+    }
+
+    ret.push_back(tmp);
+
+    return ret;
+}
+
+}
+
+static void BM_TokenizeLegacy(benchmark::State &state)
+{
+    const KeyShape &shape = KEY_SHAPES[state.range(0)];
+    string key(shape.key);
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(legacyTokenize(key, shape.token));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_TokenizeLegacy)->DenseRange(0, 4);
+
+static void BM_Tokenize(benchmark::State &state)
+{
+    const KeyShape &shape = KEY_SHAPES[state.range(0)];
+    string key(shape.key);
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tokenize(key, shape.token));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_Tokenize)->DenseRange(0, 4);
+
+static void BM_Tokenizer(benchmark::State &state)
+{
+    const KeyShape &shape = KEY_SHAPES[state.range(0)];
+    string key(shape.key);
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        Tokenizer tokenizer(key, shape.token);
+        StringRef tok;
+        size_t len = 0;
+
+        while (tokenizer.next(tok))
+            len += tok.size();
+        benchmark::DoNotOptimize(len);
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_Tokenizer)->DenseRange(0, 4);
+
+/* Split off the table name, as done for every table event */
+static void BM_TokenizeFirstLegacy(benchmark::State &state)
+{
+    const KeyShape &shape = KEY_SHAPES[state.range(0)];
+    string key(shape.key);
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(legacyTokenize(key, shape.token, 1));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_TokenizeFirstLegacy)->DenseRange(0, 4);
+
+static void BM_TokenizeFirst(benchmark::State &state)
+{
+    const KeyShape &shape = KEY_SHAPES[state.range(0)];
+    string key(shape.key);
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tokenize(key, shape.token, 1));
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_TokenizeFirst)->DenseRange(0, 4);
+
+static void BM_TokenizeFirstArray(benchmark::State &state)
+{
+    const KeyShape &shape = KEY_SHAPES[state.range(0)];
+    string key(shape.key);
+
+    AllocationCounter allocations;
+    for (auto _ : state)
+    {
+        StringRef tokens[2];
+        benchmark::DoNotOptimize(tokenize(key, shape.token, tokens));
+        benchmark::DoNotOptimize(tokens);
+    }
+
+    allocations.report(state, state.iterations());
+}
+BENCHMARK(BM_TokenizeFirstArray)->DenseRange(0, 4);
@@ -0,0 +1,73 @@
+#include "common/trace.h"
+
+#include "benchmark/benchmark.h"
+
+#include <unistd.h>
+#include <string>
+#include <thread>
+
+using namespace swss;
+
+static const std::string TRACE_FILE = "./trace_bench.trace";
+static const std::string TABLE = "ROUTE_TABLE";
+static const std::string KEY = "10.10.10.0/24";
+
+static __attribute__((noinline)) int tracedOperation(int i)
+{
+    TraceSpan span(TRACE_PRODUCER_SET, TABLE, KEY);
+    span.setCount(static_cast<size_t>(i));
+
+    return i + 1;
+}
+
+static void BM_TraceDisabled(benchmark::State &state)
+{
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        i = tracedOperation(i);
+    }
+
+    benchmark::DoNotOptimize(i);
+}
+BENCHMARK(BM_TraceDisabled);
+
+static void BM_TraceSpan(benchmark::State &state)
+{
+    if (state.thread_index() == 0)
+        Trace::open(TRACE_FILE);
+
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        i = tracedOperation(i);
+    }
+
+    benchmark::DoNotOptimize(i);
+
+    if (state.thread_index() == 0)
+    {
+        Trace::close();
+        unlink(TRACE_FILE.c_str());
+    }
+}
+BENCHMARK(BM_TraceSpan)->Threads(1)->Threads(4);
+
+/* The ring write alone, without reading the clock */
+static void BM_TraceRecord(benchmark::State &state)
+{
+    Trace::open(TRACE_FILE);
+
+    uint32_t i = 0;
+
+    for (auto _ : state)
+    {
+        Trace::record(TRACE_PRODUCER_SET, 0, 0, TABLE.data(), TABLE.size(), KEY.data(), KEY.size(), i++);
+    }
+
+    Trace::close();
+    unlink(TRACE_FILE.c_str());
+}
+BENCHMARK(BM_TraceRecord);
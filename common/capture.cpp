@@ -0,0 +1,272 @@
+#include "capture.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdexcept>
+#include "logger.h"
+
+using namespace swss;
+
+const size_t Capture::BUFFER_SIZE;
+
+std::atomic<bool> Capture::m_enabled(false);
+std::mutex Capture::m_mutex;
+int Capture::m_fd = -1;
+uint64_t Capture::m_monotonicBase = 0;
+std::string *Capture::m_buffer = nullptr;
+
+namespace
+{
+
+uint64_t clockNow(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+template <typename T>
+inline void append(std::string &buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+inline void append(std::string &buffer, const std::string &str)
+{
+    append(buffer, static_cast<uint32_t>(str.size()));
+    buffer.append(str);
+}
+
+/* Reads the fields of a record, throws when they overrun it */
+class RecordParser
+{
+public:
+    RecordParser(const std::string &record) : m_record(record), m_offset(0)
+    {
+    }
+
+    template <typename T>
+    T get()
+    {
+        T value;
+        memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    std::string getString()
+    {
+        uint32_t len = get<uint32_t>();
+        return std::string(take(len), len);
+    }
+
+private:
+    const char *take(size_t len)
+    {
+        if (len > m_record.size() - m_offset)
+            throw std::runtime_error("Corrupted capture record");
+
+        const char *p = m_record.data() + m_offset;
+        m_offset += len;
+        return p;
+    }
+
+    const std::string &m_record;
+    size_t m_offset;
+};
+
+}
+
+void Capture::open(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_fd >= 0)
+    {
+        flushLocked();
+        ::close(m_fd);
+        m_fd = -1;
+    }
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Failed to open capture file " + path + ": " + strerror(errno));
+
+    CaptureFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_VERSION;
+    header.pid = static_cast<uint64_t>(getpid());
+    header.realtimeBase = clockNow(CLOCK_REALTIME);
+    m_monotonicBase = clockNow(CLOCK_MONOTONIC);
+
+    if (write(fd, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header)))
+    {
+        std::string error = strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Failed to write capture file " + path + ": " + error);
+    }
+
+    /* Never destroyed, for the tables written from static destructors */
+    if (m_buffer == nullptr)
+    {
+        m_buffer = new std::string();
+        atexit(Capture::close);
+    }
+
+    m_buffer->clear();
+    m_buffer->reserve(BUFFER_SIZE * 2);
+    m_fd = fd;
+    m_enabled.store(true, std::memory_order_relaxed);
+}
+
+void Capture::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_enabled.store(false, std::memory_order_relaxed);
+    if (m_fd < 0)
+        return;
+
+    flushLocked();
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+void Capture::flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_fd >= 0)
+        flushLocked();
+}
+
+void Capture::flushLocked()
+{
+    const char *data = m_buffer->data();
+    size_t left = m_buffer->size();
+
+    while (left > 0)
+    {
+        ssize_t written = write(m_fd, data, left);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            SWSS_LOG_ERROR("Failed to write the capture, %zu bytes lost: %s", left, strerror(errno));
+            break;
+        }
+
+        data += written;
+        left -= static_cast<size_t>(written);
+    }
+
+    m_buffer->clear();
+}
+
+void Capture::record(CaptureSource source, CaptureOperation operation, const std::string &dbName,
+                     const std::string &table, const std::string &key, const std::string &op,
+                     const std::vector<FieldValueTuple> &values)
+{
+    /* Encoded out of the lock, the length is filled once known */
+    static thread_local std::string record;
+    record.clear();
+    append(record, static_cast<uint32_t>(0));
+    append(record, static_cast<uint8_t>(source));
+    append(record, static_cast<uint8_t>(operation));
+    append(record, static_cast<uint16_t>(0));
+    append(record, static_cast<uint64_t>(0));
+    append(record, dbName);
+    append(record, table);
+    append(record, key);
+    append(record, op);
+    append(record, static_cast<uint32_t>(values.size()));
+    for (const auto &fv : values)
+    {
+        append(record, fvField(fv));
+        append(record, fvValue(fv));
+    }
+
+    uint32_t len = static_cast<uint32_t>(record.size() - sizeof(uint32_t));
+    memcpy(&record[0], &len, sizeof(len));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_fd < 0)
+        return;
+
+    /* Stamped under the lock, so that the file is in time order */
+    uint64_t now = clockNow(CLOCK_MONOTONIC);
+    uint64_t timestamp = now > m_monotonicBase ? now - m_monotonicBase : 0;
+    memcpy(&record[sizeof(uint32_t) + 4], &timestamp, sizeof(timestamp));
+
+    m_buffer->append(record);
+    if (m_buffer->size() >= BUFFER_SIZE)
+        flushLocked();
+}
+
+CaptureReader::CaptureReader(const std::string &path)
+    : m_file(path, std::ios::in | std::ios::binary)
+{
+    if (!m_file.is_open())
+        throw std::runtime_error("Failed to open capture file " + path + ": " + strerror(errno));
+
+    if (!m_file.read(reinterpret_cast<char *>(&m_header), sizeof(m_header)) ||
+        memcmp(m_header.magic, CAPTURE_MAGIC, sizeof(m_header.magic)) != 0)
+    {
+        throw std::runtime_error(path + " is not a capture file");
+    }
+
+    if (m_header.version != CAPTURE_VERSION)
+        throw std::runtime_error(path + " has unsupported capture version " + std::to_string(m_header.version));
+}
+
+bool CaptureReader::read(CaptureEntry &entry)
+{
+    uint32_t len;
+    if (!m_file.read(reinterpret_cast<char *>(&len), sizeof(len)))
+        return false;
+
+    m_record.resize(len);
+    if (!m_file.read(&m_record[0], len))
+        return false;
+
+    RecordParser parser(m_record);
+    entry.source = static_cast<CaptureSource>(parser.get<uint8_t>());
+    entry.operation = static_cast<CaptureOperation>(parser.get<uint8_t>());
+    parser.get<uint16_t>();
+    entry.timestamp = parser.get<uint64_t>();
+    entry.dbName = parser.getString();
+    entry.table = parser.getString();
+    entry.key = parser.getString();
+    entry.op = parser.getString();
+
+    uint32_t count = parser.get<uint32_t>();
+    entry.values.clear();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        std::string field = parser.getString();
+        entry.values.emplace_back(field, parser.getString());
+    }
+
+    return true;
+}
+
+const char *CaptureReader::sourceName(CaptureSource source)
+{
+    switch (source)
+    {
+        case CAPTURE_PRODUCER_STATE_TABLE:
+            return "ProducerStateTable";
+        case CAPTURE_PRODUCER_TABLE:
+            return "ProducerTable";
+        case CAPTURE_NOTIFICATION_PRODUCER:
+            return "NotificationProducer";
+        default:
+            return "UNKNOWN";
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef __CAPTURE__
+#define __CAPTURE__
+
+#include <stdint.h>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "table.h"
+
+namespace swss {
+
+enum CaptureSource
+{
+    CAPTURE_PRODUCER_STATE_TABLE = 1,
+    CAPTURE_PRODUCER_TABLE,
+    CAPTURE_NOTIFICATION_PRODUCER,
+};
+
+enum CaptureOperation
+{
+    CAPTURE_SET = 1,
+    CAPTURE_DEL,
+    CAPTURE_SEND,
+};
+
+/* Start of the capture file, the records follow */
+struct CaptureFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t pid;
+    uint64_t realtimeBase;      /* CLOCK_REALTIME ns when opened */
+};
+
+static const char CAPTURE_MAGIC[8] = { 'S', 'W', 'S', 'S', 'C', 'A', 'P', '\0' };
+static const uint32_t CAPTURE_VERSION = 1;
+
+/*
+ * A record is a uint32_t length followed by that many bytes:
+ *   uint8_t source, uint8_t operation, uint16_t reserved,
+ *   uint64_t timestamp (CLOCK_MONOTONIC ns since open),
+ *   the database name, table, key and op, then a uint32_t count of field
+ *   and value pairs. Strings are a uint32_t length and the bytes.
+ * A notification has its data as key. Integers are in host order.
+ */
+struct CaptureEntry
+{
+    CaptureSource source;
+    CaptureOperation operation;
+    uint64_t timestamp;
+    std::string dbName;
+    std::string table;          /* Channel of a notification */
+    std::string key;
+    std::string op;
+    std::vector<FieldValueTuple> values;
+};
+
+/*
+ * Capture of the writes of ProducerStateTable, ProducerTable and
+ * NotificationProducer into a streaming file, for swssreplay. Records are
+ * encoded by the calling thread and written by blocks of BUFFER_SIZE.
+ */
+class Capture
+{
+public:
+    static const size_t BUFFER_SIZE = 1 << 16;
+
+    /* Create or truncate path and start capturing. Throws std::runtime_error. */
+    static void open(const std::string &path);
+
+    /* Stop capturing, write what is buffered */
+    static void close();
+
+    /* Write what is buffered */
+    static void flush();
+
+    static inline bool isEnabled()
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    static void record(CaptureSource source, CaptureOperation operation, const std::string &dbName,
+                       const std::string &table, const std::string &key, const std::string &op,
+                       const std::vector<FieldValueTuple> &values);
+
+private:
+    static void flushLocked();
+
+    static std::atomic<bool> m_enabled;
+
+    /* Guards the members below */
+    static std::mutex m_mutex;
+    static int m_fd;
+    static uint64_t m_monotonicBase;
+    static std::string *m_buffer;
+};
+
+/* Reads a capture file, a record at a time */
+class CaptureReader
+{
+public:
+    /* Throws std::runtime_error when path is not a capture file */
+    CaptureReader(const std::string &path);
+
+    /*
+     * Next record, false at the end of the file or of its last complete
+     * record. Throws std::runtime_error on a corrupted record.
+     */
+    bool read(CaptureEntry &entry);
+
+    inline uint64_t getPid() const
+    {
+        return m_header.pid;
+    }
+
+    inline uint64_t getRealtimeBase() const
+    {
+        return m_header.realtimeBase;
+    }
+
+    static const char *sourceName(CaptureSource source);
+
+private:
+    std::ifstream m_file;
+    CaptureFileHeader m_header;
+    std::string m_record;
+};
+
+}
+
+#endif
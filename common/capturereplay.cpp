@@ -0,0 +1,257 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "capture.h"
+#include "dbconnector.h"
+#include "redispipeline.h"
+#include "producerstatetable.h"
+#include "producertable.h"
+#include "notificationproducer.h"
+
+using namespace swss;
+
+[[ noreturn ]] void usage(const std::string &program, int status, const std::string &message)
+{
+    if (message.size() != 0)
+    {
+        std::cout << message << std::endl << std::endl;
+    }
+
+    std::cout << "Usage: " << program << " [OPTIONS]" << std::endl
+              << "Replay a SONiC table capture file against redis." << std::endl << std::endl
+              << "Options:" << std::endl
+              << "\t -h\tprint this message" << std::endl
+              << "\t -f\tcapture file written with swss::Capture::open()" << std::endl
+              << "\t -s\tspeed, a multiple of the original one, 0 for as fast as possible (default 1)" << std::endl
+              << "\t -c\tdatabase config file of the redis to replay to" << std::endl
+              << "\t -p\tprint the records instead of replaying them" << std::endl << std::endl
+              << "Examples:" << std::endl
+              << "\t" << program << " -f /var/log/swss/fpmsyncd.capture -p # print the records" << std::endl
+              << "\t" << program << " -f /var/log/swss/fpmsyncd.capture -s 10 # replay 10 times faster" << std::endl;
+
+    exit(status);
+}
+
+/* Writes the records with producers of each table, on a buffered pipeline per database */
+class Replayer
+{
+public:
+    void replay(const CaptureEntry &entry)
+    {
+        switch (entry.source)
+        {
+            case CAPTURE_PRODUCER_STATE_TABLE:
+            {
+                auto &table = m_stateTables[tableId(entry)];
+                if (!table)
+                    table.reset(new ProducerStateTable(&pipeline(entry.dbName), entry.table, true));
+
+                if (entry.operation == CAPTURE_DEL)
+                    table->del(entry.key, entry.op);
+                else
+                    table->set(entry.key, entry.values, entry.op);
+                break;
+            }
+            case CAPTURE_PRODUCER_TABLE:
+            {
+                auto &table = m_tables[tableId(entry)];
+                if (!table)
+                    table.reset(new ProducerTable(&pipeline(entry.dbName), entry.table, true));
+
+                if (entry.operation == CAPTURE_DEL)
+                    table->del(entry.key, entry.op);
+                else
+                    table->set(entry.key, entry.values, entry.op);
+                break;
+            }
+            case CAPTURE_NOTIFICATION_PRODUCER:
+            {
+                auto &producer = m_notifications[tableId(entry)];
+                if (!producer)
+                    producer.reset(new NotificationProducer(&db(entry.dbName), entry.table));
+
+                /* After the table writes which came before */
+                flush();
+                std::vector<FieldValueTuple> values(entry.values);
+                producer->send(entry.op, entry.key, values);
+                break;
+            }
+            default:
+                throw std::runtime_error("Unknown capture source " + std::to_string(entry.source));
+        }
+    }
+
+    void flush()
+    {
+        for (auto &redisPipeline : m_pipelines)
+            redisPipeline.second->flush();
+    }
+
+private:
+    typedef std::pair<std::string, std::string> TableId;
+
+    static TableId tableId(const CaptureEntry &entry)
+    {
+        return TableId(entry.dbName, entry.table);
+    }
+
+    DBConnector &db(const std::string &dbName)
+    {
+        auto &connector = m_dbs[dbName];
+        if (!connector)
+            connector.reset(new DBConnector(dbName, 0));
+        return *connector;
+    }
+
+    RedisPipeline &pipeline(const std::string &dbName)
+    {
+        auto &redisPipeline = m_pipelines[dbName];
+        if (!redisPipeline)
+            redisPipeline.reset(new RedisPipeline(&db(dbName)));
+        return *redisPipeline;
+    }
+
+    std::map<std::string, std::unique_ptr<DBConnector>> m_dbs;
+    std::map<std::string, std::unique_ptr<RedisPipeline>> m_pipelines;
+    std::map<TableId, std::unique_ptr<ProducerStateTable>> m_stateTables;
+    std::map<TableId, std::unique_ptr<ProducerTable>> m_tables;
+    std::map<TableId, std::unique_ptr<NotificationProducer>> m_notifications;
+};
+
+void printEntry(const CaptureReader &reader, const CaptureEntry &entry)
+{
+    uint64_t timestamp = reader.getRealtimeBase() + entry.timestamp;
+    time_t seconds = static_cast<time_t>(timestamp / 1000000000ULL);
+    struct tm tm;
+    char date[32];
+
+    localtime_r(&seconds, &tm);
+    strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &tm);
+
+    std::cout << date << "." << std::setfill('0') << std::setw(9) << timestamp % 1000000000ULL
+              << std::setfill(' ') << " " << std::left << std::setw(20)
+              << CaptureReader::sourceName(entry.source) << std::right << " "
+              << entry.dbName << " " << entry.table << " " << entry.op << " " << entry.key;
+
+    for (const auto &fv : entry.values)
+        std::cout << " " << fvField(fv) << "=" << fvValue(fv);
+
+    std::cout << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    bool print = false;
+    double speed = 1;
+    std::string path;
+    std::string config;
+    auto exitWithUsage = std::bind(usage, argv[0], std::placeholders::_1, std::placeholders::_2);
+
+    while ((opt = getopt (argc, argv, "f:s:c:ph")) != -1)
+    {
+        switch(opt)
+        {
+            case 'f':
+                path = optarg;
+                break;
+            case 's':
+                speed = atof(optarg);
+                if (speed < 0)
+                    exitWithUsage(EXIT_FAILURE, "Invalid speed");
+                break;
+            case 'c':
+                config = optarg;
+                break;
+            case 'p':
+                print = true;
+                break;
+            case 'h':
+                exitWithUsage(EXIT_SUCCESS, "");
+                break;
+            default:
+                exitWithUsage(EXIT_FAILURE, "Invalid option");
+        }
+    }
+
+    if (path.empty())
+    {
+        exitWithUsage(EXIT_FAILURE, "No capture file given");
+    }
+
+    try
+    {
+        CaptureReader reader(path);
+        CaptureEntry entry;
+
+        if (print)
+        {
+            while (reader.read(entry))
+                printEntry(reader, entry);
+            return EXIT_SUCCESS;
+        }
+
+        if (!config.empty())
+            SonicDBConfig::initialize(config);
+
+        Replayer replayer;
+        uint64_t count = 0;
+        uint64_t skipped = 0;
+        uint64_t first = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        while (reader.read(entry))
+        {
+            /* Times are kept from the first record on */
+            if (count + skipped == 0)
+                first = entry.timestamp;
+
+            if (speed > 0)
+            {
+                /* A record older than the first one is due at once */
+                uint64_t delay = entry.timestamp > first ? entry.timestamp - first : 0;
+                double offset = static_cast<double>(delay) / speed;
+                auto due = start + std::chrono::nanoseconds(static_cast<int64_t>(offset));
+                if (std::chrono::steady_clock::now() < due)
+                {
+                    /* Send what is due before waiting */
+                    replayer.flush();
+                    std::this_thread::sleep_until(due);
+                }
+            }
+
+            /* Written through a DBConnector opened by id */
+            if (entry.dbName.empty())
+            {
+                skipped++;
+                continue;
+            }
+
+            replayer.replay(entry);
+            count++;
+        }
+
+        replayer.flush();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Replayed " << count << " records in " << elapsed.count() << "s";
+        if (skipped > 0)
+            std::cout << ", skipped " << skipped << " without a database name";
+        std::cout << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
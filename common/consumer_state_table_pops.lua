@@ -2,6 +2,7 @@ redis.replicate_commands()
 local ret = {}
 local tablename = KEYS[2]
 local stateprefix = ARGV[2]
+local stampfield = ARGV[3]
 local keys = redis.call('SPOP', KEYS[1], ARGV[1])
 local n = table.getn(keys)
 for i = 1, n do
@@ -11,11 +12,14 @@ for i = 1, n do
    if num == 1 then
       redis.call('DEL', tablename..key)
    end
-   -- Push the new set of field/value for this key in table
+   -- Push the new set of field/value for this key in table,
+   -- but the latency stamp which is only returned
    local fieldvalues = redis.call('HGETALL', stateprefix..tablename..key)
    table.insert(ret, {key, fieldvalues})
    for i = 1, #fieldvalues, 2 do
-      redis.call('HSET', tablename..key, fieldvalues[i], fieldvalues[i + 1])
+      if fieldvalues[i] ~= stampfield then
+         redis.call('HSET', tablename..key, fieldvalues[i], fieldvalues[i + 1])
+      end
    end
    -- Clean up the key in temporary state table
    redis.call('DEL', stateprefix..tablename..key)
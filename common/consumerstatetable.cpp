@@ -1,3 +1,4 @@
+#include <stdlib.h>
 #include <string>
 #include <deque>
 #include <limits>
@@ -8,12 +9,14 @@
 #include "redisselect.h"
 #include "redisapi.h"
 #include "consumerstatetable.h"
+#include "trace.h"
 
 namespace swss {
 
 ConsumerStateTable::ConsumerStateTable(DBConnector *db, const std::string &tableName, int popBatchSize, int pri)
     : ConsumerTableBase(db, tableName, popBatchSize, pri)
     , TableName_KeySet(tableName)
+    , m_stampLatency(m_metricsGroup, "e2e_ns")
 {
     std::string luaScript = loadLuaScript("consumer_state_table_pops.lua");
     m_shaPop = loadRedisScript(db, luaScript);
@@ -35,16 +38,19 @@ ConsumerStateTable::ConsumerStateTable(DBConnector *db, const std::string &table
 
 void ConsumerStateTable::pops(std::deque<KeyOpFieldsValuesTuple> &vkco, const std::string& /*prefix*/)
 {
+    TraceSpan span(TRACE_CONSUMER_POPS, getTableName());
+    uint64_t start = popsStart();
 
     RedisCommand command;
     command.format(
-        "EVALSHA %s 3 %s %s: %s %d %s",
+        "EVALSHA %s 3 %s %s: %s %d %s %s",
         m_shaPop.c_str(),
         getKeySetName().c_str(),
         getTableName().c_str(),
         getDelKeySetName().c_str(),
         POP_BATCH_SIZE,
-        getStateHashPrefix().c_str());
+        getStateHashPrefix().c_str(),
+        getLatencyStampField().c_str());
 
     RedisReply r(m_db, command);
     auto ctx0 = r.getContext();
@@ -53,12 +59,16 @@ void ConsumerStateTable::pops(std::deque<KeyOpFieldsValuesTuple> &vkco, const st
     // if the set is empty, return an empty kco object
     if (ctx0->type == REDIS_REPLY_NIL)
     {
+        recordPops(start, 0);
         return;
     }
 
     assert(ctx0->type == REDIS_REPLY_ARRAY);
+    const std::string stampField = getLatencyStampField();
+    uint64_t now = 0;
     size_t n = ctx0->elements;
     vkco.resize(n);
+    span.setCount(n);
     for (size_t ie = 0; ie < n; ie++)
     {
         auto& kco = vkco[ie];
@@ -74,6 +84,21 @@ void ConsumerStateTable::pops(std::deque<KeyOpFieldsValuesTuple> &vkco, const st
         auto ctx1 = ctx->element[1];
         for (size_t i = 0; i < ctx1->elements / 2; i++)
         {
+            if (stampField == ctx1->element[i * 2]->str)
+            {
+                if (MetricsRegistry::isEnabled())
+                {
+                    if (now == 0)
+                        now = MetricsRegistry::now();
+
+                    /* "<CLOCK_MONOTONIC ns>:<sequence>" */
+                    uint64_t stamp = strtoull(ctx1->element[i * 2 + 1]->str, NULL, 10);
+                    if (stamp != 0 && stamp <= now)
+                        m_stampLatency.get().record(now - stamp);
+                }
+                continue;
+            }
+
             FieldValueTuple e;
             fvField(e) = ctx1->element[i * 2]->str;
             fvValue(e) = ctx1->element[i * 2 + 1]->str;
@@ -90,6 +115,8 @@ void ConsumerStateTable::pops(std::deque<KeyOpFieldsValuesTuple> &vkco, const st
             kfvOp(kco) = SET_COMMAND;
         }
     }
+
+    recordPops(start, n);
 }
 
 }
@@ -17,6 +17,9 @@ public:
 
 private:
     std::string m_shaPop;
+
+    /* Latency from the stamp of ProducerStateTable::setLatencyStamps() */
+    LazyMetric<Histogram> m_stampLatency;
 };
 
 }
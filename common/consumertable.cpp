@@ -9,6 +9,7 @@
 #include "common/json.h"
 #include "common/logger.h"
 #include "common/redisapi.h"
+#include "common/trace.h"
 
 using namespace std;
 
@@ -49,6 +50,9 @@ void ConsumerTable::setModifyRedis(bool modify)
 
 void ConsumerTable::pops(deque<KeyOpFieldsValuesTuple> &vkco, const string &prefix)
 {
+    TraceSpan span(TRACE_CONSUMER_POPS, getTableName());
+    uint64_t start = popsStart();
+
     RedisCommand command;
     command.format(
         "EVALSHA %s 2 %s %s %d %d",
@@ -66,12 +70,14 @@ void ConsumerTable::pops(deque<KeyOpFieldsValuesTuple> &vkco, const string &pref
     // if the set is empty, return an empty kco object
     if (r.getContext()->type == REDIS_REPLY_NIL)
     {
+        recordPops(start, 0);
         return;
     }
 
     assert(ctx0->type == REDIS_REPLY_ARRAY);
     size_t n = ctx0->elements;
     vkco.resize(n);
+    span.setCount(n);
 
     for (size_t ie = 0; ie < n; ie++)
     {
@@ -100,6 +106,8 @@ void ConsumerTable::pops(deque<KeyOpFieldsValuesTuple> &vkco, const string &pref
             values.push_back(e);
         }
     }
+
+    recordPops(start, n);
 }
 
 }
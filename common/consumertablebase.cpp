@@ -5,7 +5,11 @@ namespace swss {
 ConsumerTableBase::ConsumerTableBase(DBConnector *db, const std::string &tableName, int popBatchSize, int pri):
         TableConsumable(tableName, SonicDBConfig::getSeparator(db), pri),
         RedisTransactioner(db),
-        POP_BATCH_SIZE(popBatchSize)
+        POP_BATCH_SIZE(popBatchSize),
+        m_metricsGroup(db->getDbName(), tableName),
+        m_popsCount(m_metricsGroup, "pops"),
+        m_popsBatch(m_metricsGroup, "pops_batch"),
+        m_popsLatency(m_metricsGroup, "pops_ns")
 {
 }
 
@@ -2,6 +2,7 @@
 
 #include "table.h"
 #include "selectable.h"
+#include "metrics.h"
 
 namespace swss {
 
@@ -23,7 +24,31 @@ public:
     bool empty() const { return m_buffer.empty(); };
 protected:
 
+    /* Start of a pops() for recordPops(), 0 when the metrics are disabled */
+    static inline uint64_t popsStart()
+    {
+        return MetricsRegistry::isEnabled() ? MetricsRegistry::now() : 0;
+    }
+
+    /* Account a pops() which returned count entries */
+    inline void recordPops(uint64_t start, size_t count)
+    {
+        if (start == 0)
+            return;
+
+        m_popsCount.get().add();
+        m_popsBatch.get().record(count);
+        m_popsLatency.get().record(MetricsRegistry::now() - start);
+    }
+
     std::deque<KeyOpFieldsValuesTuple> m_buffer;
+
+    MetricsGroup m_metricsGroup;
+
+private:
+    LazyMetric<Counter> m_popsCount;
+    LazyMetric<Histogram> m_popsBatch;
+    LazyMetric<Histogram> m_popsLatency;
 };
 
 }
@@ -11,38 +11,218 @@
 
 namespace swss {
 
-static inline uint64_t __to_uint64(const std::string &str, uint64_t min = std::numeric_limits<uint64_t>::min(), uint64_t max = std::numeric_limits<uint64_t>::max())
+enum CONVERT_RC
+{
+    CONVERT_OK = 0,
+    CONVERT_ERROR_INVALID,      /* No number at the start of the string */
+    CONVERT_ERROR_TRAILING,     /* Characters left after the number */
+    CONVERT_ERROR_OVERFLOW,     /* Number does not fit in 64 bits */
+    CONVERT_ERROR_RANGE,        /* Number is not in the requested min - max */
+};
+
+namespace converter_detail
 {
-    size_t idx = 0;
-    uint64_t ret = stoul(str, &idx, 0);
-    if (str[idx])
+    /* Value of a hex digit, 16 for any other character */
+    static inline unsigned digitValue(char ch)
     {
-        throw std::invalid_argument("failed to convert " + str + " value to uint64_t type");
+        unsigned c = static_cast<unsigned char>(ch);
+
+        if (c - '0' < 10)
+            return c - '0';
+        if ((c | 0x20) - 'a' < 6)
+            return (c | 0x20) - 'a' + 10;
+        return 16;
     }
 
-    if (ret < min || ret > max)
+    /* Digits in base, with the base known at compile time for cheap overflow checks */
+    template <unsigned base>
+    static inline CONVERT_RC parseDigits(const char *&p, const char *end, uint64_t limit, uint64_t &magnitude)
+    {
+        const char *digits = p;
+        uint64_t value = 0;
+        uint64_t cutoff = limit / base;
+        unsigned cutlim = static_cast<unsigned>(limit % base);
+
+        for (; p != end; p++)
+        {
+            unsigned d = digitValue(*p);
+            if (d >= base)
+                break;
+
+            if (value > cutoff || (value == cutoff && d > cutlim))
+                return CONVERT_ERROR_OVERFLOW;
+
+            value = value * base + d;
+        }
+
+        if (p == digits)
+            return CONVERT_ERROR_INVALID;
+
+        magnitude = value;
+        return CONVERT_OK;
+    }
+
+    /*
+     * Parse like strtoull with base 0, without locale, errno or std::string:
+     * leading white space, an optional sign, then a hex number after 0x, an
+     * octal number after 0 or a decimal number. Returns the magnitude, with
+     * p past the digits.
+     */
+    static inline CONVERT_RC parseMagnitude(const char *&p, const char *end, uint64_t limit, uint64_t &magnitude, bool &negative)
     {
-        throw std::invalid_argument("failed to convert " + str + " value is not in range " + std::to_string(min) + " - " + std::to_string(max));
+        while (p != end && (*p == ' ' || (*p >= '\t' && *p <= '\r')))
+            p++;
+
+        negative = false;
+        if (p != end && (*p == '+' || *p == '-'))
+            negative = *p++ == '-';
+
+        if (p == end || *p != '0')
+            return parseDigits<10>(p, end, limit, magnitude);
+
+        if (end - p > 2 && (p[1] == 'x' || p[1] == 'X') && digitValue(p[2]) < 16)
+        {
+            p += 2;
+            return parseDigits<16>(p, end, limit, magnitude);
+        }
+
+        return parseDigits<8>(p, end, limit, magnitude);
     }
+}
+
+/*
+ * Non throwing conversion of the len characters at str, with the same
+ * syntax as __to_uint64. Like strtoull, a negative number wraps around.
+ * value is only set on CONVERT_OK.
+ */
+static inline CONVERT_RC try_to_uint64(const char *str, size_t len, uint64_t &value, uint64_t min = std::numeric_limits<uint64_t>::min(), uint64_t max = std::numeric_limits<uint64_t>::max())
+{
+    const char *p = str;
+    const char *end = str + len;
+    uint64_t magnitude;
+    bool negative;
+
+    CONVERT_RC rc = converter_detail::parseMagnitude(p, end, std::numeric_limits<uint64_t>::max(), magnitude, negative);
+    if (rc != CONVERT_OK)
+        return rc;
+
+    if (p != end)
+        return CONVERT_ERROR_TRAILING;
+
+    uint64_t ret = negative ? 0 - magnitude : magnitude;
+    if (ret < min || ret > max)
+        return CONVERT_ERROR_RANGE;
 
-    return ret;
+    value = ret;
+    return CONVERT_OK;
 }
 
-static inline int64_t __to_int64(const std::string &str, int64_t min = std::numeric_limits<int64_t>::min(), int64_t max = std::numeric_limits<int64_t>::max())
+/* Non throwing conversion with the same syntax as __to_int64 */
+static inline CONVERT_RC try_to_int64(const char *str, size_t len, int64_t &value, int64_t min = std::numeric_limits<int64_t>::min(), int64_t max = std::numeric_limits<int64_t>::max())
+{
+    const char *p = str;
+    const char *end = str + len;
+    uint64_t magnitude;
+    bool negative;
+
+    /* Accept one more for INT64_MIN, checked below once the sign is known */
+    uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1;
+    CONVERT_RC rc = converter_detail::parseMagnitude(p, end, limit, magnitude, negative);
+    if (rc != CONVERT_OK)
+        return rc;
+
+    if (!negative && magnitude == limit)
+        return CONVERT_ERROR_OVERFLOW;
+
+    if (p != end)
+        return CONVERT_ERROR_TRAILING;
+
+    int64_t ret = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+    if (ret < min || ret > max)
+        return CONVERT_ERROR_RANGE;
+
+    value = ret;
+    return CONVERT_OK;
+}
+
+static inline uint64_t __to_uint64(const std::string &str, uint64_t min = std::numeric_limits<uint64_t>::min(), uint64_t max = std::numeric_limits<uint64_t>::max())
 {
-    size_t idx = 0;
-    int64_t ret = stol(str, &idx, 0);
-    if (str[idx])
+    uint64_t ret = 0;
+
+    switch (try_to_uint64(str.c_str(), str.size(), ret, min, max))
     {
-        throw std::invalid_argument("failed to convert " + str + " value to int64_t type");
+        case CONVERT_OK:
+            return ret;
+        case CONVERT_ERROR_INVALID:
+            throw std::invalid_argument("stoul");
+        case CONVERT_ERROR_OVERFLOW:
+            throw std::out_of_range("stoul");
+        case CONVERT_ERROR_TRAILING:
+            throw std::invalid_argument("failed to convert " + str + " value to uint64_t type");
+        case CONVERT_ERROR_RANGE:
+        default:
+            throw std::invalid_argument("failed to convert " + str + " value is not in range " + std::to_string(min) + " - " + std::to_string(max));
     }
+}
 
-    if (ret < min || ret > max)
+static inline int64_t __to_int64(const std::string &str, int64_t min = std::numeric_limits<int64_t>::min(), int64_t max = std::numeric_limits<int64_t>::max())
+{
+    int64_t ret = 0;
+
+    switch (try_to_int64(str.c_str(), str.size(), ret, min, max))
     {
-        throw std::invalid_argument("failed to convert " + str + " value is not in range " + std::to_string(min) + " - " + std::to_string(max));
+        case CONVERT_OK:
+            return ret;
+        case CONVERT_ERROR_INVALID:
+            throw std::invalid_argument("stol");
+        case CONVERT_ERROR_OVERFLOW:
+            throw std::out_of_range("stol");
+        case CONVERT_ERROR_TRAILING:
+            throw std::invalid_argument("failed to convert " + str + " value to int64_t type");
+        case CONVERT_ERROR_RANGE:
+        default:
+            throw std::invalid_argument("failed to convert " + str + " value is not in range " + std::to_string(min) + " - " + std::to_string(max));
     }
+}
+
+template <typename T>
+CONVERT_RC try_to_int(const char *str, size_t len, T &value, T min = std::numeric_limits<T>::min(), T max = std::numeric_limits<T>::max())
+{
+    static_assert(std::is_signed<T>::value, "Signed integer is expected");
+    static_assert(std::numeric_limits<T>::max() <= std::numeric_limits<int64_t>::max(), "Type is too big");
+
+    int64_t ret;
+    CONVERT_RC rc = try_to_int64(str, len, ret, min, max);
+    if (rc == CONVERT_OK)
+        value = static_cast<T>(ret);
 
-    return ret;
+    return rc;
+}
+
+template <typename T>
+CONVERT_RC try_to_int(const std::string &str, T &value, T min = std::numeric_limits<T>::min(), T max = std::numeric_limits<T>::max())
+{
+    return try_to_int(str.c_str(), str.size(), value, min, max);
+}
+
+template <typename T>
+CONVERT_RC try_to_uint(const char *str, size_t len, T &value, T min = std::numeric_limits<T>::min(), T max = std::numeric_limits<T>::max())
+{
+    static_assert(std::is_unsigned<T>::value, "Unsigned integer is expected");
+    static_assert(std::numeric_limits<T>::max() <= std::numeric_limits<uint64_t>::max(), "Type is too big");
+
+    uint64_t ret;
+    CONVERT_RC rc = try_to_uint64(str, len, ret, min, max);
+    if (rc == CONVERT_OK)
+        value = static_cast<T>(ret);
+
+    return rc;
+}
+
+template <typename T>
+CONVERT_RC try_to_uint(const std::string &str, T &value, T min = std::numeric_limits<T>::min(), T max = std::numeric_limits<T>::max())
+{
+    return try_to_uint(str.c_str(), str.size(), value, min, max);
 }
 
 template <typename T>
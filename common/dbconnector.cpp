@@ -395,6 +395,7 @@ RedisContext::~RedisContext()
 }
 
 RedisContext::RedisContext()
+    : m_conn(NULL)
 {
 }
 
@@ -0,0 +1,298 @@
+#ifndef __FLATHASHMAP__
+#define __FLATHASHMAP__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace swss {
+
+/*
+ * Open addressing hash map with linear probing, for small keys such as
+ * IpAddress, IpPrefix, MacAddress or integers.
+ *
+ * Keys and values live in one flat array, next to a byte per slot holding
+ * 7 bits of the hash, so most probes of other keys are rejected without
+ * touching the slot array. Erase shifts the following entries back instead
+ * of leaving tombstones. The hash is mixed again, so std::hash of integers
+ * and packed keys is fine as is.
+ *
+ * K and V must be default constructible. Pointers to values are valid until
+ * the next insert or erase.
+ */
+template<typename K, typename V, typename Hash = std::hash<K>>
+class FlatHashMap
+{
+public:
+    FlatHashMap() : m_size(0), m_mask(0) {}
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void clear()
+    {
+        m_ctrl.clear();
+        m_slots.clear();
+        m_size = 0;
+        m_mask = 0;
+    }
+
+    /* Make room for count entries without rehashing */
+    void reserve(size_t count)
+    {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity * MAX_LOAD_NUM < count * MAX_LOAD_DEN)
+            capacity <<= 1;
+
+        if (capacity > m_ctrl.size())
+            rehash(capacity);
+    }
+
+    /* Returns false and keeps the current value when key is already present */
+    bool insert(const K &key, const V &value)
+    {
+        size_t index;
+        if (locate(key, index))
+            return false;
+
+        index = add(key, index);
+        m_slots[index].second = value;
+        return true;
+    }
+
+    V &operator[](const K &key)
+    {
+        size_t index;
+        if (!locate(key, index))
+            index = add(key, index);
+
+        return m_slots[index].second;
+    }
+
+    V *find(const K &key)
+    {
+        size_t index;
+        return locate(key, index) ? &m_slots[index].second : nullptr;
+    }
+
+    const V *find(const K &key) const
+    {
+        size_t index;
+        return locate(key, index) ? &m_slots[index].second : nullptr;
+    }
+
+    bool contains(const K &key) const
+    {
+        size_t index;
+        return locate(key, index);
+    }
+
+    /* Returns false when the key was not present */
+    bool erase(const K &key)
+    {
+        size_t hole;
+        if (!locate(key, hole))
+            return false;
+
+        /* Move back entries whose home slot is not after the hole */
+        size_t next = (hole + 1) & m_mask;
+        while (m_ctrl[next] != EMPTY)
+        {
+            size_t home = mix(m_hash(m_slots[next].first)) & m_mask;
+            if (((next - home) & m_mask) >= ((next - hole) & m_mask))
+            {
+                m_ctrl[hole] = m_ctrl[next];
+                m_slots[hole] = std::move(m_slots[next]);
+                hole = next;
+            }
+            next = (next + 1) & m_mask;
+        }
+
+        m_ctrl[hole] = EMPTY;
+        m_slots[hole] = std::pair<K, V>();
+        m_size--;
+        return true;
+    }
+
+    /* Call f(const K &, V &) for every entry, in no particular order */
+    template<typename F>
+    void forEach(F f)
+    {
+        for (size_t i = 0; i < m_ctrl.size(); i++)
+        {
+            if (m_ctrl[i] != EMPTY)
+                f(const_cast<const K &>(m_slots[i].first), m_slots[i].second);
+        }
+    }
+
+    template<typename F>
+    void forEach(F f) const
+    {
+        for (size_t i = 0; i < m_ctrl.size(); i++)
+        {
+            if (m_ctrl[i] != EMPTY)
+                f(m_slots[i].first, m_slots[i].second);
+        }
+    }
+
+private:
+    static const uint8_t EMPTY = 0;
+    static const size_t MIN_CAPACITY = 16;
+
+    /* Grow above 7/8 full */
+    static const size_t MAX_LOAD_NUM = 7;
+    static const size_t MAX_LOAD_DEN = 8;
+
+    /* Final step of MurmurHash3, spreads any input over all bits */
+    static uint64_t mix(size_t hash)
+    {
+        uint64_t h = static_cast<uint64_t>(hash);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /* Never EMPTY, the high bit is always set */
+    static uint8_t tag(uint64_t h)
+    {
+        return static_cast<uint8_t>((h >> 57) | 0x80);
+    }
+
+    /* Returns true with the slot of key, or false with the free slot where it belongs */
+    bool locate(const K &key, size_t &index) const
+    {
+        if (m_ctrl.empty())
+        {
+            index = 0;
+            return false;
+        }
+
+        uint64_t h = mix(m_hash(key));
+        uint8_t t = tag(h);
+
+        for (index = h & m_mask; m_ctrl[index] != EMPTY; index = (index + 1) & m_mask)
+        {
+            if (m_ctrl[index] == t && m_slots[index].first == key)
+                return true;
+        }
+
+        return false;
+    }
+
+    /* Store key in the free slot found by locate, growing first when needed */
+    size_t add(const K &key, size_t index)
+    {
+        if (m_ctrl.empty() || (m_size + 1) * MAX_LOAD_DEN > m_ctrl.size() * MAX_LOAD_NUM)
+        {
+            rehash(m_ctrl.empty() ? MIN_CAPACITY : m_ctrl.size() * 2);
+            locate(key, index);
+        }
+
+        m_ctrl[index] = tag(mix(m_hash(key)));
+        m_slots[index].first = key;
+        m_size++;
+        return index;
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<uint8_t> ctrl(capacity, static_cast<uint8_t>(EMPTY));
+        std::vector<std::pair<K, V>> slots(capacity);
+        size_t mask = capacity - 1;
+
+        for (size_t i = 0; i < m_ctrl.size(); i++)
+        {
+            if (m_ctrl[i] == EMPTY)
+                continue;
+
+            size_t index = mix(m_hash(m_slots[i].first)) & mask;
+            while (ctrl[index] != EMPTY)
+                index = (index + 1) & mask;
+
+            ctrl[index] = m_ctrl[i];
+            slots[index] = std::move(m_slots[i]);
+        }
+
+        m_ctrl.swap(ctrl);
+        m_slots.swap(slots);
+        m_mask = mask;
+    }
+
+    std::vector<uint8_t> m_ctrl;
+    std::vector<std::pair<K, V>> m_slots;
+    size_t m_size;
+    size_t m_mask;
+    Hash m_hash;
+};
+
+/* Set counterpart of FlatHashMap, with the same requirements on K */
+template<typename K, typename Hash = std::hash<K>>
+class FlatHashSet
+{
+public:
+    size_t size() const
+    {
+        return m_map.size();
+    }
+
+    bool empty() const
+    {
+        return m_map.empty();
+    }
+
+    void clear()
+    {
+        m_map.clear();
+    }
+
+    void reserve(size_t count)
+    {
+        m_map.reserve(count);
+    }
+
+    /* Returns false when key is already present */
+    bool insert(const K &key)
+    {
+        return m_map.insert(key, Empty());
+    }
+
+    bool contains(const K &key) const
+    {
+        return m_map.contains(key);
+    }
+
+    bool erase(const K &key)
+    {
+        return m_map.erase(key);
+    }
+
+    /* Call f(const K &) for every key, in no particular order */
+    template<typename F>
+    void forEach(F f) const
+    {
+        m_map.forEach([&f](const K &key, const Empty &) { f(key); });
+    }
+
+private:
+    struct Empty
+    {
+    };
+
+    FlatHashMap<K, Empty, Hash> m_map;
+};
+
+}
+
+#endif
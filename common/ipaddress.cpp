@@ -5,24 +5,337 @@
 
 using namespace swss;
 
-IpAddress::IpAddress(uint32_t ip)
+constexpr size_t IpAddress::MAX_STRING_SIZE;
+
+/* Value of a hex digit, or -1 */
+static inline int hexDigit(char c)
 {
-    m_ip.family = AF_INET;
-    m_ip.ip_addr.ipv4_addr = ip;
+    unsigned int d = static_cast<unsigned int>(static_cast<unsigned char>(c)) - '0';
+    if (d < 10)
+        return static_cast<int>(d);
+
+    d = (static_cast<unsigned int>(static_cast<unsigned char>(c)) | 0x20) - 'a';
+    if (d < 6)
+        return static_cast<int>(d + 10);
+
+    return -1;
 }
 
-IpAddress::IpAddress(const std::string &ipStr)
+/* Same rules as inet_pton(AF_INET): four decimal octets, no leading zeros */
+static bool parseV4(const char *src, const char *end, uint8_t *dst)
+{
+    uint8_t tmp[4];
+    unsigned int octets = 0;
+    unsigned int value = 0;
+    bool sawDigit = false;
+
+    while (src < end)
+    {
+        char ch = *src++;
+
+        if (ch >= '0' && ch <= '9')
+        {
+            if (sawDigit && value == 0)
+                return false;
+
+            value = value * 10 + static_cast<unsigned int>(ch - '0');
+            if (value > 255)
+                return false;
+
+            if (!sawDigit)
+            {
+                if (++octets > 4)
+                    return false;
+                sawDigit = true;
+            }
+        }
+        else if (ch == '.' && sawDigit)
+        {
+            if (octets == 4)
+                return false;
+
+            tmp[octets - 1] = static_cast<uint8_t>(value);
+            value = 0;
+            sawDigit = false;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (octets < 4 || !sawDigit)
+        return false;
+
+    tmp[3] = static_cast<uint8_t>(value);
+    memcpy(dst, tmp, sizeof(tmp));
+    return true;
+}
+
+/* Same rules as inet_pton(AF_INET6), including a trailing dotted quad */
+static bool parseV6(const char *src, const char *end, uint8_t *dst)
+{
+    uint8_t tmp[16] = { 0 };
+    uint8_t *tp = tmp;
+    uint8_t *endp = tmp + sizeof(tmp);
+    uint8_t *colonp = NULL;
+
+    if (src == end)
+        return false;
+
+    /* Leading :: requires some special handling */
+    if (*src == ':')
+    {
+        ++src;
+        if (src == end || *src != ':')
+            return false;
+    }
+
+    const char *curtok = src;
+    unsigned int digits = 0;
+    unsigned int value = 0;
+
+    while (src < end)
+    {
+        char ch = *src++;
+        int digit = hexDigit(ch);
+
+        if (digit >= 0)
+        {
+            if (digits == 4)
+                return false;
+
+            value = (value << 4) | static_cast<unsigned int>(digit);
+            ++digits;
+            continue;
+        }
+
+        if (ch == ':')
+        {
+            curtok = src;
+            if (digits == 0)
+            {
+                if (colonp)
+                    return false;
+
+                colonp = tp;
+                continue;
+            }
+            else if (src == end)
+            {
+                return false;
+            }
+
+            if (tp + 2 > endp)
+                return false;
+
+            *tp++ = static_cast<uint8_t>(value >> 8);
+            *tp++ = static_cast<uint8_t>(value);
+            digits = 0;
+            value = 0;
+            continue;
+        }
+
+        if (ch == '.' && tp + 4 <= endp && parseV4(curtok, end, tp))
+        {
+            tp += 4;
+            digits = 0;
+            break;
+        }
+
+        return false;
+    }
+
+    if (digits > 0)
+    {
+        if (tp + 2 > endp)
+            return false;
+
+        *tp++ = static_cast<uint8_t>(value >> 8);
+        *tp++ = static_cast<uint8_t>(value);
+    }
+
+    if (colonp != NULL)
+    {
+        /* :: would expand to a zero-width field */
+        if (tp == endp)
+            return false;
+
+        size_t n = static_cast<size_t>(tp - colonp);
+        memmove(endp - n, colonp, n);
+        memset(colonp, 0, static_cast<size_t>(endp - n - colonp));
+        tp = endp;
+    }
+
+    if (tp != endp)
+        return false;
+
+    memcpy(dst, tmp, sizeof(tmp));
+    return true;
+}
+
+static inline char *formatOctet(char *p, unsigned int value)
+{
+    if (value >= 100)
+    {
+        *p++ = static_cast<char>('0' + value / 100);
+        value %= 100;
+        *p++ = static_cast<char>('0' + value / 10);
+    }
+    else if (value >= 10)
+    {
+        *p++ = static_cast<char>('0' + value / 10);
+    }
+
+    *p++ = static_cast<char>('0' + value % 10);
+    return p;
+}
+
+static char *formatV4(char *p, const uint8_t *src)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (i)
+            *p++ = '.';
+        p = formatOctet(p, src[i]);
+    }
+
+    return p;
+}
+
+/* Same output as inet_ntop(AF_INET6) */
+static char *formatV6(char *p, const uint8_t *src)
 {
-    if (ipStr.find(':') != std::string::npos)
+    static const char hex[] = "0123456789abcdef";
+    unsigned int words[8];
+
+    for (int i = 0; i < 8; i++)
     {
-        m_ip.family = AF_INET6;
+        words[i] = (static_cast<unsigned int>(src[2 * i]) << 8) | src[2 * i + 1];
+    }
+
+    /* Find the first longest run of zero words, worth compressing from 2 */
+    int bestBase = -1, bestLen = 0;
+    int curBase = -1, curLen = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        if (words[i] == 0)
+        {
+            if (curBase == -1)
+            {
+                curBase = i;
+                curLen = 1;
+            }
+            else
+            {
+                curLen++;
+            }
+        }
+        else if (curBase != -1)
+        {
+            if (curLen > bestLen)
+            {
+                bestBase = curBase;
+                bestLen = curLen;
+            }
+            curBase = -1;
+        }
+    }
+
+    if (curBase != -1 && curLen > bestLen)
+    {
+        bestBase = curBase;
+        bestLen = curLen;
+    }
+
+    if (bestLen < 2)
+        bestBase = -1;
+
+    for (int i = 0; i < 8; i++)
+    {
+        if (bestBase != -1 && i >= bestBase && i < bestBase + bestLen)
+        {
+            if (i == bestBase)
+                *p++ = ':';
+            continue;
+        }
+
+        if (i != 0)
+            *p++ = ':';
+
+        /* IPv4-compatible and IPv4-mapped addresses end with a dotted quad */
+        if (i == 6 && bestBase == 0 && (bestLen == 6 || (bestLen == 5 && words[5] == 0xffff)))
+            return formatV4(p, src + 12);
+
+        unsigned int w = words[i];
+        if (w >= 0x1000)
+            *p++ = hex[w >> 12];
+        if (w >= 0x100)
+            *p++ = hex[(w >> 8) & 0xf];
+        if (w >= 0x10)
+            *p++ = hex[(w >> 4) & 0xf];
+        *p++ = hex[w & 0xf];
+    }
+
+    /* Trailing run of zeros */
+    if (bestBase != -1 && bestBase + bestLen == 8)
+        *p++ = ':';
+
+    return p;
+}
+
+bool IpAddress::parse(const char *str, size_t len, IpAddress &ip)
+{
+    ip_addr_t addr;
+
+    if (memchr(str, ':', len) != NULL)
+    {
+        addr.family = AF_INET6;
+        if (!parseV6(str, str + len, addr.ip_addr.ipv6_addr))
+            return false;
     }
     else
     {
-        m_ip.family = AF_INET;
+        addr.family = AF_INET;
+        if (!parseV4(str, str + len, reinterpret_cast<uint8_t *>(&addr.ip_addr.ipv4_addr)))
+            return false;
     }
 
-    if (inet_pton(m_ip.family, ipStr.c_str(), &m_ip.ip_addr) != 1)
+    ip.m_ip = addr;
+    return true;
+}
+
+size_t IpAddress::to_string(char *buf, size_t size) const
+{
+    char tmp[MAX_STRING_SIZE];
+    char *end;
+
+    if (m_ip.family == AF_INET)
+        end = formatV4(tmp, reinterpret_cast<const uint8_t *>(&m_ip.ip_addr.ipv4_addr));
+    else if (m_ip.family == AF_INET6)
+        end = formatV6(tmp, m_ip.ip_addr.ipv6_addr);
+    else
+        return 0;
+
+    size_t len = static_cast<size_t>(end - tmp);
+    if (len >= size)
+        return 0;
+
+    memcpy(buf, tmp, len);
+    buf[len] = '\0';
+    return len;
+}
+
+IpAddress::IpAddress(uint32_t ip)
+{
+    m_ip.family = AF_INET;
+    m_ip.ip_addr.ipv4_addr = ip;
+}
+
+IpAddress::IpAddress(const std::string &ipStr)
+{
+    if (!parse(ipStr.data(), ipStr.size(), *this))
     {
         std::string err = "Error converting " + ipStr + " to IP address";
         throw std::invalid_argument(err);
@@ -31,11 +344,15 @@ IpAddress::IpAddress(const std::string &ipStr)
 
 std::string IpAddress::to_string() const
 {
-    char buf[INET6_ADDRSTRLEN];
+    char buf[MAX_STRING_SIZE];
 
-    std::string ipStr(inet_ntop(m_ip.family, &m_ip.ip_addr, buf, INET6_ADDRSTRLEN));
+    size_t len = to_string(buf, sizeof(buf));
+    if (len == 0)
+    {
+        throw std::logic_error("Invalid family");
+    }
 
-    return ipStr;
+    return std::string(buf, len);
 }
 
 IpAddress::AddrScope IpAddress::getAddrScope() const
@@ -4,7 +4,9 @@
 #include <stdint.h>
 #include <string.h>
 #include <string>
+#include <functional>
 #include <netinet/in.h>
+#include <arpa/inet.h>
 
 namespace swss {
 
@@ -19,11 +21,20 @@ struct ip_addr_t {
 class IpAddress
 {
 public:
+    /* Buffer size fitting any address string and its terminating null */
+    static constexpr size_t MAX_STRING_SIZE = INET6_ADDRSTRLEN;
+
     IpAddress() = default;
     IpAddress(const ip_addr_t &ip) : m_ip(ip) {}
     IpAddress(uint32_t ip);
     IpAddress(const std::string &ipStr);
 
+    /*
+     * Parse the len characters at str, with the rules of inet_pton. Does not
+     * allocate nor throw, ip is left untouched on failure.
+     */
+    static bool parse(const char *str, size_t len, IpAddress &ip);
+
     inline bool isV4() const
     {
         return m_ip.family == AF_INET;
@@ -77,8 +88,44 @@ public:
         return (! (*this == o) );
     }
 
+    /*
+     * Canonical 128 bit form, most significant bits in hi. IPv4 addresses
+     * use the IPv4-mapped IPv6 form ::ffff:a.b.c.d.
+     */
+    inline void getKey(uint64_t &hi, uint64_t &lo) const
+    {
+        if (m_ip.family == AF_INET)
+        {
+            hi = 0;
+            lo = 0xFFFF00000000ULL | ntohl(m_ip.ip_addr.ipv4_addr);
+            return;
+        }
+
+        hi = lo = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            hi = (hi << 8) | m_ip.ip_addr.ipv6_addr[i];
+            lo = (lo << 8) | m_ip.ip_addr.ipv6_addr[i + 8];
+        }
+    }
+
+    inline size_t hash() const
+    {
+        uint64_t hi, lo;
+        getKey(hi, lo);
+
+        /* Keep IPv4 apart from the same IPv4-mapped IPv6 address */
+        return static_cast<size_t>((hi * 0x9E3779B97F4A7C15ULL) ^ lo ^ m_ip.family);
+    }
+
     std::string to_string() const;
 
+    /*
+     * Write the same string as to_string() and a terminating null into buf.
+     * Returns the string length, or 0 when it does not fit in size bytes.
+     */
+    size_t to_string(char *buf, size_t size) const;
+
     enum AddrScope {
         GLOBAL_SCOPE,
         LINK_SCOPE,
@@ -94,4 +141,17 @@ private:
 
 }
 
+namespace std {
+
+template<>
+struct hash<swss::IpAddress>
+{
+    size_t operator()(const swss::IpAddress &ip) const
+    {
+        return ip.hash();
+    }
+};
+
+}
+
 #endif
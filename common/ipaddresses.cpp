@@ -10,9 +10,16 @@ using namespace swss;
 
 IpAddresses::IpAddresses(const string &ipsStr)
 {
-    auto ips = tokenize(ipsStr, IP_DELIMITER);
-    for (const auto &ip : ips)
+    Tokenizer tokenizer(ipsStr, IP_DELIMITER);
+    StringRef tok;
+    IpAddress ip;
+
+    while (tokenizer.next(tok))
+    {
+        if (!IpAddress::parse(tok.data(), tok.size(), ip))
+            throw invalid_argument("Error converting " + tok.str() + " to IP address");
         m_ips.insert(ip);
+    }
 }
 
 void IpAddresses::add(const string &ipStr)
@@ -6,9 +6,64 @@
 
 using namespace swss;
 
+constexpr size_t IpPrefix::MAX_STRING_SIZE;
+
+/*
+ * Mask length with the rules of std::stoi: leading white space, an optional
+ * sign and at least one digit, anything after the digits is ignored.
+ */
+static bool parseMaskLength(const char *str, const char *end, int &mask)
+{
+    while (str < end && (*str == ' ' || (*str >= '\t' && *str <= '\r')))
+        str++;
+
+    bool negative = false;
+    if (str < end && (*str == '+' || *str == '-'))
+        negative = (*str++ == '-');
+
+    if (str == end || *str < '0' || *str > '9')
+        return false;
+
+    /* Any length above 128 is invalid, stop counting there */
+    int value = 0;
+    while (str < end && *str >= '0' && *str <= '9')
+    {
+        if (value <= 128)
+            value = value * 10 + (*str - '0');
+        str++;
+    }
+
+    mask = negative ? -value : value;
+    return true;
+}
+
+bool IpPrefix::parse(const char *str, size_t len, IpPrefix &prefix)
+{
+    const char *slash = static_cast<const char *>(memchr(str, '/', len));
+    size_t ipLen = slash ? static_cast<size_t>(slash - str) : len;
+
+    IpPrefix parsed;
+    if (ipLen == 0)
+        parsed.m_ip = IpAddress(0);
+    else if (!IpAddress::parse(str, ipLen, parsed.m_ip))
+        return false;
+
+    if (slash == NULL)
+        parsed.m_mask = parsed.m_ip.isV4() ? 32 : 128;
+    else if (!parseMaskLength(slash + 1, str + len, parsed.m_mask) || !parsed.isValid())
+        return false;
+
+    prefix = parsed;
+    return true;
+}
+
 IpPrefix::IpPrefix(
     const std::string &ipPrefixStr)
 {
+    /* Fast path, the slow one only runs to report why the string is invalid */
+    if (parse(ipPrefixStr.data(), ipPrefixStr.size(), *this))
+        return;
+
     size_t pos = ipPrefixStr.find('/');
     std::string ipStr = ipPrefixStr.substr(0, pos);
     if (ipStr.empty())
@@ -53,6 +108,14 @@ IpPrefix::IpPrefix(uint32_t ipPrefix, int mask) : m_ip(ipPrefix), m_mask(mask)
     }
 }
 
+IpPrefix::IpPrefix(const ip_addr_t &ip, int mask) : m_ip(ip), m_mask(mask)
+{
+    if (!isValid())
+    {
+        throw std::invalid_argument("Invalid IpPrefix from address and mask");
+    }
+}
+
 bool IpPrefix::isValid()
 {
     if (m_mask < 0) return false;
@@ -79,5 +142,36 @@ bool IpPrefix::isValid()
 
 std::string IpPrefix::to_string() const
 {
-    return (m_ip.to_string() + "/" + std::to_string(m_mask));
+    char buf[MAX_STRING_SIZE];
+
+    size_t len = to_string(buf, sizeof(buf));
+    if (len == 0)
+    {
+        throw std::logic_error("Invalid family");
+    }
+
+    return std::string(buf, len);
+}
+
+size_t IpPrefix::to_string(char *buf, size_t size) const
+{
+    char tmp[MAX_STRING_SIZE];
+
+    size_t len = m_ip.to_string(tmp, sizeof(tmp));
+    if (len == 0 || m_mask < 0 || m_mask > 128)
+        return 0;
+
+    tmp[len++] = '/';
+    if (m_mask >= 100)
+        tmp[len++] = static_cast<char>('0' + m_mask / 100);
+    if (m_mask >= 10)
+        tmp[len++] = static_cast<char>('0' + (m_mask / 10) % 10);
+    tmp[len++] = static_cast<char>('0' + m_mask % 10);
+
+    if (len >= size)
+        return 0;
+
+    memcpy(buf, tmp, len);
+    buf[len] = '\0';
+    return len;
 }
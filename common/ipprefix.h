@@ -11,9 +11,19 @@ namespace swss {
 class IpPrefix
 {
 public:
+    /* Buffer size fitting any prefix string and its terminating null */
+    static constexpr size_t MAX_STRING_SIZE = IpAddress::MAX_STRING_SIZE + 4;
+
     IpPrefix() = default;
     IpPrefix(const std::string &ipPrefixStr);
     IpPrefix(uint32_t addr, int mask);
+    IpPrefix(const ip_addr_t &ip, int mask);
+
+    /*
+     * Parse the len characters at str like the string constructor does,
+     * without allocating nor throwing. prefix is left untouched on failure.
+     */
+    static bool parse(const char *str, size_t len, IpPrefix &prefix);
 
     inline bool isV4() const
     {
@@ -198,8 +208,35 @@ public:
         return m_ip == o.m_ip && m_mask == o.m_mask;
     }
 
+    /*
+     * Canonical packed form, the 128 bit key of the address as given by
+     * IpAddress::getKey() and the mask length.
+     */
+    inline void getKey(uint64_t &hi, uint64_t &lo, uint8_t &len) const
+    {
+        m_ip.getKey(hi, lo);
+        len = static_cast<uint8_t>(m_mask);
+    }
+
+    inline size_t hash() const
+    {
+        uint64_t hi, lo;
+        uint8_t len;
+        getKey(hi, lo, len);
+
+        /* Above the 48 bits of a mapped IPv4 address, folded for 32 bit size_t */
+        uint64_t h = (hi * 0x9E3779B97F4A7C15ULL) ^ lo ^ (static_cast<uint64_t>(len) << 48) ^ m_ip.getIp().family;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
     std::string to_string() const;
 
+    /*
+     * Write the same string as to_string() and a terminating null into buf.
+     * Returns the string length, or 0 when it does not fit in size bytes.
+     */
+    size_t to_string(char *buf, size_t size) const;
+
 private:
     bool isValid();
 
@@ -209,4 +246,17 @@ private:
 
 }
 
+namespace std {
+
+template<>
+struct hash<swss::IpPrefix>
+{
+    size_t operator()(const swss::IpPrefix &prefix) const
+    {
+        return prefix.hash();
+    }
+};
+
+}
+
 #endif
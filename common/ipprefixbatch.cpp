@@ -0,0 +1,231 @@
+#include <stdexcept>
+
+#include "ipprefixbatch.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace swss;
+
+static inline PackedIpV6 maskV6(const PackedIpV6 &ip, const PackedIpV6 &mask)
+{
+    PackedIpV6 net;
+    net.w[0] = ip.w[0] & mask.w[0];
+    net.w[1] = ip.w[1] & mask.w[1];
+    return net;
+}
+
+static inline uint8_t inV6(const PackedIpV6 &ip, const PackedIpV6 &net, const PackedIpV6 &mask)
+{
+    return static_cast<uint8_t>(((ip.w[0] & mask.w[0]) == net.w[0]) & ((ip.w[1] & mask.w[1]) == net.w[1]));
+}
+
+#ifdef __SSE2__
+
+/* 16 results of 32 bit lane compares as 0 or 1 bytes, returns how many are 1 */
+static inline size_t storeMatches(__m128i a, __m128i b, __m128i c, __m128i d, uint8_t *result)
+{
+    __m128i bytes = _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(result), _mm_and_si128(bytes, _mm_set1_epi8(1)));
+
+    return static_cast<size_t>(__builtin_popcount(static_cast<unsigned int>(_mm_movemask_epi8(bytes))));
+}
+
+static inline uint8_t inV6(__m128i ip, __m128i net, __m128i mask)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(ip, mask), net)) == 0xFFFF;
+}
+
+#endif
+
+IpPrefixMatcher::IpPrefixMatcher(const IpPrefix &prefix) :
+    m_v4(prefix.isV4()), m_net4(0), m_mask4(0)
+{
+    IpAddress mask = prefix.getMask();
+
+    if (m_v4)
+    {
+        m_mask4 = mask.getV4Addr();
+        m_net4 = prefix.getIp().getV4Addr() & m_mask4;
+        memset(&m_mask6, 0, sizeof(m_mask6));
+        memset(&m_net6, 0, sizeof(m_net6));
+    }
+    else
+    {
+        m_mask6 = PackedIpV6::pack(mask);
+        m_net6 = maskV6(PackedIpV6::pack(prefix.getIp()), m_mask6);
+    }
+}
+
+size_t IpPrefixMatcher::match(const uint32_t *addrs, size_t count, uint8_t *result) const
+{
+    if (!m_v4)
+    {
+        memset(result, 0, count);
+        return 0;
+    }
+
+    size_t matched = 0;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128i net = _mm_set1_epi32(static_cast<int>(m_net4));
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(m_mask4));
+
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i *p = reinterpret_cast<const __m128i *>(addrs + i);
+        __m128i a = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(p), mask), net);
+        __m128i b = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(p + 1), mask), net);
+        __m128i c = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(p + 2), mask), net);
+        __m128i d = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(p + 3), mask), net);
+
+        matched += storeMatches(a, b, c, d, result + i);
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        uint8_t in = (addrs[i] & m_mask4) == m_net4;
+        result[i] = in;
+        matched += in;
+    }
+
+    return matched;
+}
+
+size_t IpPrefixMatcher::match(const PackedIpV6 *addrs, size_t count, uint8_t *result) const
+{
+    if (m_v4)
+    {
+        memset(result, 0, count);
+        return 0;
+    }
+
+    size_t matched = 0;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128i net = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&m_net6));
+    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&m_mask6));
+
+    for (; i < count; i++)
+    {
+        uint8_t in = inV6(_mm_loadu_si128(reinterpret_cast<const __m128i *>(addrs + i)), net, mask);
+        result[i] = in;
+        matched += in;
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        uint8_t in = inV6(addrs[i], m_net6, m_mask6);
+        result[i] = in;
+        matched += in;
+    }
+
+    return matched;
+}
+
+PackedPrefixes::PackedPrefixes(bool v4) : m_v4(v4)
+{
+}
+
+void PackedPrefixes::add(const IpPrefix &prefix)
+{
+    if (prefix.isV4() != m_v4)
+    {
+        throw std::invalid_argument("Prefix family differs from the packed prefixes one");
+    }
+
+    IpAddress mask = prefix.getMask();
+
+    if (m_v4)
+    {
+        m_masks4.push_back(mask.getV4Addr());
+        m_nets4.push_back(prefix.getIp().getV4Addr() & mask.getV4Addr());
+    }
+    else
+    {
+        m_masks6.push_back(PackedIpV6::pack(mask));
+        m_nets6.push_back(maskV6(PackedIpV6::pack(prefix.getIp()), m_masks6.back()));
+    }
+}
+
+void PackedPrefixes::clear()
+{
+    m_nets4.clear();
+    m_masks4.clear();
+    m_nets6.clear();
+    m_masks6.clear();
+}
+
+size_t PackedPrefixes::findContaining(const IpAddress &addr, uint8_t *result) const
+{
+    size_t count = size();
+
+    if (addr.isV4() != m_v4)
+    {
+        memset(result, 0, count);
+        return 0;
+    }
+
+    size_t matched = 0;
+    size_t i = 0;
+
+    if (m_v4)
+    {
+        uint32_t ip = addr.getV4Addr();
+        const uint32_t *nets = m_nets4.data();
+        const uint32_t *masks = m_masks4.data();
+
+#ifdef __SSE2__
+        const __m128i vip = _mm_set1_epi32(static_cast<int>(ip));
+
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i *n = reinterpret_cast<const __m128i *>(nets + i);
+            const __m128i *m = reinterpret_cast<const __m128i *>(masks + i);
+            __m128i a = _mm_cmpeq_epi32(_mm_and_si128(vip, _mm_loadu_si128(m)), _mm_loadu_si128(n));
+            __m128i b = _mm_cmpeq_epi32(_mm_and_si128(vip, _mm_loadu_si128(m + 1)), _mm_loadu_si128(n + 1));
+            __m128i c = _mm_cmpeq_epi32(_mm_and_si128(vip, _mm_loadu_si128(m + 2)), _mm_loadu_si128(n + 2));
+            __m128i d = _mm_cmpeq_epi32(_mm_and_si128(vip, _mm_loadu_si128(m + 3)), _mm_loadu_si128(n + 3));
+
+            matched += storeMatches(a, b, c, d, result + i);
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            uint8_t in = (ip & masks[i]) == nets[i];
+            result[i] = in;
+            matched += in;
+        }
+
+        return matched;
+    }
+
+    PackedIpV6 ip = PackedIpV6::pack(addr);
+
+#ifdef __SSE2__
+    const __m128i vip = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&ip));
+
+    for (; i < count; i++)
+    {
+        uint8_t in = inV6(vip, _mm_loadu_si128(reinterpret_cast<const __m128i *>(&m_nets6[i])),
+                          _mm_loadu_si128(reinterpret_cast<const __m128i *>(&m_masks6[i])));
+        result[i] = in;
+        matched += in;
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        uint8_t in = inV6(ip, m_nets6[i], m_masks6[i]);
+        result[i] = in;
+        matched += in;
+    }
+
+    return matched;
+}
@@ -0,0 +1,93 @@
+#ifndef __IPPREFIXBATCH__
+#define __IPPREFIXBATCH__
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "ipprefix.h"
+
+namespace swss {
+
+/* IPv6 address bytes in network order, loaded as two words for masking */
+struct PackedIpV6
+{
+    uint64_t w[2];
+
+    static inline PackedIpV6 pack(const IpAddress &ip)
+    {
+        PackedIpV6 packed;
+        memcpy(packed.w, ip.getV6Addr(), sizeof(packed.w));
+        return packed;
+    }
+};
+
+/*
+ * Prefix with its mask computed once, matched against arrays of packed
+ * addresses: IPv4 as uint32_t in network order like IpAddress::getV4Addr(),
+ * IPv6 as PackedIpV6. Uses SSE2 compare kernels when available.
+ */
+class IpPrefixMatcher
+{
+public:
+    IpPrefixMatcher(const IpPrefix &prefix);
+
+    inline bool isV4() const
+    {
+        return m_v4;
+    }
+
+    /*
+     * Set result[i] to 1 when addrs[i] is in the prefix and to 0 otherwise.
+     * Returns the number of addresses in the prefix, 0 for a prefix of the
+     * other family.
+     */
+    size_t match(const uint32_t *addrs, size_t count, uint8_t *result) const;
+    size_t match(const PackedIpV6 *addrs, size_t count, uint8_t *result) const;
+
+private:
+    bool m_v4;
+    uint32_t m_net4;
+    uint32_t m_mask4;
+    PackedIpV6 m_net6;
+    PackedIpV6 m_mask6;
+};
+
+/*
+ * Prefixes of one family packed with their masks, to find the ones which
+ * contain an address.
+ */
+class PackedPrefixes
+{
+public:
+    PackedPrefixes(bool v4);
+
+    /* Throws std::invalid_argument for a prefix of the other family */
+    void add(const IpPrefix &prefix);
+
+    inline size_t size() const
+    {
+        return m_v4 ? m_nets4.size() : m_nets6.size();
+    }
+
+    void clear();
+
+    /*
+     * Set result[i], for each of the size() prefixes in insertion order, to
+     * 1 when the prefix contains addr and to 0 otherwise. Returns the number
+     * of prefixes containing addr, 0 for an address of the other family.
+     */
+    size_t findContaining(const IpAddress &addr, uint8_t *result) const;
+
+private:
+    bool m_v4;
+
+    /* Networks and masks in separate arrays so both are loaded by vector */
+    std::vector<uint32_t> m_nets4;
+    std::vector<uint32_t> m_masks4;
+    std::vector<PackedIpV6> m_nets6;
+    std::vector<PackedIpV6> m_masks6;
+};
+
+}
+
+#endif
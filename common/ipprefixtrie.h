@@ -0,0 +1,525 @@
+#ifndef __IPPREFIXTRIE__
+#define __IPPREFIXTRIE__
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
+#include "ipprefix.h"
+
+namespace swss {
+
+/*
+ * Path compressed binary trie of IpPrefix to T, holding IPv4 and IPv6
+ * prefixes side by side.
+ *
+ * Nodes are 32 byte records in one vector, linked by 32 bit indexes, and
+ * only exist where prefixes branch, so a lookup visits at most one node per
+ * distinct prefix length on the path. Values are kept densely in a
+ * separate vector. Host bits of inserted prefixes are ignored.
+ *
+ * Pointers returned by find() and longestMatch() are valid until the next
+ * insert() or erase().
+ */
+template<typename T>
+class IpPrefixTrie
+{
+public:
+    IpPrefixTrie()
+    {
+        m_root[0] = m_root[1] = NONE;
+    }
+
+    size_t size() const
+    {
+        return m_entries.size();
+    }
+
+    bool empty() const
+    {
+        return m_entries.empty();
+    }
+
+    void clear()
+    {
+        m_nodes.clear();
+        m_freeNodes.clear();
+        m_entries.clear();
+        m_root[0] = m_root[1] = NONE;
+    }
+
+    /* Insert or replace the value of prefix, returns true when the prefix was added */
+    bool insert(const IpPrefix &prefix, const T &value)
+    {
+        Key key;
+        uint8_t len;
+        int root = toKey(prefix, key, len);
+
+        uint32_t parent = NONE;
+        int side = 0;
+        uint32_t cur = m_root[root];
+
+        while (cur != NONE)
+        {
+            const Node &n = m_nodes[cur];
+            uint8_t common = commonLength(key, n.key, len < n.len ? len : n.len);
+
+            if (common == n.len && common == len)
+            {
+                if (n.entry != NONE)
+                {
+                    m_entries[n.entry].value = value;
+                    return false;
+                }
+
+                m_nodes[cur].entry = addEntry(prefix, value, cur);
+                return true;
+            }
+
+            if (common == n.len)
+            {
+                parent = cur;
+                side = bit(key, n.len);
+                cur = n.child[side];
+                continue;
+            }
+
+            /* The new prefix branches off above cur */
+            uint32_t added = allocNode(key, len);
+            m_nodes[added].entry = addEntry(prefix, value, added);
+
+            if (common == len)
+            {
+                m_nodes[added].child[bit(m_nodes[cur].key, len)] = cur;
+                link(root, parent, side, added);
+                return true;
+            }
+
+            uint32_t branch = allocNode(key, common);
+            m_nodes[branch].child[bit(key, common)] = added;
+            m_nodes[branch].child[bit(m_nodes[cur].key, common)] = cur;
+            link(root, parent, side, branch);
+            return true;
+        }
+
+        uint32_t added = allocNode(key, len);
+        m_nodes[added].entry = addEntry(prefix, value, added);
+        link(root, parent, side, added);
+        return true;
+    }
+
+    /* Returns false when the prefix was not in the trie */
+    bool erase(const IpPrefix &prefix)
+    {
+        Key key;
+        uint8_t len;
+        int root = toKey(prefix, key, len);
+
+        uint32_t grandParent = NONE;
+        int parentSide = 0;
+        uint32_t parent = NONE;
+        int side = 0;
+        uint32_t cur = findNode(root, key, len, grandParent, parentSide, parent, side);
+
+        if (cur == NONE || m_nodes[cur].entry == NONE)
+            return false;
+
+        removeEntry(m_nodes[cur].entry);
+        m_nodes[cur].entry = NONE;
+
+        /* Drop nodes which no longer carry a value or a branch */
+        uint32_t child = collapse(cur);
+        if (child == cur)
+            return true;
+
+        link(root, parent, side, child);
+
+        if (child == NONE && parent != NONE && m_nodes[parent].entry == NONE)
+        {
+            uint32_t other = collapse(parent);
+            if (other != parent)
+                link(root, grandParent, parentSide, other);
+        }
+
+        return true;
+    }
+
+    /* Exact match */
+    T *find(const IpPrefix &prefix)
+    {
+        const IpPrefixTrie *self = this;
+        return const_cast<T *>(self->find(prefix));
+    }
+
+    const T *find(const IpPrefix &prefix) const
+    {
+        Key key;
+        uint8_t len;
+        int root = toKey(prefix, key, len);
+
+        uint32_t grandParent, parent;
+        int parentSide, side;
+        uint32_t cur = findNode(root, key, len, grandParent, parentSide, parent, side);
+
+        if (cur == NONE || m_nodes[cur].entry == NONE)
+            return nullptr;
+
+        return &m_entries[m_nodes[cur].entry].value;
+    }
+
+    /* Longest prefix containing addr, matched is set to it when not null */
+    T *longestMatch(const IpAddress &addr, IpPrefix *matched = nullptr)
+    {
+        const IpPrefixTrie *self = this;
+        return const_cast<T *>(self->longestMatch(addr, matched));
+    }
+
+    const T *longestMatch(const IpAddress &addr, IpPrefix *matched = nullptr) const
+    {
+        Key key;
+        uint8_t len;
+        int root = toKey(addr.getIp(), key, len);
+
+        uint32_t best = NONE;
+        uint32_t cur = m_root[root];
+
+        while (cur != NONE)
+        {
+            const Node &n = m_nodes[cur];
+            if (commonLength(key, n.key, n.len) != n.len)
+                break;
+
+            if (n.entry != NONE)
+                best = n.entry;
+
+            if (n.len == len)
+                break;
+
+            cur = n.child[bit(key, n.len)];
+        }
+
+        if (best == NONE)
+            return nullptr;
+
+        if (matched)
+            *matched = m_entries[best].prefix;
+
+        return &m_entries[best].value;
+    }
+
+    /*
+     * Call f(const IpPrefix &, const T &) for the prefixes containing
+     * prefix, including itself, from the shortest to the longest.
+     */
+    template<typename F>
+    void forEachCovering(const IpPrefix &prefix, F f) const
+    {
+        Key key;
+        uint8_t len;
+        int root = toKey(prefix, key, len);
+
+        uint32_t cur = m_root[root];
+
+        while (cur != NONE)
+        {
+            const Node &n = m_nodes[cur];
+            if (n.len > len || commonLength(key, n.key, n.len) != n.len)
+                break;
+
+            if (n.entry != NONE)
+                f(m_entries[n.entry].prefix, m_entries[n.entry].value);
+
+            if (n.len == len)
+                break;
+
+            cur = n.child[bit(key, n.len)];
+        }
+    }
+
+    /*
+     * Call f(const IpPrefix &, const T &) for the prefixes contained in
+     * prefix, including itself, in address order with a prefix before the
+     * more specific ones.
+     */
+    template<typename F>
+    void forEachCovered(const IpPrefix &prefix, F f) const
+    {
+        Key key;
+        uint8_t len;
+        int root = toKey(prefix, key, len);
+
+        uint32_t cur = m_root[root];
+
+        while (cur != NONE)
+        {
+            const Node &n = m_nodes[cur];
+            uint8_t limit = len < n.len ? len : n.len;
+            if (commonLength(key, n.key, limit) != limit)
+                return;
+
+            if (n.len >= len)
+            {
+                walk(cur, f);
+                return;
+            }
+
+            cur = n.child[bit(key, n.len)];
+        }
+    }
+
+    /* Call f(const IpPrefix &, const T &) for all IPv4 prefixes, then all IPv6 prefixes */
+    template<typename F>
+    void forEach(F f) const
+    {
+        walk(m_root[0], f);
+        walk(m_root[1], f);
+    }
+
+private:
+    static const uint32_t NONE = 0xFFFFFFFF;
+
+    /* Address bits from the most significant one, IPv4 uses the first 32 */
+    struct Key
+    {
+        uint64_t w[2];
+    };
+
+    struct Node
+    {
+        Key key;
+        uint32_t child[2];
+        uint32_t entry;
+        uint8_t len;
+    };
+
+    struct Entry
+    {
+        IpPrefix prefix;
+        T value;
+        uint32_t node;
+    };
+
+    static int bit(const Key &key, uint8_t pos)
+    {
+        return static_cast<int>((key.w[pos >> 6] >> (63 - (pos & 63))) & 1);
+    }
+
+    static uint64_t loadBe64(const unsigned char *p)
+    {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++)
+            v = (v << 8) | p[i];
+        return v;
+    }
+
+    static uint64_t maskWord(int bits)
+    {
+        if (bits <= 0)
+            return 0;
+        if (bits >= 64)
+            return ~0ULL;
+        return ~0ULL << (64 - bits);
+    }
+
+    /* Returns the root index of the family, the key is masked to len */
+    static int toKey(const ip_addr_t &ip, Key &key, uint8_t &len, int mask = -1)
+    {
+        int root;
+
+        if (ip.family == AF_INET)
+        {
+            key.w[0] = static_cast<uint64_t>(ntohl(ip.ip_addr.ipv4_addr)) << 32;
+            key.w[1] = 0;
+            len = 32;
+            root = 0;
+        }
+        else if (ip.family == AF_INET6)
+        {
+            key.w[0] = loadBe64(ip.ip_addr.ipv6_addr);
+            key.w[1] = loadBe64(ip.ip_addr.ipv6_addr + 8);
+            len = 128;
+            root = 1;
+        }
+        else
+        {
+            throw std::logic_error("Invalid family");
+        }
+
+        if (mask >= 0)
+        {
+            if (mask > len)
+                throw std::invalid_argument("Invalid prefix length");
+
+            len = static_cast<uint8_t>(mask);
+            key.w[0] &= maskWord(mask);
+            key.w[1] &= maskWord(mask - 64);
+        }
+
+        return root;
+    }
+
+    static int toKey(const IpPrefix &prefix, Key &key, uint8_t &len)
+    {
+        return toKey(prefix.getIp().getIp(), key, len, prefix.getMaskLength());
+    }
+
+    static IpPrefix toPrefix(const ip_addr_t &ip, const Key &key, uint8_t len)
+    {
+        ip_addr_t subnet;
+        subnet.family = ip.family;
+
+        if (ip.family == AF_INET)
+        {
+            subnet.ip_addr.ipv4_addr = htonl(static_cast<uint32_t>(key.w[0] >> 32));
+        }
+        else
+        {
+            for (int i = 0; i < 16; i++)
+                subnet.ip_addr.ipv6_addr[i] = static_cast<unsigned char>(key.w[i >> 3] >> (56 - 8 * (i & 7)));
+        }
+
+        return IpPrefix(subnet, len);
+    }
+
+    /* Number of leading bits, up to limit, equal in both keys */
+    static uint8_t commonLength(const Key &a, const Key &b, uint8_t limit)
+    {
+        uint64_t diff = a.w[0] ^ b.w[0];
+        int common;
+
+        if (diff)
+        {
+            common = __builtin_clzll(diff);
+        }
+        else
+        {
+            diff = a.w[1] ^ b.w[1];
+            common = diff ? 64 + __builtin_clzll(diff) : 128;
+        }
+
+        return common < limit ? static_cast<uint8_t>(common) : limit;
+    }
+
+    uint32_t findNode(int root, const Key &key, uint8_t len,
+                      uint32_t &grandParent, int &parentSide, uint32_t &parent, int &side) const
+    {
+        grandParent = parent = NONE;
+        parentSide = side = 0;
+        uint32_t cur = m_root[root];
+
+        while (cur != NONE)
+        {
+            const Node &n = m_nodes[cur];
+            if (n.len > len || commonLength(key, n.key, n.len) != n.len)
+                return NONE;
+
+            if (n.len == len)
+                return cur;
+
+            grandParent = parent;
+            parentSide = side;
+            parent = cur;
+            side = bit(key, n.len);
+            cur = n.child[side];
+        }
+
+        return NONE;
+    }
+
+    uint32_t allocNode(const Key &key, uint8_t len)
+    {
+        Node n;
+        n.key.w[0] = key.w[0] & maskWord(len);
+        n.key.w[1] = key.w[1] & maskWord(len - 64);
+        n.child[0] = n.child[1] = NONE;
+        n.entry = NONE;
+        n.len = len;
+
+        if (!m_freeNodes.empty())
+        {
+            uint32_t index = m_freeNodes.back();
+            m_freeNodes.pop_back();
+            m_nodes[index] = n;
+            return index;
+        }
+
+        m_nodes.push_back(n);
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+
+    void link(int root, uint32_t parent, int side, uint32_t node)
+    {
+        if (parent == NONE)
+            m_root[root] = node;
+        else
+            m_nodes[parent].child[side] = node;
+    }
+
+    /*
+     * Free node when it has no value and less than two children. Returns
+     * what should replace it in its parent, node itself when it is kept.
+     */
+    uint32_t collapse(uint32_t node)
+    {
+        const Node &n = m_nodes[node];
+        if (n.entry != NONE || (n.child[0] != NONE && n.child[1] != NONE))
+            return node;
+
+        uint32_t child = n.child[0] != NONE ? n.child[0] : n.child[1];
+        m_freeNodes.push_back(node);
+        return child;
+    }
+
+    uint32_t addEntry(const IpPrefix &prefix, const T &value, uint32_t node)
+    {
+        Entry e = { toPrefix(prefix.getIp().getIp(), m_nodes[node].key, m_nodes[node].len), value, node };
+        m_entries.push_back(e);
+        return static_cast<uint32_t>(m_entries.size() - 1);
+    }
+
+    /* Keep entries dense by moving the last one into the hole */
+    void removeEntry(uint32_t index)
+    {
+        uint32_t last = static_cast<uint32_t>(m_entries.size() - 1);
+        if (index != last)
+        {
+            m_entries[index] = std::move(m_entries[last]);
+            m_nodes[m_entries[index].node].entry = index;
+        }
+
+        m_entries.pop_back();
+    }
+
+    template<typename F>
+    void walk(uint32_t top, F &f) const
+    {
+        /* A path holds at most one node per prefix length */
+        uint32_t stack[130];
+        int depth = 0;
+
+        if (top != NONE)
+            stack[depth++] = top;
+
+        while (depth > 0)
+        {
+            const Node &n = m_nodes[stack[--depth]];
+
+            if (n.entry != NONE)
+                f(m_entries[n.entry].prefix, m_entries[n.entry].value);
+
+            if (n.child[1] != NONE)
+                stack[depth++] = n.child[1];
+            if (n.child[0] != NONE)
+                stack[depth++] = n.child[0];
+        }
+    }
+
+    uint32_t m_root[2];
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_freeNodes;
+    std::vector<Entry> m_entries;
+};
+
+}
+
+#endif
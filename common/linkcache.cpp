@@ -3,11 +3,18 @@
 #include <system_error>
 #include "common/logger.h"
 #include "common/linkcache.h"
+#include "common/netmsgview.h"
+
+#include <algorithm>
 
 using namespace std;
 using namespace swss;
 
-LinkCache::LinkCache()
+LinkCache::LinkCache() :
+    m_generation(0),
+    m_kernelLookup(true),
+    m_refillCount(0),
+    m_kernelLookupCount(0)
 {
     m_nl_sock = nl_socket_alloc();
     if (!m_nl_sock)
@@ -37,6 +44,8 @@ LinkCache::LinkCache()
         throw system_error(make_error_code(errc::address_not_available),
                            "Unable to connect netlink socket");
     }
+
+    rebuild();
 }
 
 LinkCache::~LinkCache()
@@ -56,26 +65,345 @@ LinkCache &LinkCache::getInstance()
 
 string LinkCache::ifindexToName(int ifindex)
 {
-#define MAX_ADDR_SIZE 128
-    char addrStr[MAX_ADDR_SIZE + 1] = {0};
+    string name;
+
+    if (lookup(ifindex, name))
+        return name;
+
+    /* Not known yet, filled by the RTM_NEWLINK to come */
+    if (!m_kernelLookup.load())
+        return to_string(ifindex);
+
+    /* Query only this link instead of refilling the cache */
+    struct rtnl_link *link = NULL;
+    {
+        lock_guard<mutex> lock(m_sockMutex);
+
+        m_kernelLookupCount++;
+        if (rtnl_link_get_kernel(m_nl_sock, ifindex, NULL, &link) < 0)
+            link = NULL;
+        else if (rtnl_link_get_name(link) != NULL)
+            cacheLink(link);
+    }
+
+    if (link == NULL || rtnl_link_get_name(link) == NULL)
+    {
+        if (link != NULL)
+            rtnl_link_put(link);
+
+        /* Returns ifindex as string / */
+        return to_string(ifindex);
+    }
+
+    name = rtnl_link_get_name(link);
+    rtnl_link_put(link);
+
+    setEntry(ifindex, name);
+    return name;
+}
+
+struct rtnl_link* LinkCache::getLinkByName(const char *name)
+{
+    int ifindex = lookupIfindex(name);
+    bool kernelLookup = m_kernelLookup.load();
+    struct rtnl_link *link = NULL;
+
+    if (ifindex <= 0 && !kernelLookup)
+        return NULL;
 
-    if (rtnl_link_i2name(m_link_cache, ifindex, addrStr, MAX_ADDR_SIZE) == NULL)
     {
-        /* Trying to refill cache */
-        nl_cache_refill(m_nl_sock ,m_link_cache);
-        if (rtnl_link_i2name(m_link_cache, ifindex,
-                             addrStr, MAX_ADDR_SIZE) == NULL)
+        lock_guard<mutex> lock(m_sockMutex);
+
+        if (ifindex > 0)
         {
-            /* Returns ifindex as string / */
-            return to_string(ifindex);
+            link = rtnl_link_get(m_link_cache, ifindex);
+            if (link != NULL && rtnl_link_get_name(link) != NULL && strcmp(rtnl_link_get_name(link), name) == 0)
+                return link;
+
+            if (link != NULL)
+                rtnl_link_put(link);
+
+            if (!kernelLookup)
+                return NULL;
         }
 
+        /* Created after the dump and not given to onMsg */
+        m_kernelLookupCount++;
+        if (rtnl_link_get_kernel(m_nl_sock, max(ifindex, 0), ifindex > 0 ? NULL : name, &link) < 0)
+            return NULL;
+
+        /* The ifindex was reused before the table saw the RTM_DELLINK */
+        if (rtnl_link_get_name(link) == NULL || strcmp(rtnl_link_get_name(link), name) != 0)
+        {
+            rtnl_link_put(link);
+            return NULL;
+        }
+
+        cacheLink(link);
     }
 
-    return string(addrStr);
+    setEntry(rtnl_link_get_ifindex(link), name);
+    return link;
 }
 
-struct rtnl_link* LinkCache::getLinkByName(const char *name)
+void LinkCache::updateLink(int ifindex, const string &name)
+{
+    if (ifindex <= 0 || name.empty())
+        return;
+
+    setEntry(ifindex, name);
+}
+
+void LinkCache::removeLink(int ifindex)
+{
+    clearEntry(ifindex);
+}
+
+void LinkCache::refill()
+{
+    {
+        lock_guard<mutex> lock(m_sockMutex);
+
+        int err = nl_cache_refill(m_nl_sock, m_link_cache);
+        if (err < 0)
+        {
+            SWSS_LOG_ERROR("Unable to refill link cache: %s", nl_geterror(err));
+            return;
+        }
+    }
+
+    rebuild();
+}
+
+void LinkCache::onMsg(int nlmsg_type, const struct nlmsghdr *hdr)
+{
+    LinkMsgView view(hdr);
+
+    if (!view.isValid())
+        return;
+
+    if (nlmsg_type == RTM_DELLINK)
+    {
+        removeLink(view.getIfindex());
+
+        lock_guard<mutex> lock(m_sockMutex);
+        uncacheLink(view.getIfindex());
+        return;
+    }
+
+    if (nlmsg_type != RTM_NEWLINK)
+        return;
+
+    /* Link messages without name only carry partial updates */
+    const char *name = view.getName();
+    if (name == NULL)
+        return;
+
+    updateLink(view.getIfindex(), name);
+
+    /* Link events are rare, the link object is kept for getLinkByName */
+    struct nl_msg *msg = nlmsg_convert(const_cast<struct nlmsghdr *>(hdr));
+    if (msg == NULL)
+        return;
+
+    nlmsg_set_proto(msg, NETLINK_ROUTE);
+    {
+        lock_guard<mutex> lock(m_sockMutex);
+        nl_msg_parse(msg, cacheParsedLink, this);
+    }
+    nlmsg_free(msg);
+}
+
+void LinkCache::onResyncBegin()
+{
+    lock_guard<mutex> lock(m_tableMutex);
+
+    m_generation++;
+}
+
+void LinkCache::onResyncEnd()
+{
+    vector<int> removed;
+
+    {
+        lock_guard<mutex> lock(m_tableMutex);
+
+        for (size_t ifindex = 0; ifindex < m_links.size(); ifindex++)
+        {
+            LinkEntry &entry = m_links[ifindex];
+            if (entry.generation != m_generation && !entry.name.empty())
+            {
+                eraseEntry(static_cast<int>(ifindex), entry);
+                removed.push_back(static_cast<int>(ifindex));
+            }
+        }
+
+        for (auto it = m_sparseLinks.begin(); it != m_sparseLinks.end();)
+        {
+            if (it->second.generation != m_generation)
+            {
+                eraseEntry(it->first, it->second);
+                removed.push_back(it->first);
+                it = m_sparseLinks.erase(it);
+            }
+            else
+                it++;
+        }
+    }
+
+    lock_guard<mutex> lock(m_sockMutex);
+
+    for (int ifindex : removed)
+    {
+        uncacheLink(ifindex);
+    }
+}
+
+bool LinkCache::lookup(int ifindex, string &name)
+{
+    lock_guard<mutex> lock(m_tableMutex);
+
+    if (ifindex > 0 && ifindex < LINK_TABLE_SIZE)
+    {
+        if (static_cast<size_t>(ifindex) >= m_links.size() || m_links[ifindex].name.empty())
+            return false;
+
+        name = m_links[ifindex].name;
+        return true;
+    }
+
+    auto it = m_sparseLinks.find(ifindex);
+    if (it == m_sparseLinks.end())
+        return false;
+
+    name = it->second.name;
+    return true;
+}
+
+int LinkCache::lookupIfindex(const string &name)
+{
+    lock_guard<mutex> lock(m_tableMutex);
+
+    auto it = m_names.find(name);
+    return it != m_names.end() ? it->second : 0;
+}
+
+void LinkCache::cacheLink(struct rtnl_link *link)
+{
+    uncacheLink(rtnl_link_get_ifindex(link));
+    nl_cache_add(m_link_cache, OBJ_CAST(link));
+}
+
+void LinkCache::uncacheLink(int ifindex)
+{
+    struct rtnl_link *old = rtnl_link_get(m_link_cache, ifindex);
+    if (old == NULL)
+        return;
+
+    nl_cache_remove(OBJ_CAST(old));
+    rtnl_link_put(old);
+}
+
+void LinkCache::cacheParsedLink(struct nl_object *obj, void *context)
 {
-    return rtnl_link_get_by_name(m_link_cache, name);
+    static_cast<LinkCache *>(context)->cacheLink((struct rtnl_link *)obj);
+}
+
+void LinkCache::setEntry(int ifindex, const string &name)
+{
+    lock_guard<mutex> lock(m_tableMutex);
+
+    storeEntry(ifindex, name);
+}
+
+void LinkCache::storeEntry(int ifindex, const string &name)
+{
+    if (ifindex < LINK_TABLE_SIZE && static_cast<size_t>(ifindex) >= m_links.size())
+    {
+        /* Grow geometrically, interfaces are often created in bursts */
+        size_t size = max(static_cast<size_t>(ifindex) + 1, m_links.size() * 2);
+        m_links.resize(min(size, static_cast<size_t>(LINK_TABLE_SIZE)));
+    }
+
+    LinkEntry &entry = ifindex < LINK_TABLE_SIZE ? m_links[ifindex] : m_sparseLinks[ifindex];
+    if (entry.name != name)
+    {
+        /* Renamed, or the name moved to another ifindex */
+        eraseEntry(ifindex, entry);
+
+        auto it = m_names.find(name);
+        if (it != m_names.end())
+        {
+            int other = it->second;
+            if (other < LINK_TABLE_SIZE)
+                m_links[other].name.clear();
+            else
+                m_sparseLinks.erase(other);
+        }
+
+        m_names[name] = ifindex;
+        entry.name = name;
+    }
+    entry.generation = m_generation;
+}
+
+void LinkCache::clearEntry(int ifindex)
+{
+    lock_guard<mutex> lock(m_tableMutex);
+
+    if (ifindex > 0 && ifindex < LINK_TABLE_SIZE)
+    {
+        if (static_cast<size_t>(ifindex) < m_links.size())
+            eraseEntry(ifindex, m_links[ifindex]);
+        return;
+    }
+
+    auto it = m_sparseLinks.find(ifindex);
+    if (it == m_sparseLinks.end())
+        return;
+
+    eraseEntry(ifindex, it->second);
+    m_sparseLinks.erase(it);
+}
+
+void LinkCache::eraseEntry(int ifindex, LinkEntry &entry)
+{
+    auto it = m_names.find(entry.name);
+    if (it != m_names.end() && it->second == ifindex)
+        m_names.erase(it);
+
+    entry.name.clear();
+}
+
+void LinkCache::addCachedLink(struct nl_object *obj, void *context)
+{
+    auto links = static_cast<vector<pair<int, string>> *>(context);
+    struct rtnl_link *link = (struct rtnl_link *)obj;
+    const char *name = rtnl_link_get_name(link);
+
+    if (name != NULL)
+        links->emplace_back(rtnl_link_get_ifindex(link), name);
+}
+
+void LinkCache::rebuild()
+{
+    vector<pair<int, string>> links;
+
+    {
+        lock_guard<mutex> lock(m_sockMutex);
+
+        nl_cache_foreach(m_link_cache, addCachedLink, &links);
+        m_refillCount++;
+    }
+
+    lock_guard<mutex> lock(m_tableMutex);
+
+    m_links.clear();
+    m_sparseLinks.clear();
+    m_names.clear();
+
+    for (auto &link : links)
+    {
+        storeEntry(link.first, link.second);
+    }
 }
@@ -1,26 +1,118 @@
 #pragma once
 
+#include "netmsg.h"
+
 #include <netlink/netlink.h>
 #include <netlink/route/link.h>
 
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace swss {
 
-class LinkCache {
+/*
+ * ifindex to name translation maintained from RTM_NEWLINK / RTM_DELLINK.
+ *
+ * The table is filled by a link dump on construction and then kept up to
+ * date by link events, either by registering the instance as raw handler:
+ *
+ *     NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &LinkCache::getInstance());
+ *     NetDispatcher::getInstance().registerRawMessageHandler(RTM_DELLINK, &LinkCache::getInstance());
+ *
+ * or, when the application already handles link messages, by calling
+ * updateLink() and removeLink() from its own handler.
+ *
+ * Lookups of known links only take the table lock. An ifindex or name not
+ * in the table is queried alone from the kernel, so that applications
+ * which do not feed link events still resolve links created after the
+ * dump. Applications feeding link events can disable these queries with
+ * setKernelLookup(false): unknown ifindexes are then returned as numbers
+ * until their RTM_NEWLINK arrives, and lookups never block on netlink.
+ */
+class LinkCache : public RawNetMsg {
 public:
+    /* ifindexes below this are kept in a dense array, others in a map */
+    static constexpr int LINK_TABLE_SIZE = 65536;
+
     static LinkCache &getInstance();
 
     /* Translate ifindex to name */
     std::string ifindexToName(int ifindex);
+
+    /*
+     * Link object kept from the dump, the link events given to onMsg or a
+     * previous kernel query, NULL when unknown. Release with rtnl_link_put().
+     */
     struct rtnl_link* getLinkByName(const char* name);
 
+    /* Query the kernel for links missing from the table, enabled by default */
+    void setKernelLookup(bool enable) { m_kernelLookup.store(enable); }
+
+    void updateLink(int ifindex, const std::string &name);
+    void removeLink(int ifindex);
+
+    /* Dump all links again and replace the table */
+    void refill();
+
+    void onMsg(int nlmsg_type, const struct nlmsghdr *hdr) override;
+
+    /* Links not updated between the two calls are removed */
+    void onResyncBegin() override;
+    void onResyncEnd() override;
+
+    /* Number of full link dumps, including the initial one */
+    uint64_t getRefillCount() const { return m_refillCount.load(); }
+
+    /* Number of single link queries done on lookup misses */
+    uint64_t getKernelLookupCount() const { return m_kernelLookupCount.load(); }
+
 private:
     LinkCache();
     ~LinkCache();
 
+    struct LinkEntry
+    {
+        std::string name;
+        uint32_t generation;
+    };
+
+    bool lookup(int ifindex, std::string &name);
+    int lookupIfindex(const std::string &name);
+    /* Add link to m_link_cache in place of the one of its ifindex, m_sockMutex must be held */
+    void cacheLink(struct rtnl_link *link);
+    void uncacheLink(int ifindex);
+    static void cacheParsedLink(struct nl_object *obj, void *context);
+    void setEntry(int ifindex, const std::string &name);
+    /* Same as setEntry, m_tableMutex must be held */
+    void storeEntry(int ifindex, const std::string &name);
+    void clearEntry(int ifindex);
+    /* Clear the entry at ifindex and its name, m_tableMutex must be held */
+    void eraseEntry(int ifindex, LinkEntry &entry);
+    void rebuild();
+    static void addCachedLink(struct nl_object *obj, void *context);
+
     nl_cache *m_link_cache;
     nl_sock *m_nl_sock;
+
+    /* Serializes m_nl_sock and m_link_cache */
+    std::mutex m_sockMutex;
+
+    /* Protects the table below, never held while talking to the kernel */
+    std::mutex m_tableMutex;
+
+    /* Dense array indexed by ifindex, an empty name is a free slot */
+    std::vector<LinkEntry> m_links;
+    std::unordered_map<int, LinkEntry> m_sparseLinks;
+    /* Reverse of the two above */
+    std::unordered_map<std::string, int> m_names;
+    uint32_t m_generation;
+
+    std::atomic<bool> m_kernelLookup;
+    std::atomic<uint64_t> m_refillCount;
+    std::atomic<uint64_t> m_kernelLookupCount;
 };
 
 }
@@ -0,0 +1,478 @@
+#include "logformat.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace swss;
+
+namespace
+{
+
+enum Length
+{
+    LENGTH_NONE,
+    LENGTH_HH,
+    LENGTH_H,
+    LENGTH_L,
+    LENGTH_LL,
+    LENGTH_J,
+    LENGTH_Z,
+    LENGTH_T,
+};
+
+/* One conversion of a format string, from '%' to the conversion character */
+struct Spec
+{
+    char flags[8];
+    size_t flagCount;
+    bool widthStar;
+    int width;              /* -1 when not given */
+    bool precisionStar;
+    int precision;          /* -1 when not given */
+    Length length;
+    char conversion;
+};
+
+/* Parse the conversion after a '%' at p, false when it can not be deferred */
+bool parseSpec(const char *&p, Spec &spec)
+{
+    spec.flagCount = 0;
+    spec.widthStar = false;
+    spec.width = -1;
+    spec.precisionStar = false;
+    spec.precision = -1;
+    spec.length = LENGTH_NONE;
+
+    while (*p && strchr("-+ #0'I", *p))
+    {
+        if (spec.flagCount == sizeof(spec.flags))
+            return false;
+        spec.flags[spec.flagCount++] = *p++;
+    }
+
+    if (*p == '*')
+    {
+        spec.widthStar = true;
+        p++;
+    }
+    else if (*p >= '0' && *p <= '9')
+    {
+        spec.width = 0;
+        while (*p >= '0' && *p <= '9')
+            spec.width = spec.width * 10 + (*p++ - '0');
+
+        /* Positional argument */
+        if (*p == '$')
+            return false;
+    }
+
+    if (*p == '.')
+    {
+        p++;
+        if (*p == '*')
+        {
+            spec.precisionStar = true;
+            p++;
+        }
+        else
+        {
+            spec.precision = 0;
+            while (*p >= '0' && *p <= '9')
+                spec.precision = spec.precision * 10 + (*p++ - '0');
+        }
+    }
+
+    switch (*p)
+    {
+        case 'h':
+            p++;
+            spec.length = LENGTH_H;
+            if (*p == 'h')
+            {
+                p++;
+                spec.length = LENGTH_HH;
+            }
+            break;
+        case 'l':
+            p++;
+            spec.length = LENGTH_L;
+            if (*p == 'l')
+            {
+                p++;
+                spec.length = LENGTH_LL;
+            }
+            break;
+        case 'q':
+            p++;
+            spec.length = LENGTH_LL;
+            break;
+        case 'j':
+            p++;
+            spec.length = LENGTH_J;
+            break;
+        case 'z':
+            p++;
+            spec.length = LENGTH_Z;
+            break;
+        case 't':
+            p++;
+            spec.length = LENGTH_T;
+            break;
+        default:
+            break;
+    }
+
+    spec.conversion = *p;
+    if (!spec.conversion || !strchr("diouxXcspeEfFgGaA%", spec.conversion))
+        return false;
+    p++;
+
+    /* Wide characters and strings */
+    if ((spec.conversion == 'c' || spec.conversion == 's') && spec.length != LENGTH_NONE)
+        return false;
+
+    return true;
+}
+
+bool isSigned(char conversion)
+{
+    return conversion == 'd' || conversion == 'i';
+}
+
+bool isUnsigned(char conversion)
+{
+    return conversion == 'o' || conversion == 'u' || conversion == 'x' || conversion == 'X';
+}
+
+bool isFloat(char conversion)
+{
+    return strchr("eEfFgGaA", conversion) != NULL;
+}
+
+/*
+ * Signed argument of the given length, converted the way printf would.
+ * ap is taken by pointer: a va_list copied by value is indeterminate for
+ * the caller once va_arg was used on the copy, e.g. on arm64.
+ */
+int64_t signedArg(Length length, va_list *ap)
+{
+    switch (length)
+    {
+        case LENGTH_HH:
+            return static_cast<signed char>(va_arg(*ap, int));
+        case LENGTH_H:
+            return static_cast<short>(va_arg(*ap, int));
+        case LENGTH_L:
+            return va_arg(*ap, long);
+        case LENGTH_LL:
+            return va_arg(*ap, long long);
+        case LENGTH_J:
+            return va_arg(*ap, intmax_t);
+        case LENGTH_Z:
+            return va_arg(*ap, ssize_t);
+        case LENGTH_T:
+            return va_arg(*ap, ptrdiff_t);
+        case LENGTH_NONE:
+        default:
+            return va_arg(*ap, int);
+    }
+}
+
+uint64_t unsignedArg(Length length, va_list *ap)
+{
+    switch (length)
+    {
+        case LENGTH_HH:
+            return static_cast<unsigned char>(va_arg(*ap, unsigned int));
+        case LENGTH_H:
+            return static_cast<unsigned short>(va_arg(*ap, unsigned int));
+        case LENGTH_L:
+            return va_arg(*ap, unsigned long);
+        case LENGTH_LL:
+            return va_arg(*ap, unsigned long long);
+        case LENGTH_J:
+            return va_arg(*ap, uintmax_t);
+        case LENGTH_Z:
+            return va_arg(*ap, size_t);
+        case LENGTH_T:
+            return static_cast<uint64_t>(va_arg(*ap, ptrdiff_t));
+        case LENGTH_NONE:
+        default:
+            return va_arg(*ap, unsigned int);
+    }
+}
+
+/* Appends to a capture buffer, remembering when it ran out of room */
+class Writer
+{
+public:
+    Writer(char *buf, size_t size) : m_buf(buf), m_size(size), m_used(0), m_full(false) {}
+
+    void put(const void *data, size_t len)
+    {
+        if (m_full || m_size - m_used < len)
+        {
+            m_full = true;
+            return;
+        }
+
+        memcpy(m_buf + m_used, data, len);
+        m_used += len;
+    }
+
+    template<typename T>
+    void put(T value)
+    {
+        put(&value, sizeof(value));
+    }
+
+    bool full() const
+    {
+        return m_full;
+    }
+
+    size_t used() const
+    {
+        return m_used;
+    }
+
+private:
+    char *m_buf;
+    size_t m_size;
+    size_t m_used;
+    bool m_full;
+};
+
+/* Reads back what Writer stored */
+class Reader
+{
+public:
+    Reader(const char *buf, size_t len) : m_pos(buf), m_end(buf + len) {}
+
+    template<typename T>
+    T get()
+    {
+        T value = T();
+        if (static_cast<size_t>(m_end - m_pos) >= sizeof(value))
+        {
+            memcpy(&value, m_pos, sizeof(value));
+            m_pos += sizeof(value);
+        }
+        return value;
+    }
+
+    const char *bytes(size_t len)
+    {
+        const char *data = m_pos;
+        m_pos += len <= static_cast<size_t>(m_end - m_pos) ? len : static_cast<size_t>(m_end - m_pos);
+        return data;
+    }
+
+private:
+    const char *m_pos;
+    const char *m_end;
+};
+
+/* Marks a NULL string, printed as glibc does */
+const uint32_t NULL_STRING = UINT32_MAX;
+
+/* snprintf of a single conversion built at run time */
+int formatArg(char *out, size_t size, const char *spec, ...)
+{
+    va_list ap;
+    va_start(ap, spec);
+    int n = vsnprintf(out, size, spec, ap);
+    va_end(ap);
+    return n;
+}
+
+/* Body of DeferredFormat::capture, on a va_list the argument helpers advance */
+bool captureArgs(const char *fmt, va_list *ap, char *buf, size_t size, size_t &used)
+{
+    Writer writer(buf, size);
+
+    for (const char *p = fmt; *p;)
+    {
+        if (*p++ != '%')
+            continue;
+
+        Spec spec;
+        if (!parseSpec(p, spec))
+            return false;
+
+        if (spec.widthStar)
+            writer.put(va_arg(*ap, int));
+
+        int precision = spec.precision;
+        if (spec.precisionStar)
+        {
+            precision = va_arg(*ap, int);
+            writer.put(precision);
+        }
+
+        if (isSigned(spec.conversion))
+        {
+            writer.put(signedArg(spec.length, ap));
+        }
+        else if (isUnsigned(spec.conversion))
+        {
+            writer.put(unsignedArg(spec.length, ap));
+        }
+        else if (isFloat(spec.conversion))
+        {
+            writer.put(va_arg(*ap, double));
+        }
+        else if (spec.conversion == 'c')
+        {
+            writer.put(va_arg(*ap, int));
+        }
+        else if (spec.conversion == 'p')
+        {
+            writer.put(reinterpret_cast<uintptr_t>(va_arg(*ap, void *)));
+        }
+        else if (spec.conversion == 's')
+        {
+            const char *str = va_arg(*ap, const char *);
+            if (str == NULL)
+            {
+                writer.put(NULL_STRING);
+                continue;
+            }
+
+            /* With a precision, str needs not be NUL terminated */
+            size_t len = precision >= 0 ? strnlen(str, static_cast<size_t>(precision)) : strlen(str);
+            if (len >= NULL_STRING)
+                return false;
+
+            writer.put(static_cast<uint32_t>(len));
+            writer.put(str, len);
+        }
+
+        if (writer.full())
+            return false;
+    }
+
+    used = writer.used();
+    return !writer.full();
+}
+
+}
+
+bool DeferredFormat::capture(const char *fmt, va_list ap, char *buf, size_t size, size_t &used)
+{
+    /* Walked through a local copy, which can be passed on by pointer */
+    va_list args;
+    va_copy(args, ap);
+    bool captured = captureArgs(fmt, &args, buf, size, used);
+    va_end(args);
+
+    return captured;
+}
+
+size_t DeferredFormat::format(const char *fmt, const char *args, size_t len, char *out, size_t size)
+{
+    if (size == 0)
+        return 0;
+
+    Reader reader(args, len);
+    size_t pos = 0;
+    const char *p = fmt;
+
+    while (*p)
+    {
+        if (*p != '%')
+        {
+            if (pos + 1 < size)
+                out[pos++] = *p;
+            p++;
+            continue;
+        }
+
+        p++;
+        Spec spec;
+        if (!parseSpec(p, spec))
+            break;
+
+        int width = spec.width;
+        if (spec.widthStar)
+            width = reader.get<int>();
+
+        int precision = spec.precision;
+        if (spec.precisionStar)
+            precision = reader.get<int>();
+
+        /* Rebuild the conversion with the width and precision resolved */
+        char conv[64];
+        size_t c = 0;
+        conv[c++] = '%';
+        for (size_t i = 0; i < spec.flagCount; i++)
+            conv[c++] = spec.flags[i];
+        if (width < 0 && spec.widthStar)
+        {
+            conv[c++] = '-';
+            width = -width;
+        }
+        if (width >= 0)
+            c += static_cast<size_t>(snprintf(conv + c, sizeof(conv) - c, "%d", width));
+
+        const char *str = NULL;
+        uint32_t strLen = 0;
+        if (spec.conversion == 's')
+        {
+            strLen = reader.get<uint32_t>();
+            if (strLen == NULL_STRING)
+            {
+                str = "(null)";
+                strLen = static_cast<uint32_t>(strlen(str));
+
+                /* glibc prints nothing when the precision is too short for "(null)" */
+                if (precision >= 0 && precision < static_cast<int>(strLen))
+                    strLen = 0;
+            }
+            else
+            {
+                str = reader.bytes(strLen);
+            }
+
+            /* The copy is not NUL terminated, its length is the precision */
+            precision = static_cast<int>(strLen);
+        }
+
+        if (precision >= 0)
+            c += static_cast<size_t>(snprintf(conv + c, sizeof(conv) - c, ".%d", precision));
+
+        if (isSigned(spec.conversion) || isUnsigned(spec.conversion))
+        {
+            conv[c++] = 'l';
+            conv[c++] = 'l';
+        }
+        conv[c++] = spec.conversion;
+        conv[c] = '\0';
+
+        char *dst = out + pos;
+        size_t room = size - pos;
+        int n = 0;
+
+        if (isSigned(spec.conversion))
+            n = formatArg(dst, room, conv, static_cast<long long>(reader.get<int64_t>()));
+        else if (isUnsigned(spec.conversion))
+            n = formatArg(dst, room, conv, static_cast<unsigned long long>(reader.get<uint64_t>()));
+        else if (isFloat(spec.conversion))
+            n = formatArg(dst, room, conv, reader.get<double>());
+        else if (spec.conversion == 'c')
+            n = formatArg(dst, room, conv, reader.get<int>());
+        else if (spec.conversion == 'p')
+            n = formatArg(dst, room, conv, reinterpret_cast<void *>(reader.get<uintptr_t>()));
+        else if (spec.conversion == 's')
+            n = formatArg(dst, room, conv, str);
+        else
+            n = formatArg(dst, room, conv);
+
+        if (n > 0)
+            pos = pos + static_cast<size_t>(n) < size ? pos + static_cast<size_t>(n) : size - 1;
+    }
+
+    out[pos] = '\0';
+    return pos;
+}
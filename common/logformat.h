@@ -0,0 +1,36 @@
+#ifndef __LOGFORMAT__
+#define __LOGFORMAT__
+
+#include <stdarg.h>
+#include <stddef.h>
+
+namespace swss {
+
+/*
+ * printf style formatting split in two steps: capture() copies the
+ * arguments consumed by a format string into a buffer, and format() makes
+ * the text later from that buffer. Strings are copied, only the format
+ * string itself must still exist when formatting.
+ */
+class DeferredFormat
+{
+public:
+    /*
+     * Copy the arguments of fmt from ap into buf and set used to the bytes
+     * taken. Returns false when they do not fit or fmt has a conversion
+     * which can not be deferred: %n, %m, positional arguments, wide
+     * characters or long double. ap is consumed in any case.
+     */
+    static bool capture(const char *fmt, va_list ap, char *buf, size_t size, size_t &used);
+
+    /*
+     * Write what snprintf(out, size, fmt, ...) would write with the
+     * captured arguments. Returns the length written, without the
+     * terminating NUL.
+     */
+    static size_t format(const char *fmt, const char *args, size_t len, char *out, size_t size);
+};
+
+}
+
+#endif
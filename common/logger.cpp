@@ -1,4 +1,5 @@
 #include "logger.h"
+#include "logformat.h"
 
 #include <algorithm>
 #include <stdarg.h>
@@ -11,8 +12,8 @@
 #include "schema.h"
 #include "select.h"
 #include "dbconnector.h"
-#include "consumerstatetable.h"
 #include "producerstatetable.h"
+#include "logsettingwatcher.h"
 
 namespace swss {
 
@@ -28,15 +29,92 @@ void err_exit(const char *fn, int ln, int e, const char *fmt, ...)
     vsnprintf(buff+len, sizeof(buff)-len, fmt, ap);
     va_end(ap);
     SWSS_LOG_ERROR("Aborting: %s", buff);
+    Logger::flush();
     abort();
 }
 
+/* Longest message kept by an asynchronous write, longer ones are truncated */
+static const size_t ASYNC_RECORD_SIZE = 1024;
+
+/* Time the background thread lets messages gather once woken up */
+static const std::chrono::milliseconds ASYNC_BATCH_WAIT(1);
+
+/*
+ * Formatted messages of one thread: written by that thread only, read by
+ * whoever holds m_drainMutex.
+ */
+class Logger::AsyncRing
+{
+public:
+    struct Record
+    {
+        Priority prio;
+        Output output;
+        /* Set when text holds the captured arguments of fmt */
+        const char *fmt;
+        size_t argsLen;
+        char text[ASYNC_RECORD_SIZE];
+    };
+
+    AsyncRing(size_t size) : m_closed(false), m_records(size), m_head(0), m_tail(0) {}
+
+    /* Next record to fill, nullptr when the ring is full */
+    Record *reserve()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == m_records.size())
+            return nullptr;
+
+        return &m_records[head % m_records.size()];
+    }
+
+    void commit()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed);
+    }
+
+    template<typename F>
+    size_t drain(F f)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t count = head - tail;
+
+        for (; tail != head; tail++)
+        {
+            f(m_records[tail % m_records.size()]);
+            m_tail.store(tail + 1, std::memory_order_release);
+        }
+
+        return count;
+    }
+
+    /* Set when the thread exits, the ring is freed once drained */
+    std::atomic<bool> m_closed;
+
+private:
+    std::vector<Record> m_records;
+    std::atomic<size_t> m_head;
+    std::atomic<size_t> m_tail;
+};
+
 Logger::~Logger() {
     if (m_settingThread) {
         m_settingThread->detach();
     }
+
+    m_async = false;
+    stopAsyncThread();
+    drainRings();
 }
 
+std::atomic<Logger::Priority> Logger::m_minPrio(Logger::SWSS_NOTICE);
+
 const Logger::PriorityStringMap Logger::priorityStringMap = {
     { "EMERG", SWSS_EMERG },
     { "ALERT", SWSS_ALERT },
@@ -87,11 +165,19 @@ void Logger::swssOutputNotify(const std::string &component, const std::string &o
 void Logger::linkToDbWithOutput(const std::string &dbName, const PriorityChangeNotify& prioNotify, const std::string& defPrio, const OutputChangeNotify& outputNotify, const std::string& defOutput)
 {
     auto& logger = getInstance();
+    std::vector<std::string> changed;
 
     // Initialize internal DB with observer
-    logger.m_settingChangeObservers.insert(std::make_pair(dbName, std::make_pair(prioNotify, outputNotify)));
+    {
+        std::lock_guard<std::mutex> lock(logger.m_settingMutex);
+        logger.m_settingChangeObservers.insert(std::make_pair(dbName, std::make_pair(prioNotify, outputNotify)));
+
+        // Subscribe before reading, so no later change is missed
+        for (auto watcher : logger.m_settingWatchers)
+            watcher->watch(dbName, changed);
+    }
+
     DBConnector db("LOGLEVEL_DB", 0);
-    auto keys = db.keys("*");
 
     std::string key = dbName + ":" + dbName;
     std::string prio, output;
@@ -129,10 +215,21 @@ void Logger::linkToDbWithOutput(const std::string &dbName, const PriorityChangeN
         table.set(dbName, fieldValues);
     }
 
-    logger.m_currentPrios[dbName] = prio;
-    logger.m_currentOutputs[dbName] = output;
+    {
+        std::lock_guard<std::mutex> lock(logger.m_settingMutex);
+        logger.m_currentPrios[dbName] = prio;
+        logger.m_currentOutputs[dbName] = output;
+    }
     prioNotify(dbName, prio);
     outputNotify(dbName, output);
+
+    // Also takes dbName out of its key set, so its next change is published
+    applySettings(db, dbName);
+    for (const auto &component : changed)
+    {
+        if (component != dbName)
+            applySettings(db, component);
+    }
 }
 
 void Logger::linkToDb(const std::string &dbName, const PriorityChangeNotify& prioNotify, const std::string& defPrio)
@@ -140,12 +237,126 @@ void Logger::linkToDb(const std::string &dbName, const PriorityChangeNotify& pri
     linkToDbWithOutput(dbName, prioNotify, defPrio, swssOutputNotify, "SYSLOG");
 }
 
-void Logger::linkToDbNative(const std::string &dbName)
+void Logger::linkToDbNative(const std::string &dbName, bool startThread)
 {
     auto& logger = getInstance();
 
     linkToDb(dbName, swssPrioNotify, "NOTICE");
-    logger.m_settingThread.reset(new std::thread(&Logger::settingThread, &logger));
+
+    std::lock_guard<std::mutex> lock(logger.m_mutex);
+    if (startThread && !logger.m_settingThread)
+    {
+        logger.m_settingThread.reset(new std::thread(&Logger::settingThread, &logger));
+    }
+}
+
+void Logger::addSettingWatcher(LogSettingWatcher *watcher, DBConnector &db)
+{
+    std::vector<std::string> components;
+
+    {
+        std::lock_guard<std::mutex> lock(m_settingMutex);
+        m_settingWatchers.push_back(watcher);
+
+        for (const auto& i : m_settingChangeObservers)
+        {
+            watcher->watch(i.first, components);
+        }
+
+        for (const auto& i : m_settingChangeObservers)
+        {
+            if (std::find(components.begin(), components.end(), i.first) == components.end())
+                components.push_back(i.first);
+        }
+    }
+
+    // Changes made before the subscription
+    for (const auto &component : components)
+    {
+        applySettings(db, component);
+    }
+}
+
+void Logger::removeSettingWatcher(LogSettingWatcher *watcher)
+{
+    std::lock_guard<std::mutex> lock(m_settingMutex);
+    m_settingWatchers.erase(std::remove(m_settingWatchers.begin(), m_settingWatchers.end(), watcher), m_settingWatchers.end());
+}
+
+void Logger::applySettings(DBConnector &db, const std::string &component)
+{
+    auto& logger = getInstance();
+
+    /*
+     * Pop the component like ConsumerStateTable does, then read all of its
+     * settings: the producer publishes again only once the component is
+     * out of the key set.
+     */
+    static const std::string luaPop =
+        "redis.call('SREM', KEYS[1], ARGV[1])\n"
+        "if redis.call('SREM', KEYS[2], ARGV[1]) == 1 then\n"
+        "    redis.call('DEL', KEYS[3])\n"
+        "end\n"
+        "local fieldvalues = redis.call('HGETALL', KEYS[4])\n"
+        "for i = 1, #fieldvalues, 2 do\n"
+        "    redis.call('HSET', KEYS[3], fieldvalues[i], fieldvalues[i + 1])\n"
+        "end\n"
+        "redis.call('DEL', KEYS[4])\n"
+        "return redis.call('HGETALL', KEYS[3])\n";
+
+    TableName_KeySet keySet(component);
+    std::string key = component + ":" + component;
+
+    RedisCommand command;
+    command.format("EVAL %s 4 %s %s %s %s %s", luaPop.c_str(),
+                   keySet.getKeySetName().c_str(), keySet.getDelKeySetName().c_str(),
+                   key.c_str(), (keySet.getStateHashPrefix() + key).c_str(), component.c_str());
+    RedisReply r(&db, command, REDIS_REPLY_ARRAY);
+    auto reply = r.getContext();
+
+    PriorityChangeNotify prioNotify;
+    OutputChangeNotify outputNotify;
+    std::string prio, output;
+
+    {
+        std::lock_guard<std::mutex> lock(logger.m_settingMutex);
+
+        auto observer = logger.m_settingChangeObservers.find(component);
+        if (observer == logger.m_settingChangeObservers.end())
+        {
+            return;
+        }
+
+        for (size_t i = 0; i + 1 < reply->elements; i += 2)
+        {
+            std::string field(reply->element[i]->str, reply->element[i]->len);
+            std::string value(reply->element[i + 1]->str, reply->element[i + 1]->len);
+
+            if ((field == DAEMON_LOGLEVEL) && (value != logger.m_currentPrios[component]))
+            {
+                logger.m_currentPrios[component] = value;
+                prioNotify = observer->second.first;
+                prio = value;
+            }
+            else if ((field == DAEMON_LOGOUTPUT) && (value != logger.m_currentOutputs[component]))
+            {
+                logger.m_currentOutputs[component] = value;
+                outputNotify = observer->second.second;
+                output = value;
+            }
+        }
+    }
+
+    // Outside of the lock, the observers may log
+    if (prioNotify)
+    {
+        prioNotify(component, prio);
+    }
+
+    if (outputNotify)
+    {
+        outputNotify(component, output);
+    }
 }
 
 Logger &Logger::getInstance()
@@ -164,70 +375,191 @@ Logger::Priority Logger::getMinPrio()
     return getInstance().m_minPrio;
 }
 
-[[ noreturn ]] void Logger::settingThread()
+void Logger::setOutput(Output output)
 {
-    Select select;
-    DBConnector db("LOGLEVEL_DB", 0);
-    std::map<std::string, std::shared_ptr<ConsumerStateTable>> selectables;
+    getInstance().m_output = output;
+}
 
-    while (true)
+Logger::Output Logger::getOutput()
+{
+    return getInstance().m_output;
+}
+
+void Logger::enableAsync(OverflowPolicy policy, size_t ringSize, bool deferFormat)
+{
+    auto& logger = getInstance();
+    std::lock_guard<std::mutex> lock(logger.m_asyncControlMutex);
+
+    logger.m_overflowPolicy = policy;
+    logger.m_deferFormat = deferFormat;
+    logger.m_asyncRingSize = ringSize > 0 ? ringSize : 1;
+
+    if (!logger.m_asyncThread)
     {
-        if (selectables.size() < m_settingChangeObservers.size())
-        {
-            for (const auto& i : m_settingChangeObservers)
-            {
-                const std::string &dbName = i.first;
-                if (selectables.find(dbName) == selectables.end())
-                {
-                    auto table = std::make_shared<ConsumerStateTable>(&db, dbName);
-                    selectables.emplace(dbName, table);
-                    select.addSelectable(table.get());
-                }
-            }
-        }
+        logger.m_asyncRunning = true;
+        logger.m_asyncThread.reset(new std::thread(&Logger::asyncThread, &logger));
+    }
 
-        Selectable *selectable = nullptr;
+    logger.m_async = true;
+}
 
-        /* TODO Resolve latency caused by timeout at initialization. */
-        int ret = select.select(&selectable, 1000); // Timeout if there is no data in 1000 ms.
+void Logger::disableAsync()
+{
+    auto& logger = getInstance();
+    std::lock_guard<std::mutex> lock(logger.m_asyncControlMutex);
 
-        if (ret == Select::ERROR)
-        {
-            SWSS_LOG_NOTICE("%s select error %s", __PRETTY_FUNCTION__, strerror(errno));
-            continue;
-        }
+    logger.m_async = false;
+    logger.stopAsyncThread();
+    logger.drainRings();
+}
 
-        if (ret == Select::TIMEOUT)
-        {
-            SWSS_LOG_DEBUG("%s select timeout", __PRETTY_FUNCTION__);
-            continue;
-        }
+bool Logger::isAsync()
+{
+    return getInstance().m_async;
+}
 
-        KeyOpFieldsValuesTuple koValues;
-        dynamic_cast<ConsumerStateTable *>(selectable)->pop(koValues);
-        std::string key = kfvKey(koValues), op = kfvOp(koValues);
+void Logger::flush()
+{
+    auto& logger = getInstance();
+
+    logger.drainRings();
+
+    std::lock_guard<std::mutex> lock(logger.m_mutex);
+    fflush(stdout);
+    fflush(stderr);
+}
+
+uint64_t Logger::getDroppedCount()
+{
+    return getInstance().m_droppedCount;
+}
+
+void Logger::stopAsyncThread()
+{
+    if (!m_asyncThread)
+        return;
+
+    m_asyncRunning = false;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncWaitMutex);
+        m_asyncWakeup.notify_one();
+    }
+
+    m_asyncThread->join();
+    m_asyncThread.reset();
+}
 
-        if ((op != SET_COMMAND) || (m_settingChangeObservers.find(key) == m_settingChangeObservers.end()))
+Logger::AsyncRing &Logger::getThreadRing()
+{
+    struct ThreadRing
+    {
+        std::shared_ptr<AsyncRing> ring;
+
+        ~ThreadRing()
         {
-            continue;
+            if (ring)
+                ring->m_closed = true;
         }
+    };
 
-        auto values = kfvFieldsValues(koValues);
-        for (const auto& i : values)
-        {
-            const std::string &field = fvField(i), &value = fvValue(i);
-            if ((field == DAEMON_LOGLEVEL) && (value != m_currentPrios[key]))
+    static thread_local ThreadRing threadRing;
+
+    if (!threadRing.ring)
+    {
+        threadRing.ring = std::make_shared<AsyncRing>(m_asyncRingSize);
+
+        std::lock_guard<std::mutex> lock(m_asyncRingsMutex);
+        m_asyncRings.push_back(threadRing.ring);
+    }
+
+    return *threadRing.ring;
+}
+
+size_t Logger::drainRings()
+{
+    std::lock_guard<std::mutex> drainLock(m_drainMutex);
+    std::lock_guard<std::mutex> ringsLock(m_asyncRingsMutex);
+    size_t count = 0;
+
+    for (auto it = m_asyncRings.begin(); it != m_asyncRings.end();)
+    {
+        count += (*it)->drain([this](const AsyncRing::Record &record) {
+            if (record.fmt)
             {
-                m_currentPrios[key] = value;
-                m_settingChangeObservers[key].first(key, value);
+                char text[ASYNC_RECORD_SIZE];
+                DeferredFormat::format(record.fmt, record.text, record.argsLen, text, sizeof(text));
+                writeLine(record.prio, record.output, text);
             }
-            else if ((field == DAEMON_LOGOUTPUT) && (value != m_currentOutputs[key]))
+            else
             {
-                m_currentOutputs[key] = value;
-                m_settingChangeObservers[key].second(key, value);
+                writeLine(record.prio, record.output, record.text);
             }
+        });
+
+        if ((*it)->m_closed && (*it)->empty())
+            it = m_asyncRings.erase(it);
+        else
+            it++;
+    }
+
+    return count;
+}
+
+bool Logger::hasPendingRecords()
+{
+    std::lock_guard<std::mutex> lock(m_asyncRingsMutex);
+
+    for (const auto &ring : m_asyncRings)
+    {
+        if (!ring->empty())
+            return true;
+    }
+
+    return false;
+}
+
+void Logger::asyncThread()
+{
+    std::unique_lock<std::mutex> lock(m_asyncWaitMutex);
+
+    while (m_asyncRunning)
+    {
+        /* Pairs with the fence in writeAsync, one side sees the other */
+        m_asyncWaiting = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!hasPendingRecords())
+        {
+            m_asyncWakeup.wait(lock, [this]() { return !m_asyncWaiting || !m_asyncRunning; });
+        }
+
+        m_asyncWaiting = false;
+
+        /* Write a burst at once rather than waking up for each message */
+        m_asyncWakeup.wait_for(lock, ASYNC_BATCH_WAIT, [this]() { return !m_asyncRunning; });
+
+        lock.unlock();
+        drainRings();
+        lock.lock();
+    }
+}
+
+[[ noreturn ]] void Logger::settingThread()
+{
+    Select select;
+    LogSettingWatcher watcher;
+    select.addSelectable(&watcher);
+
+    while (true)
+    {
+        Selectable *selectable = nullptr;
 
-            break;
+        // The watcher applies the changes while Select reads its data
+        int ret = select.select(&selectable);
+
+        if (ret == Select::ERROR)
+        {
+            SWSS_LOG_NOTICE("%s select error %s", __PRETTY_FUNCTION__, strerror(errno));
         }
     }
 }
@@ -243,6 +575,40 @@ void Logger::write(Priority prio, const char *fmt, ...)
     va_list ap;
     va_start(ap, fmt);
 
+    if (m_async)
+    {
+        writeAsync(prio, fmt, ap, false);
+    }
+    else
+    {
+        writeSync(prio, fmt, ap);
+    }
+
+    va_end(ap);
+}
+
+void Logger::writeStatic(Priority prio, const char *fmt, ...)
+{
+    if (prio > m_minPrio)
+        return;
+
+    va_list ap;
+    va_start(ap, fmt);
+
+    if (m_async)
+    {
+        writeAsync(prio, fmt, ap, true);
+    }
+    else
+    {
+        writeSync(prio, fmt, ap);
+    }
+
+    va_end(ap);
+}
+
+void Logger::writeSync(Priority prio, const char *fmt, va_list ap)
+{
     if (m_output == SWSS_SYSLOG)
     {
             vsyslog(prio, fmt, ap);
@@ -262,8 +628,72 @@ void Logger::write(Priority prio, const char *fmt, ...)
             vfprintf(stderr, ss.str().c_str(), ap);
         }
     }
+}
 
-    va_end(ap);
+void Logger::writeAsync(Priority prio, const char *fmt, va_list ap, bool staticFmt)
+{
+    AsyncRing &ring = getThreadRing();
+    AsyncRing::Record *record;
+
+    while ((record = ring.reserve()) == nullptr)
+    {
+        if (m_overflowPolicy == SWSS_LOG_DROP)
+        {
+            m_droppedCount++;
+            return;
+        }
+
+        flush();
+    }
+
+    record->prio = prio;
+    record->output = m_output;
+    record->fmt = nullptr;
+
+    bool captured = false;
+    if (staticFmt && m_deferFormat)
+    {
+        va_list args;
+        va_copy(args, ap);
+        captured = DeferredFormat::capture(fmt, args, record->text, sizeof(record->text), record->argsLen);
+        va_end(args);
+    }
+
+    if (captured)
+    {
+        record->fmt = fmt;
+    }
+    else
+    {
+        vsnprintf(record->text, sizeof(record->text), fmt, ap);
+    }
+
+    ring.commit();
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    /* Only the first message after the background thread went idle wakes it up */
+    if (m_asyncWaiting && m_asyncWaiting.exchange(false))
+    {
+        std::lock_guard<std::mutex> lock(m_asyncWaitMutex);
+        m_asyncWakeup.notify_one();
+    }
+
+    /* Async output was turned off meanwhile, nobody else drains the ring */
+    if (!m_async)
+        drainRings();
+}
+
+void Logger::writeLine(Priority prio, Output out, const char *text)
+{
+    if (out == SWSS_SYSLOG)
+    {
+        syslog(prio, "%s", text);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    fprintf(out == SWSS_STDOUT ? stdout : stderr, "%6s%s\n", priorityToString(prio).c_str(), text);
 }
 
 void Logger::wthrow(Priority prio, const char *fmt, ...)
@@ -273,24 +703,13 @@ void Logger::wthrow(Priority prio, const char *fmt, ...)
     va_list ap;
     va_start(ap, fmt);
 
-    if (m_output == SWSS_SYSLOG)
+    if (m_async)
     {
-        vsyslog(prio, fmt, ap);
+        writeAsync(prio, fmt, ap, false);
     }
     else
     {
-        std::stringstream ss;
-        ss << std::setw(6) << std::right << priorityToString(prio);
-        ss << fmt << std::endl;
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_output == SWSS_STDOUT)
-        {
-            vprintf(ss.str().c_str(), ap);
-        }
-        else
-        {
-            vfprintf(stderr, ss.str().c_str(), ap);
-        }
+        writeSync(prio, fmt, ap);
     }
 
     va_end(ap);
@@ -328,16 +747,6 @@ std::string Logger::outputToString(Logger::Output output)
     return "UNKNOWN";
 }
 
-Logger::ScopeLogger::ScopeLogger(int line, const char *fun) : m_line(line), m_fun(fun)
-{
-    swss::Logger::getInstance().write(swss::Logger::SWSS_DEBUG, ":> %s: enter", m_fun);
-}
-
-Logger::ScopeLogger::~ScopeLogger()
-{
-    swss::Logger::getInstance().write(swss::Logger::SWSS_DEBUG, ":< %s: exit", m_fun);
-}
-
 Logger::ScopeTimer::ScopeTimer(int line, const char *fun, const char *fmt, ...) :
     m_line(line),
     m_fun(fun)
@@ -360,7 +769,7 @@ Logger::ScopeTimer::~ScopeTimer()
 
     double duration = std::chrono::duration_cast<second_t>(end - m_start).count();
 
-    Logger::getInstance().write(swss::Logger::SWSS_NOTICE, ":- %s: %s took %lf sec", m_fun, m_msg.c_str(), duration);
+    Logger::getInstance().writeStatic(swss::Logger::SWSS_NOTICE, ":- %s: %s took %lf sec", m_fun, m_msg.c_str(), duration);
 }
 
 };
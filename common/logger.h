@@ -1,6 +1,7 @@
 #ifndef SWSS_COMMON_LOGGER_H
 #define SWSS_COMMON_LOGGER_H
 
+#include <stdarg.h>
 #include <string>
 #include <chrono>
 #include <atomic>
@@ -8,15 +9,33 @@
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <vector>
 #include <functional>
 
 namespace swss {
 
-#define SWSS_LOG_ERROR(MSG, ...)       swss::Logger::getInstance().write(swss::Logger::SWSS_ERROR,  ":- %s: " MSG, __FUNCTION__, ##__VA_ARGS__)
-#define SWSS_LOG_WARN(MSG, ...)        swss::Logger::getInstance().write(swss::Logger::SWSS_WARN,   ":- %s: " MSG, __FUNCTION__, ##__VA_ARGS__)
-#define SWSS_LOG_NOTICE(MSG, ...)      swss::Logger::getInstance().write(swss::Logger::SWSS_NOTICE, ":- %s: " MSG, __FUNCTION__, ##__VA_ARGS__)
-#define SWSS_LOG_INFO(MSG, ...)        swss::Logger::getInstance().write(swss::Logger::SWSS_INFO,   ":- %s: " MSG, __FUNCTION__, ##__VA_ARGS__)
-#define SWSS_LOG_DEBUG(MSG, ...)       swss::Logger::getInstance().write(swss::Logger::SWSS_DEBUG,  ":- %s: " MSG, __FUNCTION__, ##__VA_ARGS__)
+class DBConnector;
+class LogSettingWatcher;
+
+/*
+ * Messages less severe than this are compiled out, e.g. for release builds
+ * -DSWSS_LOG_COMPILE_MIN_PRIO=swss::Logger::SWSS_INFO
+ */
+#ifndef SWSS_LOG_COMPILE_MIN_PRIO
+#define SWSS_LOG_COMPILE_MIN_PRIO      swss::Logger::SWSS_DEBUG
+#endif
+
+/* Checked before the message arguments are evaluated */
+#define SWSS_LOG_ENABLED(PRIO)         ((PRIO) <= SWSS_LOG_COMPILE_MIN_PRIO && swss::Logger::isEnabled(PRIO))
+
+#define SWSS_LOG_WRITE(PRIO, MSG, ...) (SWSS_LOG_ENABLED(PRIO) ? swss::Logger::getInstance().writeStatic((PRIO), ":- %s: " MSG, __FUNCTION__, ##__VA_ARGS__) : (void)0)
+
+#define SWSS_LOG_ERROR(MSG, ...)       SWSS_LOG_WRITE(swss::Logger::SWSS_ERROR,  MSG, ##__VA_ARGS__)
+#define SWSS_LOG_WARN(MSG, ...)        SWSS_LOG_WRITE(swss::Logger::SWSS_WARN,   MSG, ##__VA_ARGS__)
+#define SWSS_LOG_NOTICE(MSG, ...)      SWSS_LOG_WRITE(swss::Logger::SWSS_NOTICE, MSG, ##__VA_ARGS__)
+#define SWSS_LOG_INFO(MSG, ...)        SWSS_LOG_WRITE(swss::Logger::SWSS_INFO,   MSG, ##__VA_ARGS__)
+#define SWSS_LOG_DEBUG(MSG, ...)       SWSS_LOG_WRITE(swss::Logger::SWSS_DEBUG,  MSG, ##__VA_ARGS__)
 
 #define SWSS_LOG_ENTER()               swss::Logger::ScopeLogger logger ## __LINE__ (__LINE__, __FUNCTION__)
 #define SWSS_LOG_TIMER(msg, ...)       swss::Logger::ScopeTimer scopetimer ## __LINE__ (__LINE__, __FUNCTION__, msg, ##__VA_ARGS__)
@@ -73,19 +92,68 @@ public:
     typedef std::function<void (std::string component, std::string outputStr)> OutputChangeNotify;
     typedef std::map<std::string, std::pair<PriorityChangeNotify, OutputChangeNotify>> LogSettingChangeObservers;
 
+    /* What an asynchronous write does when the ring of its thread is full */
+    enum OverflowPolicy
+    {
+        SWSS_LOG_DROP,      /* Drop the message and count it */
+        SWSS_LOG_BLOCK      /* Drain the rings in the writing thread */
+    };
+
+    static const size_t DEFAULT_ASYNC_RING_SIZE = 256;
+
     static Logger &getInstance();
     static void setMinPrio(Priority prio);
     static Priority getMinPrio();
+    static void setOutput(Output output);
+    static Output getOutput();
+
+    /*
+     * Format messages in the writing thread into a ring per thread and
+     * leave the output to a background thread, which writes them in bursts
+     * about every millisecond. ringSize applies to the rings of threads
+     * which did not write asynchronously yet. With deferFormat, writeStatic
+     * only copies the arguments and the background thread formats them.
+     */
+    static void enableAsync(OverflowPolicy policy = SWSS_LOG_DROP, size_t ringSize = DEFAULT_ASYNC_RING_SIZE, bool deferFormat = false);
+    // Writes all pending messages and goes back to synchronous output
+    static void disableAsync();
+    static bool isAsync();
+    // Writes all pending messages, from the calling thread
+    static void flush();
+    static uint64_t getDroppedCount();
+
     static void linkToDbWithOutput(const std::string &dbName, const PriorityChangeNotify& prioNotify, const std::string& defPrio, const OutputChangeNotify& outputNotify, const std::string& defOutput);
     static void linkToDb(const std::string &dbName, const PriorityChangeNotify& notify, const std::string& defPrio);
-    // Must be called after all linkToDb to start select from DB
-    static void linkToDbNative(const std::string &dbName);
+    /*
+     * Must be called after all linkToDb to apply the settings changed in DB.
+     * Without startThread, the application adds a LogSettingWatcher to its
+     * own Select instead of the setting thread.
+     */
+    static void linkToDbNative(const std::string &dbName, bool startThread = true);
+
+    // Whether messages of prio pass the runtime minimum priority
+    static inline bool isEnabled(Priority prio)
+    {
+        return prio <= m_minPrio.load(std::memory_order_relaxed);
+    }
+
     void write(Priority prio, const char *fmt, ...)
 #ifdef __GNUC__
         __attribute__ ((format (printf, 3, 4)))
 #endif
     ;
 
+    /*
+     * Same as write for a format string which is never freed, like the
+     * literals of the SWSS_LOG_* macros: it may be read again when the
+     * message is formatted later.
+     */
+    void writeStatic(Priority prio, const char *fmt, ...)
+#ifdef __GNUC__
+        __attribute__ ((format (printf, 3, 4)))
+#endif
+    ;
+
     void wthrow(Priority prio, const char *fmt, ...)
 #ifdef __GNUC__
         __attribute__ ((format (printf, 3, 4)))
@@ -100,8 +168,17 @@ public:
     {
         public:
 
-        ScopeLogger(int line, const char *fun);
-        ~ScopeLogger();
+        ScopeLogger(int line, const char *fun) : m_line(line), m_fun(fun)
+        {
+            if (SWSS_LOG_ENABLED(SWSS_DEBUG))
+                getInstance().writeStatic(SWSS_DEBUG, ":> %s: enter", m_fun);
+        }
+
+        ~ScopeLogger()
+        {
+            if (SWSS_LOG_ENABLED(SWSS_DEBUG))
+                getInstance().writeStatic(SWSS_DEBUG, ":< %s: exit", m_fun);
+        }
 
         private:
             const int m_line;
@@ -138,13 +215,53 @@ private:
 
     ATTRIBUTE_NORTEURN void settingThread();
 
+    friend class LogSettingWatcher;
+
+    void addSettingWatcher(LogSettingWatcher *watcher, DBConnector &db);
+    void removeSettingWatcher(LogSettingWatcher *watcher);
+    // Read the settings of component from db and notify the changed ones
+    static void applySettings(DBConnector &db, const std::string &component);
+
+    class AsyncRing;
+
+    void writeSync(Priority prio, const char *fmt, va_list ap);
+    void writeLine(Priority prio, Output out, const char *text);
+    void writeAsync(Priority prio, const char *fmt, va_list ap, bool staticFmt);
+    AsyncRing &getThreadRing();
+    size_t drainRings();
+    bool hasPendingRecords();
+    void asyncThread();
+    void stopAsyncThread();
+
     LogSettingChangeObservers m_settingChangeObservers;
     std::map<std::string, std::string> m_currentPrios;
-    std::atomic<Priority> m_minPrio = { SWSS_NOTICE };
+    static std::atomic<Priority> m_minPrio;
     std::map<std::string, std::string> m_currentOutputs;
     std::atomic<Output> m_output = { SWSS_SYSLOG };
     std::unique_ptr<std::thread> m_settingThread;
     std::mutex m_mutex;
+
+    /* Guards the observers, the current settings and the watchers */
+    std::mutex m_settingMutex;
+    std::vector<LogSettingWatcher *> m_settingWatchers;
+
+    std::atomic<bool> m_async = { false };
+    std::atomic<OverflowPolicy> m_overflowPolicy = { SWSS_LOG_DROP };
+    std::atomic<bool> m_deferFormat = { false };
+    std::atomic<size_t> m_asyncRingSize = { DEFAULT_ASYNC_RING_SIZE };
+    std::atomic<uint64_t> m_droppedCount = { 0 };
+
+    /* Rings of all threads, drained by one thread at a time under m_drainMutex */
+    std::vector<std::shared_ptr<AsyncRing>> m_asyncRings;
+    std::mutex m_asyncRingsMutex;
+    std::mutex m_drainMutex;
+
+    std::unique_ptr<std::thread> m_asyncThread;
+    std::mutex m_asyncControlMutex;
+    std::atomic<bool> m_asyncRunning = { false };
+    std::atomic<bool> m_asyncWaiting = { false };
+    std::mutex m_asyncWaitMutex;
+    std::condition_variable m_asyncWakeup;
 };
 
 }
@@ -0,0 +1,137 @@
+#include "logsettingwatcher.h"
+
+#include <poll.h>
+#include <algorithm>
+#include <stdexcept>
+#include <hiredis/hiredis.h>
+#include "logger.h"
+#include "redisreply.h"
+#include "table.h"
+
+#define REDIS_PUBLISH_MESSAGE_ELEMNTS (3)
+
+using namespace swss;
+
+namespace
+{
+
+const std::string CHANNEL_SUFFIX = TableBase("", ":").getChannelName();
+
+void addChanged(std::vector<std::string> &changed, const std::string &component)
+{
+    if (std::find(changed.begin(), changed.end(), component) == changed.end())
+        changed.push_back(component);
+}
+
+}
+
+LogSettingWatcher::LogSettingWatcher(int pri) :
+    Selectable(pri),
+    m_db("LOGLEVEL_DB", 0),
+    m_subscribe(m_db.newConnector(SUBSCRIBE_TIMEOUT))
+{
+    Logger::getInstance().addSettingWatcher(this, m_db);
+}
+
+LogSettingWatcher::~LogSettingWatcher()
+{
+    Logger::getInstance().removeSettingWatcher(this);
+}
+
+int LogSettingWatcher::getFd()
+{
+    return m_subscribe->getContext()->fd;
+}
+
+bool LogSettingWatcher::hasData()
+{
+    return false;
+}
+
+uint64_t LogSettingWatcher::readData()
+{
+    std::vector<std::string> changed;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        redisContext *ctx = m_subscribe->getContext();
+
+        /* watch() may have read what woke up the Select already, do not block */
+        struct pollfd pfd = { ctx->fd, POLLIN, 0 };
+        while (::poll(&pfd, 1, 0) > 0)
+        {
+            if (redisBufferRead(ctx) != REDIS_OK)
+                throw std::runtime_error("Unable to read redis reply from LogSettingWatcher::readData() redisBufferRead()");
+        }
+
+        redisReply *reply = nullptr;
+        while (redisGetReplyFromReader(ctx, reinterpret_cast<void**>(&reply)) == REDIS_OK && reply != nullptr)
+        {
+            RedisReply r(reply);
+            processReply(reply, changed);
+            reply = nullptr;
+        }
+
+        if (ctx->err)
+            throw std::runtime_error("Unable to read redis reply from LogSettingWatcher::readData() redisGetReplyFromReader()");
+    }
+
+    for (const auto &component : changed)
+        Logger::applySettings(m_db, component);
+
+    return 0;
+}
+
+void LogSettingWatcher::watch(const std::string &component, std::vector<std::string> &changed)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    redisContext *ctx = m_subscribe->getContext();
+    std::string channel = TableBase(component, ":").getChannelName();
+
+    if (redisAppendCommand(ctx, "SUBSCRIBE %s", channel.c_str()) != REDIS_OK)
+        throw std::runtime_error("Unable to send SUBSCRIBE " + channel);
+
+    int done = 0;
+    do
+    {
+        if (redisBufferWrite(ctx, &done) != REDIS_OK)
+            throw std::runtime_error("Unable to send SUBSCRIBE " + channel);
+    }
+    while (!done);
+
+    /* Notifications of other components may come first */
+    while (true)
+    {
+        redisReply *reply = nullptr;
+        if (redisGetReply(ctx, reinterpret_cast<void**>(&reply)) != REDIS_OK)
+            throw std::runtime_error("Unable to read the reply of SUBSCRIBE " + channel);
+
+        RedisReply r(reply);
+        if (processReply(reply, changed) == channel)
+            break;
+    }
+}
+
+std::string LogSettingWatcher::processReply(redisReply *reply, std::vector<std::string> &changed)
+{
+    if (reply->type != REDIS_REPLY_ARRAY || reply->elements != REDIS_PUBLISH_MESSAGE_ELEMNTS ||
+        reply->element[0]->type != REDIS_REPLY_STRING || reply->element[1]->type != REDIS_REPLY_STRING)
+    {
+        SWSS_LOG_ERROR("unexpected redis reply of type %d on the log setting subscription", reply->type);
+        return "";
+    }
+
+    std::string kind(reply->element[0]->str, reply->element[0]->len);
+    std::string channel(reply->element[1]->str, reply->element[1]->len);
+
+    if (kind == "subscribe")
+        return channel;
+
+    if (kind == "message" && channel.size() > CHANNEL_SUFFIX.size() &&
+        channel.compare(channel.size() - CHANNEL_SUFFIX.size(), std::string::npos, CHANNEL_SUFFIX) == 0)
+    {
+        addChanged(changed, channel.substr(0, channel.size() - CHANNEL_SUFFIX.size()));
+    }
+
+    return "";
+}
@@ -0,0 +1,59 @@
+#ifndef __LOGSETTINGWATCHER__
+#define __LOGSETTINGWATCHER__
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "selectable.h"
+#include "dbconnector.h"
+
+namespace swss {
+
+/*
+ * Applies the log settings of all the components linked to the Logger as
+ * soon as they change in LOGLEVEL_DB, with one connection subscribed to the
+ * channels of their tables.
+ *
+ * The Logger's setting thread runs one. An application which called
+ * Logger::linkToDbNative(name, false) adds one to its own Select instead:
+ * the changes are applied when Select reads its data, and it is never
+ * returned as ready, so select() may return TIMEOUT early.
+ */
+class LogSettingWatcher : public Selectable
+{
+public:
+    /* The database is already alive and kicking, no need for more than a second */
+    static constexpr unsigned int SUBSCRIBE_TIMEOUT = 1000;
+
+    LogSettingWatcher(int pri = 0);
+    ~LogSettingWatcher() override;
+
+    int getFd() override;
+    uint64_t readData() override;
+    bool hasData() override;
+
+    /*
+     * SUBSCRIBE to the channel of component and wait until it is effective.
+     * Components notified meanwhile are added to changed.
+     */
+    void watch(const std::string &component, std::vector<std::string> &changed);
+
+private:
+    LogSettingWatcher(const LogSettingWatcher &other);
+    LogSettingWatcher &operator=(const LogSettingWatcher &other);
+
+    /* Returns the channel of a subscribe confirmation, or an empty string */
+    std::string processReply(redisReply *reply, std::vector<std::string> &changed);
+
+    /* Reads the settings, only used from readData() */
+    DBConnector m_db;
+
+    /* Used from readData() and watch(), which may run in another thread */
+    std::unique_ptr<DBConnector> m_subscribe;
+    std::mutex m_mutex;
+};
+
+}
+
+#endif
@@ -7,6 +7,8 @@ using namespace std;
 
 const size_t mac_address_str_length = ETHER_ADDR_LEN*2 + 5; // 6 hexadecimal numbers (two digits each) + 5 delimiters
 
+constexpr size_t MacAddress::STRING_SIZE;
+
 MacAddress::MacAddress()
 {
     memset(m_mac, 0, ETHER_ADDR_LEN);
@@ -29,21 +31,37 @@ const std::string MacAddress::to_string() const
 }
 
 std::string MacAddress::to_string(const uint8_t* mac)
+{
+    char buf[STRING_SIZE];
+    size_t len = MacAddress::to_string(mac, buf, sizeof(buf));
+
+    return std::string(buf, len);
+}
+
+size_t MacAddress::to_string(char *buf, size_t size) const
+{
+    return MacAddress::to_string(m_mac, buf, size);
+}
+
+size_t MacAddress::to_string(const uint8_t *mac, char *buf, size_t size)
 {
     const static char char_table[] = "0123456789abcdef";
 
-    std::string str(mac_address_str_length, ':');
+    if (size < STRING_SIZE)
+    {
+        return 0;
+    }
+
     for(int i = 0; i < ETHER_ADDR_LEN; ++i) {
-        int left = i * 3;      // left  digit position of hexadecimal number
-        int right = left + 1;  // right digit position of hexadecimal number
-        int left_half  = mac[i] >> 4;
-        int right_half = mac[i] & 0x0f;
+        char *digits = buf + i * 3;
 
-        str[left]  = char_table[left_half];
-        str[right] = char_table[right_half];
+        digits[0] = char_table[mac[i] >> 4];
+        digits[1] = char_table[mac[i] & 0x0f];
+        digits[2] = ':';
     }
 
-    return str;
+    buf[mac_address_str_length] = '\0';
+    return mac_address_str_length;
 }
 
 // This function parses a string to a binary mac address (uint8_t[6])
@@ -51,75 +69,55 @@ std::string MacAddress::to_string(const uint8_t* mac)
 // The mac address separators could be either ':' or '-'
 bool MacAddress::parseMacString(const string& str_mac, uint8_t* bin_mac)
 {
-    if (bin_mac == NULL)
-    {
-        return false;
-    }
+    return MacAddress::parseMacString(str_mac.data(), str_mac.length(), bin_mac);
+}
+
+// Value of a hex digit, or a value above 0x0f. Written without branches
+// as digits of random addresses defeat branch prediction
+static inline unsigned int hexDigit(char c)
+{
+    unsigned int digit = static_cast<unsigned int>(static_cast<unsigned char>(c)) - '0';
+    unsigned int alpha = (static_cast<unsigned int>(static_cast<unsigned char>(c)) | 0x20) - 'a';
+    unsigned int isDigit = digit < 10;
+    unsigned int isAlpha = alpha < 6;
 
-    if (str_mac.length() != mac_address_str_length)
+    return (digit & (0u - isDigit)) | ((alpha + 10) & (0u - isAlpha)) | ((1 - (isDigit | isAlpha)) << 8);
+}
+
+bool MacAddress::parseMacString(const char *str_mac, size_t len, uint8_t* bin_mac)
+{
+    if (bin_mac == NULL || len != mac_address_str_length)
     {
         return false;
     }
 
-    const char* ptr_mac = str_mac.c_str();
-
-    // first check that all mac address separators are equal to each other
+    // all separators must be equal to the first one, which is ':' or '-'
     // 2, 5, 8, 11, and 14 are MAC address separator positions
-    if (!(ptr_mac[2]  == ptr_mac[5]
-       && ptr_mac[5]  == ptr_mac[8]
-       && ptr_mac[8]  == ptr_mac[11]
-       && ptr_mac[11] == ptr_mac[14]))
+    char sep = str_mac[2];
+    if ((sep != ':' && sep != '-') ||
+        str_mac[5] != sep || str_mac[8] != sep || str_mac[11] != sep || str_mac[14] != sep)
     {
         return false;
     }
 
-    // then check that the first separator is equal to ':' or '-'
-    if (ptr_mac[2] != ':' && ptr_mac[2] != '-')
+    // invalid digits set bits above the low byte, checked once at the end
+    unsigned int invalid = 0;
+    uint8_t mac[ETHER_ADDR_LEN];
+
+    for(int i = 0; i < ETHER_ADDR_LEN; ++i)
     {
-        return false;
+        unsigned int left = hexDigit(str_mac[i * 3]);
+        unsigned int right = hexDigit(str_mac[i * 3 + 1]);
+
+        invalid |= left | right;
+        mac[i] = static_cast<uint8_t>((left << 4) | (right & 0x0f));
     }
 
-    for(int i = 0; i < ETHER_ADDR_LEN; ++i)
+    if (invalid > 0x0f)
     {
-        int left  = i * 3;    // left  digit position of hexadecimal number
-        int right = left + 1; // right digit position of hexadecimal number
-
-        if (ptr_mac[left] >= '0' && ptr_mac[left] <= '9')
-        {
-            bin_mac[i] = static_cast<uint8_t>(ptr_mac[left] - '0');
-        }
-        else if (ptr_mac[left] >= 'A' && ptr_mac[left] <= 'F')
-        {
-            bin_mac[i] = static_cast<uint8_t>(ptr_mac[left] - 'A' + 0x0a);
-        }
-        else if (ptr_mac[left] >= 'a' && ptr_mac[left] <= 'f')
-        {
-            bin_mac[i] = static_cast<uint8_t>(ptr_mac[left] - 'a' + 0x0a);
-        }
-        else
-        {
-            return false;
-        }
-
-        bin_mac[i] = static_cast<uint8_t>(bin_mac[i] << 4);
-
-        if (ptr_mac[right] >= '0' && ptr_mac[right] <= '9')
-        {
-            bin_mac[i] |= static_cast<uint8_t>(ptr_mac[right] - '0');
-        }
-        else if (ptr_mac[right] >= 'A' && ptr_mac[right] <= 'F')
-        {
-            bin_mac[i] |= static_cast<uint8_t>(ptr_mac[right] - 'A' + 0x0a);
-        }
-        else if (ptr_mac[right] >= 'a' && ptr_mac[right] <= 'f')
-        {
-            bin_mac[i] |= static_cast<uint8_t>(ptr_mac[right] - 'a' + 0x0a);
-        }
-        else
-        {
-            return false;
-        }
+        return false;
     }
 
+    memcpy(bin_mac, mac, ETHER_ADDR_LEN);
     return true;
 }
@@ -5,6 +5,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <string>
+#include <functional>
 
 namespace swss {
 
@@ -12,6 +13,9 @@ class MacAddress
 {
 public:
 
+    /* Buffer size fitting the address string and its terminating null */
+    static constexpr size_t STRING_SIZE = ETHER_ADDR_LEN * 3;
+
     MacAddress();
 
     MacAddress(const uint8_t *mac);
@@ -54,16 +58,51 @@ public:
         return !!(*this);
     }
 
+    /* The six bytes as a 48 bit number, first byte most significant */
+    inline uint64_t toUint64() const
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < ETHER_ADDR_LEN; i++)
+        {
+            value = (value << 8) | m_mac[i];
+        }
+        return value;
+    }
+
     const std::string to_string() const;
 
     static std::string to_string(const uint8_t* mac);
 
+    /*
+     * Write the address string and a terminating null into buf. Returns the
+     * string length, or 0 when size is below STRING_SIZE.
+     */
+    size_t to_string(char *buf, size_t size) const;
+
+    static size_t to_string(const uint8_t *mac, char *buf, size_t size);
+
     static bool parseMacString(const std::string& strmac, uint8_t* mac);
 
+    /* Parse the len characters at strmac, mac is left untouched on failure */
+    static bool parseMacString(const char *strmac, size_t len, uint8_t* mac);
+
 private:
     uint8_t m_mac[ETHER_ADDR_LEN];
 };
 
 }
 
+namespace std {
+
+template<>
+struct hash<swss::MacAddress>
+{
+    size_t operator()(const swss::MacAddress &mac) const
+    {
+        return static_cast<size_t>(mac.toUint64());
+    }
+};
+
+}
+
 #endif
@@ -0,0 +1,274 @@
+#include "metrics.h"
+
+#include <math.h>
+#include <algorithm>
+#include "logger.h"
+#include "schema.h"
+#include "table.h"
+
+using namespace swss;
+
+const size_t Counter::SLOTS;
+const unsigned int Histogram::SUB_BUCKET_BITS;
+const unsigned int Histogram::MAX_BITS;
+const size_t Histogram::BUCKETS;
+
+std::atomic<bool> MetricsRegistry::m_enabled(false);
+
+Counter::Counter()
+{
+    for (auto &slot : m_slots)
+        slot.value.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Counter::value() const
+{
+    uint64_t sum = 0;
+    for (const auto &slot : m_slots)
+        sum += slot.value.load(std::memory_order_relaxed);
+    return sum;
+}
+
+size_t Counter::nextSlot()
+{
+    static std::atomic<size_t> next(0);
+    return next.fetch_add(1, std::memory_order_relaxed) % SLOTS;
+}
+
+uint64_t HistogramSnapshot::percentile(double p) const
+{
+    if (count == 0)
+        return 0;
+
+    uint64_t rank = static_cast<uint64_t>(ceil(p / 100.0 * static_cast<double>(count)));
+    if (rank == 0)
+        rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); bucket++)
+    {
+        seen += buckets[bucket];
+        if (seen >= rank)
+            return std::min(Histogram::bucketHigh(bucket), max);
+    }
+
+    return max;
+}
+
+Histogram::Histogram()
+{
+    for (auto &bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+size_t Histogram::bucketOf(uint64_t value)
+{
+    const uint64_t subBuckets = 1ULL << SUB_BUCKET_BITS;
+
+    if (value < subBuckets)
+        return static_cast<size_t>(value);
+
+    unsigned int exponent = 63 - static_cast<unsigned int>(__builtin_clzll(value));
+    if (exponent >= MAX_BITS)
+        return BUCKETS - 1;
+
+    /* The SUB_BUCKET_BITS bits after the leading one select the bucket */
+    unsigned int shift = exponent - SUB_BUCKET_BITS;
+    return static_cast<size_t>((shift + 1) * subBuckets + ((value >> shift) - subBuckets));
+}
+
+uint64_t Histogram::bucketHigh(size_t bucket)
+{
+    const uint64_t subBuckets = 1ULL << SUB_BUCKET_BITS;
+
+    if (bucket < subBuckets)
+        return bucket;
+
+    if (bucket >= BUCKETS - 1)
+        return UINT64_MAX;
+
+    uint64_t shift = bucket / subBuckets - 1;
+    return ((subBuckets + bucket % subBuckets + 1) << shift) - 1;
+}
+
+void Histogram::record(uint64_t value)
+{
+    m_buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+HistogramSnapshot Histogram::snapshot() const
+{
+    HistogramSnapshot snapshot;
+
+    /* The count is summed from the buckets, to agree with the percentiles while recorded */
+    snapshot.buckets.resize(BUCKETS);
+    snapshot.count = 0;
+    for (size_t bucket = 0; bucket < BUCKETS; bucket++)
+    {
+        snapshot.buckets[bucket] = m_buckets[bucket].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[bucket];
+    }
+
+    snapshot.sum = m_sum.load(std::memory_order_relaxed);
+    snapshot.max = m_max.load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+MetricsRegistry::MetricsRegistry()
+{
+}
+
+MetricsRegistry &MetricsRegistry::getInstance()
+{
+    /* Never destroyed, tables may still count from static destructors */
+    static MetricsRegistry *registry = new MetricsRegistry();
+    return *registry;
+}
+
+void MetricsRegistry::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+Counter &MetricsRegistry::counter(const std::string &group, const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto &counter = m_counters[group][name];
+    if (!counter)
+        counter.reset(new Counter());
+
+    return *counter;
+}
+
+Histogram &MetricsRegistry::histogram(const std::string &group, const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto &histogram = m_histograms[group][name];
+    if (!histogram)
+        histogram.reset(new Histogram());
+
+    return *histogram;
+}
+
+std::map<std::string, std::map<std::string, std::string>> MetricsRegistry::collect()
+{
+    std::map<std::string, std::map<std::string, std::string>> metrics;
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto &group : m_counters)
+    {
+        auto &fields = metrics[group.first];
+        for (const auto &counter : group.second)
+            fields[counter.first] = std::to_string(counter.second->value());
+    }
+
+    for (const auto &group : m_histograms)
+    {
+        auto &fields = metrics[group.first];
+        for (const auto &histogram : group.second)
+        {
+            HistogramSnapshot snapshot = histogram.second->snapshot();
+            const std::string &name = histogram.first;
+
+            fields[name + "_count"] = std::to_string(snapshot.count);
+            fields[name + "_sum"] = std::to_string(snapshot.sum);
+            fields[name + "_p50"] = std::to_string(snapshot.percentile(50));
+            fields[name + "_p90"] = std::to_string(snapshot.percentile(90));
+            fields[name + "_p99"] = std::to_string(snapshot.percentile(99));
+            fields[name + "_max"] = std::to_string(snapshot.max);
+        }
+    }
+
+    return metrics;
+}
+
+std::string MetricsRegistry::tableGroup(const std::string &dbName, const std::string &tableName)
+{
+    if (dbName.empty())
+        return tableName;
+
+    return dbName + ":" + tableName;
+}
+
+/* Concurrent first uses get the same metric from the registry */
+template <>
+Counter &LazyMetric<Counter>::resolve()
+{
+    Counter &counter = MetricsRegistry::getInstance().counter(m_group.name(), m_name);
+    m_metric.store(&counter, std::memory_order_release);
+    return counter;
+}
+
+template <>
+Histogram &LazyMetric<Histogram>::resolve()
+{
+    Histogram &histogram = MetricsRegistry::getInstance().histogram(m_group.name(), m_name);
+    m_metric.store(&histogram, std::memory_order_release);
+    return histogram;
+}
+
+MetricsExporter::MetricsExporter(const std::string &dbName, const std::string &process, unsigned int interval) :
+    m_db(dbName, 0),
+    m_process(process),
+    m_interval(interval),
+    m_stop(false)
+{
+    MetricsRegistry::setEnabled(true);
+    m_thread = std::thread(&MetricsExporter::exportThread, this);
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_cv.notify_one();
+    m_thread.join();
+}
+
+void MetricsExporter::exportMetrics()
+{
+    auto metrics = MetricsRegistry::getInstance().collect();
+
+    std::lock_guard<std::mutex> lock(m_dbMutex);
+    Table table(&m_db, STATE_SWSS_METRICS_TABLE_NAME);
+
+    for (const auto &group : metrics)
+    {
+        std::vector<FieldValueTuple> values(group.second.begin(), group.second.end());
+        table.set(m_process + table.getTableNameSeparator() + group.first, values);
+    }
+}
+
+void MetricsExporter::exportThread()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_cv.wait_for(lock, m_interval, [this] { return m_stop; }))
+    {
+        lock.unlock();
+
+        try
+        {
+            exportMetrics();
+        }
+        catch (const std::exception &e)
+        {
+            SWSS_LOG_ERROR("Failed to export the metrics: %s", e.what());
+        }
+
+        lock.lock();
+    }
+}
@@ -0,0 +1,245 @@
+#ifndef __METRICS__
+#define __METRICS__
+
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "dbconnector.h"
+
+namespace swss {
+
+/*
+ * Counter split in slots updated by different threads, so that add() does
+ * not bounce a cache line between them. value() sums the slots.
+ */
+class Counter
+{
+public:
+    static const size_t SLOTS = 8;
+
+    Counter();
+
+    inline void add(uint64_t n = 1)
+    {
+        m_slots[slot()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+
+private:
+    Counter(const Counter &other);
+    Counter &operator=(const Counter &other);
+
+    struct Slot
+    {
+        std::atomic<uint64_t> value;
+        char pad[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    /* Slot of the calling thread, assigned round robin */
+    static inline size_t slot()
+    {
+        static thread_local size_t index = nextSlot();
+        return index;
+    }
+
+    static size_t nextSlot();
+
+    Slot m_slots[SLOTS];
+};
+
+struct HistogramSnapshot
+{
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    std::vector<uint64_t> buckets;
+
+    /* Largest value of the bucket holding the p-th percentile, 0 <= p <= 100 */
+    uint64_t percentile(double p) const;
+};
+
+/*
+ * HDR style histogram: 16 linear buckets per power of two, so that a value
+ * is known within 1/16 up to 2^40. Larger values fall in the last bucket,
+ * the maximum is exact.
+ */
+class Histogram
+{
+public:
+    static const unsigned int SUB_BUCKET_BITS = 4;
+    static const unsigned int MAX_BITS = 40;
+    static const size_t BUCKETS = (MAX_BITS - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+
+    Histogram();
+
+    void record(uint64_t value);
+
+    HistogramSnapshot snapshot() const;
+
+    static size_t bucketOf(uint64_t value);
+
+    /* Largest value of a bucket */
+    static uint64_t bucketHigh(size_t bucket);
+
+private:
+    Histogram(const Histogram &other);
+    Histogram &operator=(const Histogram &other);
+
+    std::atomic<uint64_t> m_buckets[BUCKETS];
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_max;
+};
+
+/*
+ * Counters and histograms of the process, by group and name. The table
+ * layer feeds it once enabled: a group per table, named by tableGroup(),
+ * and one per RedisPipeline, NotificationConsumer channel and Select.
+ */
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry &getInstance();
+
+    static inline bool isEnabled()
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool enabled);
+
+    /* CLOCK_MONOTONIC ns, for the latencies */
+    static inline uint64_t now()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    /* Created on first use and never destroyed, callers keep the reference */
+    Counter &counter(const std::string &group, const std::string &name);
+    Histogram &histogram(const std::string &group, const std::string &name);
+
+    /*
+     * group -> field -> value. A histogram name gives the fields
+     * name_count, name_sum, name_p50, name_p90, name_p99 and name_max.
+     */
+    std::map<std::string, std::map<std::string, std::string>> collect();
+
+    /* Group of a table, "APPL_DB:ROUTE_TABLE" */
+    static std::string tableGroup(const std::string &dbName, const std::string &tableName);
+
+private:
+    MetricsRegistry();
+    MetricsRegistry(const MetricsRegistry &other);
+    MetricsRegistry &operator=(const MetricsRegistry &other);
+
+    std::mutex m_mutex;
+    std::map<std::string, std::map<std::string, std::unique_ptr<Counter>>> m_counters;
+    std::map<std::string, std::map<std::string, std::unique_ptr<Histogram>>> m_histograms;
+
+    static std::atomic<bool> m_enabled;
+};
+
+/*
+ * Group of the metrics of an object of the table layer. Only keeps the
+ * parts of the name: the group is built by the first metric used.
+ */
+class MetricsGroup
+{
+public:
+    MetricsGroup(const std::string &dbName, const std::string &tableName) :
+        m_dbName(dbName), m_tableName(tableName)
+    {
+    }
+
+    std::string name() const
+    {
+        return MetricsRegistry::tableGroup(m_dbName, m_tableName);
+    }
+
+private:
+    std::string m_dbName;
+    std::string m_tableName;
+};
+
+/*
+ * Counter or Histogram of a group, looked up in the registry on first
+ * use. Objects built while the metrics are disabled never take the
+ * registry lock. The group must outlive the metric.
+ */
+template <typename Metric>
+class LazyMetric
+{
+public:
+    LazyMetric(const MetricsGroup &group, const char *name) :
+        m_group(group), m_name(name), m_metric(nullptr)
+    {
+    }
+
+    inline Metric &get()
+    {
+        Metric *metric = m_metric.load(std::memory_order_acquire);
+        return metric != nullptr ? *metric : resolve();
+    }
+
+private:
+    LazyMetric(const LazyMetric &other);
+    LazyMetric &operator=(const LazyMetric &other);
+
+    Metric &resolve();
+
+    const MetricsGroup &m_group;
+    const char *m_name;
+    std::atomic<Metric *> m_metric;
+};
+
+template <> Counter &LazyMetric<Counter>::resolve();
+template <> Histogram &LazyMetric<Histogram>::resolve();
+
+/*
+ * Writes MetricsRegistry::collect() into the SWSS_METRICS_TABLE of a
+ * database every interval, from its own thread, under the keys
+ * <process><separator><group>. Enables the registry.
+ */
+class MetricsExporter
+{
+public:
+    static constexpr unsigned int DEFAULT_INTERVAL = 10000;     /* ms */
+
+    MetricsExporter(const std::string &dbName, const std::string &process, unsigned int interval = DEFAULT_INTERVAL);
+    ~MetricsExporter();
+
+    /* Export now, from the calling thread */
+    void exportMetrics();
+
+private:
+    MetricsExporter(const MetricsExporter &other);
+    MetricsExporter &operator=(const MetricsExporter &other);
+
+    void exportThread();
+
+    DBConnector m_db;
+    std::string m_process;
+    std::chrono::milliseconds m_interval;
+
+    /* Serializes the exports of the thread and of exportMetrics() */
+    std::mutex m_dbMutex;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop;
+    std::thread m_thread;
+};
+
+}
+
+#endif
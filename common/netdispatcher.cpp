@@ -1,11 +1,31 @@
+#include "common/logger.h"
 #include "common/netdispatcher.h"
 
 #include <map>
+#include <set>
 
 using namespace swss;
 
 #define MUTEX std::lock_guard<std::mutex> _lock(m_mutex);
 
+static inline bool inTable(int nlmsg_type)
+{
+    return nlmsg_type >= 0 && nlmsg_type < NetDispatcher::DISPATCH_TABLE_SIZE;
+}
+
+NetDispatcher::NetDispatcher()
+{
+    for (auto &slot : m_table)
+    {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+
+    for (auto &slot : m_rawTable)
+    {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
 NetDispatcher& NetDispatcher::getInstance()
 {
     static NetDispatcher gInstance;
@@ -17,16 +37,49 @@ void NetDispatcher::registerMessageHandler(int nlmsg_type, NetMsg *callback)
 {
     MUTEX;
 
+    if (inTable(nlmsg_type))
+    {
+        if (m_table[nlmsg_type].load(std::memory_order_relaxed) != nullptr ||
+            m_rawTable[nlmsg_type].load(std::memory_order_relaxed) != nullptr)
+            throw "Trying to register on already registerd netlink message";
+
+        m_table[nlmsg_type].store(callback, std::memory_order_release);
+        return;
+    }
+
     if (m_handlers.find(nlmsg_type) != m_handlers.end())
         throw "Trying to register on already registerd netlink message";
 
     m_handlers[nlmsg_type] = callback;
 }
 
+void NetDispatcher::registerRawMessageHandler(int nlmsg_type, RawNetMsg *callback)
+{
+    MUTEX;
+
+    if (!inTable(nlmsg_type))
+        throw "Raw netlink message handlers are limited to the dispatch table";
+
+    if (m_table[nlmsg_type].load(std::memory_order_relaxed) != nullptr ||
+        m_rawTable[nlmsg_type].load(std::memory_order_relaxed) != nullptr)
+        throw "Trying to register on already registerd netlink message";
+
+    m_rawTable[nlmsg_type].store(callback, std::memory_order_release);
+}
+
 void NetDispatcher::unregisterMessageHandler(int nlmsg_type)
 {
     MUTEX;
 
+    if (inTable(nlmsg_type))
+    {
+        if (m_table[nlmsg_type].load(std::memory_order_relaxed) == nullptr)
+            throw "Trying to unregister non existing handler";
+
+        m_table[nlmsg_type].store(nullptr, std::memory_order_release);
+        return;
+    }
+
     auto it = m_handlers.find(nlmsg_type);
 
     if (it == m_handlers.end())
@@ -35,6 +88,16 @@ void NetDispatcher::unregisterMessageHandler(int nlmsg_type)
     m_handlers.erase(it);
 }
 
+void NetDispatcher::unregisterRawMessageHandler(int nlmsg_type)
+{
+    MUTEX;
+
+    if (!inTable(nlmsg_type) || m_rawTable[nlmsg_type].load(std::memory_order_relaxed) == nullptr)
+        throw "Trying to unregister non existing handler";
+
+    m_rawTable[nlmsg_type].store(nullptr, std::memory_order_release);
+}
+
 void NetDispatcher::nlCallback(struct nl_object *obj, void *context)
 {
     NetMsg *callback = (NetMsg *)context;
@@ -43,6 +106,10 @@ void NetDispatcher::nlCallback(struct nl_object *obj, void *context)
 
 NetMsg* NetDispatcher::getCallback(int nlmsg_type)
 {
+    /* Fast path, no lock is taken for message types in the table */
+    if (inTable(nlmsg_type))
+        return m_table[nlmsg_type].load(std::memory_order_acquire);
+
     MUTEX;
 
     auto callback = m_handlers.find(nlmsg_type);
@@ -53,10 +120,26 @@ NetMsg* NetDispatcher::getCallback(int nlmsg_type)
     return callback->second;
 }
 
+RawNetMsg* NetDispatcher::getRawCallback(int nlmsg_type)
+{
+    if (!inTable(nlmsg_type))
+        return nullptr;
+
+    return m_rawTable[nlmsg_type].load(std::memory_order_acquire);
+}
+
 void NetDispatcher::onNetlinkMessage(struct nl_msg *msg)
 {
     struct nlmsghdr *nlmsghdr = nlmsg_hdr(msg);
 
+    /* Raw handlers skip libnl object construction */
+    auto raw = getRawCallback(nlmsghdr->nlmsg_type);
+    if (raw != nullptr)
+    {
+        raw->onMsg(nlmsghdr->nlmsg_type, nlmsghdr);
+        return;
+    }
+
     auto callback = getCallback(nlmsghdr->nlmsg_type);
 
     /* Drop not registered messages */
@@ -65,3 +148,74 @@ void NetDispatcher::onNetlinkMessage(struct nl_msg *msg)
 
     nl_msg_parse(msg, NetDispatcher::nlCallback, (callback));
 }
+
+void NetDispatcher::onNetlinkMessage(struct nlmsghdr *nlmsghdr, int protocol)
+{
+    auto raw = getRawCallback(nlmsghdr->nlmsg_type);
+    if (raw != nullptr)
+    {
+        raw->onMsg(nlmsghdr->nlmsg_type, nlmsghdr);
+        return;
+    }
+
+    auto callback = getCallback(nlmsghdr->nlmsg_type);
+
+    /* Drop not registered messages */
+    if (callback == nullptr)
+        return;
+
+    /* libnl handlers need the message wrapped into nl_msg */
+    struct nl_msg *msg = nlmsg_convert(nlmsghdr);
+    if (msg == nullptr)
+    {
+        SWSS_LOG_ERROR("Unable to allocate netlink message of type %d", nlmsghdr->nlmsg_type);
+        return;
+    }
+
+    nlmsg_set_proto(msg, protocol);
+    nl_msg_parse(msg, NetDispatcher::nlCallback, (callback));
+    nlmsg_free(msg);
+}
+
+void NetDispatcher::notifyResync(const std::vector<int> &nlmsg_types, bool begin)
+{
+    std::set<NetMsg*> callbacks;
+    std::set<RawNetMsg*> rawCallbacks;
+
+    for (int nlmsg_type : nlmsg_types)
+    {
+        auto raw = getRawCallback(nlmsg_type);
+        if (raw != nullptr)
+            rawCallbacks.insert(raw);
+
+        auto callback = getCallback(nlmsg_type);
+        if (callback != nullptr)
+            callbacks.insert(callback);
+    }
+
+    for (auto callback : callbacks)
+    {
+        if (begin)
+            callback->onResyncBegin();
+        else
+            callback->onResyncEnd();
+    }
+
+    for (auto raw : rawCallbacks)
+    {
+        if (begin)
+            raw->onResyncBegin();
+        else
+            raw->onResyncEnd();
+    }
+}
+
+void NetDispatcher::onResyncBegin(const std::vector<int> &nlmsg_types)
+{
+    notifyResync(nlmsg_types, true);
+}
+
+void NetDispatcher::onResyncEnd(const std::vector<int> &nlmsg_types)
+{
+    notifyResync(nlmsg_types, false);
+}
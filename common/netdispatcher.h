@@ -4,8 +4,10 @@
 
 #include <netlink/msg.h>
 
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <vector>
 
 namespace swss
 {
@@ -13,6 +15,16 @@ namespace swss
     {
         public:
 
+            /**
+             * Size of the lock-free dispatch table.
+             *
+             * Covers all rtnetlink message types and nfnetlink message types
+             * (subsystem id << 8 | message id) of the subsystems in use.
+             * Handlers of message types beyond this range are kept in a map
+             * protected by the mutex.
+             */
+            static constexpr int DISPATCH_TABLE_SIZE = 4096;
+
             /** Get singlton instance. */
             static NetDispatcher& getInstance();
 
@@ -23,9 +35,32 @@ namespace swss
              */
             void registerMessageHandler(int nlmsg_type, NetMsg *callback);
 
+            /**
+             * Register raw callback class according to message-type.
+             *
+             * Raw callbacks get the message without libnl object construction.
+             * Throw exception if any callback is already registered for the
+             * message-type, or if it is beyond DISPATCH_TABLE_SIZE.
+             */
+            void registerRawMessageHandler(int nlmsg_type, RawNetMsg *callback);
+
             /** Called by NetLink or FpmLink classes as indication of new packet arrival. */
             void onNetlinkMessage(struct nl_msg *msg);
 
+            /**
+             * Same as above for a message read directly from the socket,
+             * protocol is the netlink family the message was received on.
+             */
+            void onNetlinkMessage(struct nlmsghdr *nlmsghdr, int protocol);
+
+            /**
+             * Called by NetLink when a resync of the given message types
+             * starts or ends. Each handler registered for any of the types
+             * is notified once.
+             */
+            void onResyncBegin(const std::vector<int> &nlmsg_types);
+            void onResyncEnd(const std::vector<int> &nlmsg_types);
+
             /**
              * Unregister callback according to message-type.
              *
@@ -33,22 +68,43 @@ namespace swss
              */
             void unregisterMessageHandler(int nlmsg_type);
 
+            /**
+             * Unregister raw callback according to message-type.
+             *
+             * Throw exception if raw callback is not registered.
+             */
+            void unregisterRawMessageHandler(int nlmsg_type);
+
         private:
 
-            NetDispatcher() = default;
+            NetDispatcher();
 
             NetDispatcher(const NetDispatcher&) = delete;
 
             NetMsg* getCallback(int nlmsg_type);
 
+            RawNetMsg* getRawCallback(int nlmsg_type);
+
+            void notifyResync(const std::vector<int> &nlmsg_types, bool begin);
+
         private:
 
             /** nl_msg_parse callback API */
             static void nlCallback(struct nl_object *obj, void *context);
 
+            /**
+             * Handlers indexed by message type, read without locking on the
+             * message path. Slots are only written under m_mutex.
+             */
+            std::atomic<NetMsg*> m_table[DISPATCH_TABLE_SIZE];
+
+            /** Raw handlers indexed by message type, same rules as m_table. */
+            std::atomic<RawNetMsg*> m_rawTable[DISPATCH_TABLE_SIZE];
+
+            /** Handlers of message types outside of m_table. */
             std::map<int, NetMsg*> m_handlers;
 
-            /** Mutex protecting register, unregister and get callback methods. */
+            /** Mutex protecting register, unregister and m_handlers. */
             std::mutex m_mutex;
     };
 }
@@ -11,7 +11,8 @@ using namespace swss;
 using namespace std;
 
 NetLink::NetLink(int pri) :
-    Selectable(pri), m_socket(NULL)
+    Selectable(pri), m_socket(NULL), m_recvBufSize(0),
+    m_resync(DEFAULT_SOCK_BUF_SIZE)
 {
     m_socket = nl_socket_alloc();
     if (!m_socket)
@@ -23,6 +24,7 @@ NetLink::NetLink(int pri) :
 
     nl_socket_disable_seq_check(m_socket);
     nl_socket_modify_cb(m_socket, NL_CB_VALID, NL_CB_CUSTOM, onNetlinkMsg, this);
+    nl_socket_modify_cb(m_socket, NL_CB_FINISH, NL_CB_CUSTOM, onNetlinkFinish, this);
 
     int err = nl_connect(m_socket, NETLINK_ROUTE);
     if (err < 0)
@@ -35,8 +37,7 @@ NetLink::NetLink(int pri) :
     }
 
     nl_socket_set_nonblocking(m_socket);
-    /* Set socket buffer size to 3MB */
-    nl_socket_set_buffer_size(m_socket, 3145728, 0);
+    nl_socket_set_buffer_size(m_socket, DEFAULT_SOCK_BUF_SIZE, 0);
 }
 
 NetLink::~NetLink()
@@ -72,6 +73,63 @@ void NetLink::dumpRequest(int rtmGetCommand)
     }
 }
 
+bool NetLink::setSockBufSize(uint32_t sockBufSize)
+{
+    if (nl_socket_set_buffer_size(m_socket, sockBufSize, 0) < 0)
+    {
+        return false;
+    }
+    m_resync.setSockBufSize(sockBufSize);
+    return true;
+}
+
+void NetLink::enableAutoResync(const vector<int> &rtmGetCommands)
+{
+    m_resync.setCommands(rtmGetCommands);
+}
+
+void NetLink::setAdaptiveSockBufSize(uint32_t maxSockBufSize)
+{
+    m_resync.setMaxSockBufSize(maxSockBufSize);
+}
+
+uint64_t NetLink::getOverflowCount() const
+{
+    return m_resync.getOverflowCount();
+}
+
+uint64_t NetLink::getResyncCount() const
+{
+    return m_resync.getResyncCount();
+}
+
+uint32_t NetLink::getSockBufSize() const
+{
+    return m_resync.getSockBufSize();
+}
+
+bool NetLink::isResyncInProgress() const
+{
+    return m_resync.isResyncInProgress();
+}
+
+void NetLink::setBatchedRecv(unsigned int batchSize, size_t bufSize)
+{
+    m_recvBufSize = NLMSG_ALIGN(bufSize);
+    m_recvBuffers.assign(batchSize * m_recvBufSize, 0);
+    m_recvIovecs.resize(batchSize);
+    m_recvMsgs.resize(batchSize);
+
+    for (unsigned int i = 0; i < batchSize; i++)
+    {
+        m_recvIovecs[i].iov_base = &m_recvBuffers[i * m_recvBufSize];
+        m_recvIovecs[i].iov_len = m_recvBufSize;
+        memset(&m_recvMsgs[i], 0, sizeof(m_recvMsgs[i]));
+        m_recvMsgs[i].msg_hdr.msg_iov = &m_recvIovecs[i];
+        m_recvMsgs[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
 int NetLink::getFd()
 {
     return nl_socket_get_fd(m_socket);
@@ -79,6 +137,13 @@ int NetLink::getFd()
 
 uint64_t NetLink::readData()
 {
+    if (!m_recvMsgs.empty())
+    {
+        readBatched();
+        m_resync.continueResync(m_socket);
+        return 0;
+    }
+
     int err;
 
     do
@@ -90,17 +155,69 @@ uint64_t NetLink::readData()
     if (err < 0)
     {
         if (err == -NLE_NOMEM)
-            SWSS_LOG_ERROR("netlink reports out of memory on reading a netlink socket. High possiblity of a lost message");
+            m_resync.onOverflow(m_socket);
         else if (err == -NLE_AGAIN)
             SWSS_LOG_DEBUG("netlink reports NLE_AGAIN on reading a netlink socket");
         else
+        {
             SWSS_LOG_ERROR("netlink reports an error=%d on reading a netlink socket", err);
+            m_resync.onDumpError();
+        }
     }
+
+    m_resync.continueResync(m_socket);
     return 0;
 }
 
+void NetLink::readBatched()
+{
+    unsigned int batchSize = static_cast<unsigned int>(m_recvMsgs.size());
+    int received;
+
+    do
+    {
+        for (auto &msg : m_recvMsgs)
+        {
+            msg.msg_hdr.msg_flags = 0;
+        }
+
+        received = recvmmsg(getFd(), m_recvMsgs.data(), batchSize, MSG_DONTWAIT, NULL);
+        if (received < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            if (errno == ENOBUFS)
+                m_resync.onOverflow(m_socket);
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+                SWSS_LOG_DEBUG("netlink reports EAGAIN on reading a netlink socket");
+            else
+                SWSS_LOG_ERROR("netlink reports an error=%d on reading a netlink socket", errno);
+            return;
+        }
+
+        for (int i = 0; i < received; i++)
+        {
+            if (m_recvMsgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                SWSS_LOG_ERROR("netlink datagram truncated, receive buffer of %zu bytes is too small", m_recvBufSize);
+                continue;
+            }
+
+            m_resync.dispatchDatagram(static_cast<const char *>(m_recvIovecs[i].iov_base), m_recvMsgs[i].msg_len);
+        }
+    }
+    while (received < 0 || static_cast<unsigned int>(received) == batchSize);
+}
+
 int NetLink::onNetlinkMsg(struct nl_msg *msg, void *arg)
 {
     NetDispatcher::getInstance().onNetlinkMessage(msg);
     return NL_OK;
 }
+
+int NetLink::onNetlinkFinish(struct nl_msg *msg, void *arg)
+{
+    static_cast<NetLink *>(arg)->m_resync.onDumpDone();
+    return NL_STOP;
+}
@@ -1,10 +1,15 @@
 #pragma once
 
 #include "selectable.h"
+#include "netlinkresync.h"
 
 #include <netlink/netlink.h>
 #include <netlink/route/rtnl.h>
 
+#include <sys/socket.h>
+
+#include <vector>
+
 namespace swss
 {
     class NetLink :
@@ -15,16 +20,63 @@ namespace swss
             NetLink(int pri = 0);
             virtual ~NetLink();
 
+            /* Default socket receive buffer size, 3MB */
+            static constexpr uint32_t DEFAULT_SOCK_BUF_SIZE = 3145728;
+
+            /* Defaults of the batched receive mode */
+            static constexpr unsigned int DEFAULT_RECV_BATCH_SIZE = 32;
+            static constexpr size_t DEFAULT_RECV_BUF_SIZE = 32768;
+
             void registerGroup(int rtnlGroup);
             void dumpRequest(int rtmGetCommand);
 
+            bool setSockBufSize(uint32_t sockBufSize);
+
+            /*
+             * Receive with recvmmsg into batchSize preallocated buffers of
+             * bufSize bytes each, and dispatch every datagram available on
+             * each readData call instead of one datagram through libnl.
+             * A batchSize of 0 restores the libnl receive path.
+             */
+            void setBatchedRecv(unsigned int batchSize = DEFAULT_RECV_BATCH_SIZE,
+                                size_t bufSize = DEFAULT_RECV_BUF_SIZE);
+
+            /*
+             * On socket overflow, replay a dump of each of rtmGetCommands
+             * one after the other. Handlers of the dumped message types are
+             * notified before the first dump and after the last one, so they
+             * can reconcile their state with the kernel.
+             */
+            void enableAutoResync(const std::vector<int> &rtmGetCommands);
+
+            /*
+             * Double the socket receive buffer size on every overflow, up to
+             * maxSockBufSize. 0 disables the growth.
+             */
+            void setAdaptiveSockBufSize(uint32_t maxSockBufSize);
+
+            uint64_t getOverflowCount() const;
+            uint64_t getResyncCount() const;
+            uint32_t getSockBufSize() const;
+            bool isResyncInProgress() const;
+
             int getFd() override;
             uint64_t readData() override;
 
         private:
 
             static int onNetlinkMsg(struct nl_msg *msg, void *arg);
+            static int onNetlinkFinish(struct nl_msg *msg, void *arg);
+
+            void readBatched();
 
             struct nl_sock *m_socket;
+
+            size_t m_recvBufSize;
+            std::vector<char> m_recvBuffers;
+            std::vector<struct iovec> m_recvIovecs;
+            std::vector<struct mmsghdr> m_recvMsgs;
+
+            NetLinkResync m_resync;
     };
 }
@@ -0,0 +1,203 @@
+#include "common/logger.h"
+#include "common/netlinkresync.h"
+#include "common/netdispatcher.h"
+
+#include <netlink/route/rtnl.h>
+#include <sys/socket.h>
+
+#include <inttypes.h>
+
+using namespace swss;
+using namespace std;
+
+NetLinkResync::NetLinkResync(uint32_t sockBufSize) :
+    m_step(0), m_active(false), m_restart(false), m_dumpInFlight(false),
+    m_sockBufSize(sockBufSize), m_maxSockBufSize(0),
+    m_overflowCount(0), m_resyncCount(0)
+{
+}
+
+void NetLinkResync::setCommands(const vector<int> &rtmGetCommands)
+{
+    m_commands = rtmGetCommands;
+}
+
+void NetLinkResync::setMaxSockBufSize(uint32_t maxSockBufSize)
+{
+    m_maxSockBufSize = maxSockBufSize;
+}
+
+void NetLinkResync::setSockBufSize(uint32_t sockBufSize)
+{
+    m_sockBufSize = sockBufSize;
+}
+
+uint64_t NetLinkResync::getOverflowCount() const
+{
+    return m_overflowCount;
+}
+
+uint64_t NetLinkResync::getResyncCount() const
+{
+    return m_resyncCount;
+}
+
+uint32_t NetLinkResync::getSockBufSize() const
+{
+    return m_sockBufSize;
+}
+
+bool NetLinkResync::isResyncInProgress() const
+{
+    return m_active;
+}
+
+void NetLinkResync::noteOverflow(struct nl_sock *socket)
+{
+    m_overflowCount++;
+    SWSS_LOG_ERROR("netlink socket overflow (%" PRIu64 " so far). High possiblity of a lost message", m_overflowCount.load());
+
+    growSockBuf(socket);
+}
+
+void NetLinkResync::startResync()
+{
+    if (m_commands.empty())
+        return;
+
+    /* Events lost while dumping may concern objects already dumped */
+    if (m_active)
+    {
+        m_restart = true;
+        return;
+    }
+
+    m_resyncCount++;
+    m_active = true;
+    m_restart = false;
+    m_step = 0;
+
+    SWSS_LOG_NOTICE("Starting netlink resync");
+    NetDispatcher::getInstance().onResyncBegin(getResyncMessageTypes());
+}
+
+void NetLinkResync::onOverflow(struct nl_sock *socket)
+{
+    noteOverflow(socket);
+    startResync();
+}
+
+void NetLinkResync::onDumpDone()
+{
+    /* Ignore the end of dumps requested through dumpRequest */
+    if (!m_active || !m_dumpInFlight)
+        return;
+
+    m_dumpInFlight = false;
+
+    if (m_restart)
+    {
+        m_restart = false;
+        m_step = 0;
+        return;
+    }
+
+    if (++m_step < m_commands.size())
+        return;
+
+    m_active = false;
+
+    SWSS_LOG_NOTICE("Finished netlink resync");
+    NetDispatcher::getInstance().onResyncEnd(getResyncMessageTypes());
+}
+
+void NetLinkResync::onDumpError()
+{
+    /* The dump request was rejected, e.g. another dump is in progress. It is sent again by continueResync */
+    m_dumpInFlight = false;
+}
+
+void NetLinkResync::continueResync(struct nl_sock *socket)
+{
+    if (!m_active || m_dumpInFlight)
+        return;
+
+    int cmd = m_commands[m_step];
+    int err = nl_rtgen_request(socket, cmd, AF_UNSPEC, NLM_F_DUMP);
+    if (err < 0)
+    {
+        SWSS_LOG_ERROR("Unable to request resync dump on group %d: %s", cmd, nl_geterror(err));
+        return;
+    }
+
+    m_dumpInFlight = true;
+}
+
+void NetLinkResync::dispatchDatagram(const char *buf, size_t len)
+{
+    int remaining = static_cast<int>(len);
+
+    /* Handlers get const headers, NLMSG_NEXT only moves the pointer */
+    for (auto hdr = reinterpret_cast<struct nlmsghdr *>(const_cast<char *>(buf));
+         NLMSG_OK(hdr, remaining); hdr = NLMSG_NEXT(hdr, remaining))
+    {
+        if (hdr->nlmsg_type == NLMSG_ERROR)
+        {
+            auto err = static_cast<struct nlmsgerr *>(NLMSG_DATA(hdr));
+            if (hdr->nlmsg_len >= NLMSG_LENGTH(sizeof(*err)) && err->error != 0)
+            {
+                SWSS_LOG_ERROR("netlink reports an error=%d in a netlink message", err->error);
+                onDumpError();
+            }
+            continue;
+        }
+
+        if (hdr->nlmsg_type == NLMSG_DONE)
+        {
+            onDumpDone();
+            continue;
+        }
+
+        /* NLMSG_NOOP and NLMSG_OVERRUN carry no data */
+        if (hdr->nlmsg_type < NLMSG_MIN_TYPE)
+            continue;
+
+        NetDispatcher::getInstance().onNetlinkMessage(hdr, NETLINK_ROUTE);
+    }
+}
+
+void NetLinkResync::growSockBuf(struct nl_sock *socket)
+{
+    uint32_t current = m_sockBufSize;
+    uint32_t maxSockBufSize = m_maxSockBufSize;
+    if (current >= maxSockBufSize)
+        return;
+
+    uint32_t sockBufSize = (current > maxSockBufSize / 2) ? maxSockBufSize : current * 2;
+    int value = static_cast<int>(sockBufSize);
+
+    /* SO_RCVBUFFORCE lets a privileged process go beyond net.core.rmem_max */
+    if (setsockopt(nl_socket_get_fd(socket), SOL_SOCKET, SO_RCVBUFFORCE, &value, sizeof(value)) < 0 &&
+        nl_socket_set_buffer_size(socket, value, 0) < 0)
+    {
+        SWSS_LOG_ERROR("Unable to grow netlink socket buffer size to %u", sockBufSize);
+        return;
+    }
+
+    m_sockBufSize = sockBufSize;
+    SWSS_LOG_NOTICE("Netlink socket buffer size grown to %u", sockBufSize);
+}
+
+vector<int> NetLinkResync::getResyncMessageTypes() const
+{
+    vector<int> types;
+
+    /* rtnetlink message types are laid out as RTM_NEWxxx, RTM_DELxxx, RTM_GETxxx */
+    for (int cmd : m_commands)
+    {
+        types.push_back(cmd - 2);
+        types.push_back(cmd - 1);
+    }
+
+    return types;
+}
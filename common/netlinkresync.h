@@ -0,0 +1,77 @@
+#pragma once
+
+#include <netlink/netlink.h>
+
+#include <atomic>
+#include <vector>
+
+namespace swss
+{
+    /*
+     * Overflow recovery of a NETLINK_ROUTE socket, shared by NetLink and
+     * ThreadedNetLink.
+     *
+     * On socket overflow the receive buffer is grown and a dump of each
+     * of the resync commands is requested one after the other. Handlers of
+     * the dumped message types are notified through NetDispatcher before
+     * the first dump and after the last one, so they can reconcile their
+     * state with the kernel.
+     *
+     * noteOverflow() may be called from a receive thread. The resync state
+     * and dispatch are used from the thread dispatching the messages.
+     */
+    class NetLinkResync
+    {
+        public:
+
+            NetLinkResync(uint32_t sockBufSize);
+
+            void setCommands(const std::vector<int> &rtmGetCommands);
+            void setMaxSockBufSize(uint32_t maxSockBufSize);
+            void setSockBufSize(uint32_t sockBufSize);
+
+            uint64_t getOverflowCount() const;
+            uint64_t getResyncCount() const;
+            uint32_t getSockBufSize() const;
+            bool isResyncInProgress() const;
+
+            /* Count the overflow and grow the buffer of socket */
+            void noteOverflow(struct nl_sock *socket);
+
+            /* Start a resync, or restart the one in progress */
+            void startResync();
+
+            /* noteOverflow() followed by startResync() */
+            void onOverflow(struct nl_sock *socket);
+
+            void onDumpDone();
+            void onDumpError();
+
+            /* Send the dump request of the current resync step if none is in flight */
+            void continueResync(struct nl_sock *socket);
+
+            /*
+             * Dispatch the messages of a datagram through NetDispatcher.
+             * NLMSG_DONE and NLMSG_ERROR drive the resync.
+             */
+            void dispatchDatagram(const char *buf, size_t len);
+
+        private:
+
+            void growSockBuf(struct nl_sock *socket);
+            std::vector<int> getResyncMessageTypes() const;
+
+            std::vector<int> m_commands;
+            size_t m_step;
+            bool m_active;
+            bool m_restart;
+            bool m_dumpInFlight;
+
+            /* Set from the dispatching thread, read by growSockBuf on the receive thread */
+            std::atomic<uint32_t> m_sockBufSize;
+            std::atomic<uint32_t> m_maxSockBufSize;
+
+            std::atomic<uint64_t> m_overflowCount;
+            std::atomic<uint64_t> m_resyncCount;
+    };
+}
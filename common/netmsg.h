@@ -9,5 +9,27 @@ namespace swss
         public:
             /* Called by NetDispatcher when netmsg matches filters */
             virtual void onMsg(int nlmsg_type, struct nl_object *obj) = 0;
+
+            /*
+             * Called by NetDispatcher around a resync dump, after messages
+             * were lost on a socket overflow. Objects not refreshed between
+             * the two calls are gone from the kernel.
+             */
+            virtual void onResyncBegin() {}
+            virtual void onResyncEnd() {}
+    };
+
+    class RawNetMsg
+    {
+        public:
+            /*
+             * Called by NetDispatcher with the message as received, no libnl
+             * object is built. Use the views in netmsgview.h to read it.
+             */
+            virtual void onMsg(int nlmsg_type, const struct nlmsghdr *hdr) = 0;
+
+            /* Same as NetMsg::onResyncBegin and NetMsg::onResyncEnd */
+            virtual void onResyncBegin() {}
+            virtual void onResyncEnd() {}
     };
 }
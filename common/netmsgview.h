@@ -0,0 +1,493 @@
+#pragma once
+
+#include "ipaddress.h"
+#include "ipprefix.h"
+#include "macaddress.h"
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/neighbour.h>
+#include <linux/if_link.h>
+#include <linux/netfilter/nfnetlink.h>
+#include <linux/netfilter/nfnetlink_conntrack.h>
+#include <linux/netfilter/nf_conntrack_common.h>
+#include <arpa/inet.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+namespace swss
+{
+    /**
+     * Index of the rtattr TLVs found in a buffer, by attribute type.
+     *
+     * Netlink attributes (struct nlattr) have the same layout, so this also
+     * indexes nfnetlink messages and nested attributes.
+     */
+    template <int MaxAttr>
+    class RtAttrTable
+    {
+        public:
+
+            RtAttrTable()
+            {
+                memset(m_attrs, 0, sizeof(m_attrs));
+            }
+
+            RtAttrTable(const void *data, size_t len)
+            {
+                memset(m_attrs, 0, sizeof(m_attrs));
+
+                auto base = static_cast<const char *>(data);
+                size_t offset = 0;
+
+                while (offset + sizeof(struct rtattr) <= len)
+                {
+                    auto rta = reinterpret_cast<const struct rtattr *>(base + offset);
+
+                    if (rta->rta_len < sizeof(struct rtattr) || offset + rta->rta_len > len)
+                        break;
+
+                    int type = rta->rta_type & NLA_TYPE_MASK;
+                    if (type <= MaxAttr)
+                        m_attrs[type] = rta;
+
+                    offset += RTA_ALIGN(rta->rta_len);
+                }
+            }
+
+            const struct rtattr *get(int type) const
+            {
+                if (type < 0 || type > MaxAttr)
+                    return nullptr;
+
+                return m_attrs[type];
+            }
+
+            const void *getData(int type) const
+            {
+                auto rta = get(type);
+
+                return rta ? reinterpret_cast<const char *>(rta) + RTA_LENGTH(0) : nullptr;
+            }
+
+            size_t getLen(int type) const
+            {
+                auto rta = get(type);
+
+                return rta ? RTA_PAYLOAD(rta) : 0;
+            }
+
+            bool getFixed(int type, void *value, size_t size) const
+            {
+                if (getLen(type) < size)
+                    return false;
+
+                memcpy(value, getData(type), size);
+                return true;
+            }
+
+            bool getIp(int type, uint8_t family, IpAddress &ip) const
+            {
+                ip_addr_t addr;
+                size_t size;
+
+                switch (family)
+                {
+                    case AF_INET:
+                        size = sizeof(addr.ip_addr.ipv4_addr);
+                        break;
+                    case AF_INET6:
+                        size = sizeof(addr.ip_addr.ipv6_addr);
+                        break;
+                    default:
+                        return false;
+                }
+
+                addr.family = family;
+                if (!getFixed(type, &addr.ip_addr, size))
+                    return false;
+
+                ip = IpAddress(addr);
+                return true;
+            }
+
+            bool getMac(int type, MacAddress &mac) const
+            {
+                if (getLen(type) != ETHER_ADDR_LEN)
+                    return false;
+
+                mac = MacAddress(static_cast<const uint8_t *>(getData(type)));
+                return true;
+            }
+
+        private:
+
+            const struct rtattr *m_attrs[MaxAttr + 1];
+    };
+
+    /**
+     * Zero-copy view over a raw rtnetlink message.
+     *
+     * The rtattr TLVs following the family header are indexed once on
+     * construction. The view only keeps pointers into the message buffer,
+     * so it must not outlive the message it was built from.
+     */
+    template <typename FamilyHdr, int MaxAttr>
+    class RtnlMsgView
+    {
+        public:
+
+            RtnlMsgView(const struct nlmsghdr *hdr) :
+                m_hdr(hdr), m_family(nullptr)
+            {
+                if (hdr->nlmsg_len < NLMSG_LENGTH(sizeof(FamilyHdr)))
+                    return;
+
+                const char *data = static_cast<const char *>(NLMSG_DATA(hdr));
+                m_family = reinterpret_cast<const FamilyHdr *>(data);
+
+                size_t offset = NLMSG_ALIGN(sizeof(FamilyHdr));
+                size_t len = hdr->nlmsg_len - NLMSG_LENGTH(0);
+
+                if (offset < len)
+                    m_attrs = RtAttrTable<MaxAttr>(data + offset, len - offset);
+            }
+
+            /** False if the message is too short to hold the family header. */
+            bool isValid() const
+            {
+                return m_family != nullptr;
+            }
+
+            int getType() const
+            {
+                return m_hdr->nlmsg_type;
+            }
+
+            const struct nlmsghdr *getHeader() const
+            {
+                return m_hdr;
+            }
+
+            const FamilyHdr *getFamilyHeader() const
+            {
+                return m_family;
+            }
+
+            bool hasAttr(int type) const
+            {
+                return getAttr(type) != nullptr;
+            }
+
+            const struct rtattr *getAttr(int type) const
+            {
+                return m_attrs.get(type);
+            }
+
+            const void *getAttrData(int type) const
+            {
+                return m_attrs.getData(type);
+            }
+
+            size_t getAttrLen(int type) const
+            {
+                return m_attrs.getLen(type);
+            }
+
+            bool getAttrU8(int type, uint8_t &value) const
+            {
+                return getAttrFixed(type, &value, sizeof(value));
+            }
+
+            bool getAttrU32(int type, uint32_t &value) const
+            {
+                return getAttrFixed(type, &value, sizeof(value));
+            }
+
+            /** Returns nullptr if the attribute is missing or not NUL terminated. */
+            const char *getAttrString(int type) const
+            {
+                auto str = static_cast<const char *>(getAttrData(type));
+                size_t len = getAttrLen(type);
+
+                if (str == nullptr || len == 0 || memchr(str, '\0', len) == nullptr)
+                    return nullptr;
+
+                return str;
+            }
+
+        protected:
+
+            bool getAttrFixed(int type, void *value, size_t size) const
+            {
+                return m_attrs.getFixed(type, value, size);
+            }
+
+            bool getAttrIp(int type, uint8_t family, IpAddress &ip) const
+            {
+                return m_attrs.getIp(type, family, ip);
+            }
+
+            bool getAttrMac(int type, MacAddress &mac) const
+            {
+                return m_attrs.getMac(type, mac);
+            }
+
+        private:
+
+            const struct nlmsghdr *m_hdr;
+            const FamilyHdr *m_family;
+            RtAttrTable<MaxAttr> m_attrs;
+    };
+
+    /** Next hop of a route, ifindex is 0 when not given */
+    struct RouteNextHop
+    {
+        IpAddress gateway;
+        bool hasGateway;
+        uint32_t ifindex;
+    };
+
+    /** View over RTM_NEWROUTE / RTM_DELROUTE */
+    class RouteMsgView : public RtnlMsgView<struct rtmsg, RTA_MAX>
+    {
+        public:
+
+            RouteMsgView(const struct nlmsghdr *hdr) : RtnlMsgView(hdr) {}
+
+            uint8_t getFamily() const { return getFamilyHeader()->rtm_family; }
+            uint8_t getDstLen() const { return getFamilyHeader()->rtm_dst_len; }
+            uint8_t getProtocol() const { return getFamilyHeader()->rtm_protocol; }
+            uint8_t getScope() const { return getFamilyHeader()->rtm_scope; }
+            uint8_t getRouteType() const { return getFamilyHeader()->rtm_type; }
+
+            /** RTA_TABLE when present, rtm_table otherwise */
+            uint32_t getTable() const
+            {
+                uint32_t table;
+
+                if (getAttrU32(RTA_TABLE, table))
+                    return table;
+
+                return getFamilyHeader()->rtm_table;
+            }
+
+            /** A missing RTA_DST is the default route of the family */
+            bool getDst(IpPrefix &prefix) const
+            {
+                IpAddress ip;
+
+                if ((getFamily() == AF_INET && getDstLen() > 32) ||
+                    (getFamily() == AF_INET6 && getDstLen() > 128) ||
+                    (getFamily() != AF_INET && getFamily() != AF_INET6))
+                    return false;
+
+                if (!hasAttr(RTA_DST))
+                {
+                    ip_addr_t zero;
+                    memset(&zero, 0, sizeof(zero));
+                    zero.family = getFamily();
+                    ip = IpAddress(zero);
+                }
+                else if (!getAttrIp(RTA_DST, getFamily(), ip))
+                {
+                    return false;
+                }
+
+                prefix = IpPrefix(ip.getIp(), getDstLen());
+                return true;
+            }
+
+            bool getGateway(IpAddress &ip) const { return getAttrIp(RTA_GATEWAY, getFamily(), ip); }
+            bool getPrefSrc(IpAddress &ip) const { return getAttrIp(RTA_PREFSRC, getFamily(), ip); }
+            bool getOif(uint32_t &ifindex) const { return getAttrU32(RTA_OIF, ifindex); }
+            bool getPriority(uint32_t &priority) const { return getAttrU32(RTA_PRIORITY, priority); }
+            bool hasMultipath() const { return hasAttr(RTA_MULTIPATH); }
+
+            /**
+             * Next hops from RTA_MULTIPATH, or from RTA_GATEWAY and RTA_OIF
+             * for single path routes. Routes without next hop, e.g.
+             * blackhole, give an empty list. False if RTA_MULTIPATH is
+             * malformed.
+             */
+            bool getNextHops(std::vector<RouteNextHop> &nextHops) const
+            {
+                nextHops.clear();
+
+                if (!hasMultipath())
+                {
+                    RouteNextHop nextHop;
+                    nextHop.ifindex = 0;
+                    nextHop.hasGateway = getGateway(nextHop.gateway);
+
+                    if (getOif(nextHop.ifindex) || nextHop.hasGateway)
+                        nextHops.push_back(nextHop);
+                    return true;
+                }
+
+                auto data = static_cast<const char *>(getAttrData(RTA_MULTIPATH));
+                size_t len = getAttrLen(RTA_MULTIPATH);
+                size_t offset = 0;
+
+                while (offset + sizeof(struct rtnexthop) <= len)
+                {
+                    struct rtnexthop rtnh;
+                    memcpy(&rtnh, data + offset, sizeof(rtnh));
+
+                    if (rtnh.rtnh_len < sizeof(rtnh) || offset + rtnh.rtnh_len > len)
+                        return false;
+
+                    RtAttrTable<RTA_MAX> attrs(data + offset + RTNH_LENGTH(0), rtnh.rtnh_len - RTNH_LENGTH(0));
+                    RouteNextHop nextHop;
+                    nextHop.ifindex = static_cast<uint32_t>(rtnh.rtnh_ifindex);
+                    nextHop.hasGateway = attrs.getIp(RTA_GATEWAY, getFamily(), nextHop.gateway);
+                    nextHops.push_back(nextHop);
+
+                    offset += RTNH_ALIGN(rtnh.rtnh_len);
+                }
+
+                return true;
+            }
+    };
+
+    /** View over RTM_NEWNEIGH / RTM_DELNEIGH */
+    class NeighMsgView : public RtnlMsgView<struct ndmsg, NDA_MAX>
+    {
+        public:
+
+            NeighMsgView(const struct nlmsghdr *hdr) : RtnlMsgView(hdr) {}
+
+            uint8_t getFamily() const { return getFamilyHeader()->ndm_family; }
+            int getIfindex() const { return getFamilyHeader()->ndm_ifindex; }
+            uint16_t getState() const { return getFamilyHeader()->ndm_state; }
+            uint8_t getFlags() const { return getFamilyHeader()->ndm_flags; }
+            uint8_t getNeighType() const { return getFamilyHeader()->ndm_type; }
+
+            bool getDst(IpAddress &ip) const { return getAttrIp(NDA_DST, getFamily(), ip); }
+            bool getLladdr(MacAddress &mac) const { return getAttrMac(NDA_LLADDR, mac); }
+            bool getVlan(uint16_t &vlan) const { return getAttrFixed(NDA_VLAN, &vlan, sizeof(vlan)); }
+            bool getMaster(uint32_t &ifindex) const { return getAttrU32(NDA_MASTER, ifindex); }
+    };
+
+    /** View over RTM_NEWLINK / RTM_DELLINK */
+    class LinkMsgView : public RtnlMsgView<struct ifinfomsg, IFLA_MAX>
+    {
+        public:
+
+            LinkMsgView(const struct nlmsghdr *hdr) : RtnlMsgView(hdr) {}
+
+            uint8_t getFamily() const { return getFamilyHeader()->ifi_family; }
+            int getIfindex() const { return getFamilyHeader()->ifi_index; }
+            unsigned int getFlags() const { return getFamilyHeader()->ifi_flags; }
+            unsigned short getLinkType() const { return getFamilyHeader()->ifi_type; }
+
+            const char *getName() const { return getAttrString(IFLA_IFNAME); }
+            bool getMtu(uint32_t &mtu) const { return getAttrU32(IFLA_MTU, mtu); }
+            bool getMaster(uint32_t &ifindex) const { return getAttrU32(IFLA_MASTER, ifindex); }
+            bool getOperState(uint8_t &state) const { return getAttrU8(IFLA_OPERSTATE, state); }
+            bool getAddress(MacAddress &mac) const { return getAttrMac(IFLA_ADDRESS, mac); }
+    };
+
+    /** One direction of a conntrack entry, ports in host order */
+    struct ConnTrackTuple
+    {
+        IpAddress src;
+        IpAddress dst;
+        uint8_t protocol;
+        /* 0 for protocols without ports */
+        uint16_t srcPort;
+        uint16_t dstPort;
+    };
+
+    /**
+     * View over IPCTNL_MSG_CT_NEW / IPCTNL_MSG_CT_DELETE.
+     *
+     * Conntrack attributes are in network byte order, the accessors
+     * return them in host order.
+     */
+    class ConnTrackMsgView : public RtnlMsgView<struct nfgenmsg, CTA_MAX>
+    {
+        public:
+
+            ConnTrackMsgView(const struct nlmsghdr *hdr) : RtnlMsgView(hdr) {}
+
+            uint8_t getFamily() const { return getFamilyHeader()->nfgen_family; }
+
+            bool getMark(uint32_t &mark) const { return getAttrBe32(CTA_MARK, mark); }
+            bool getStatus(uint32_t &status) const { return getAttrBe32(CTA_STATUS, status); }
+            bool getTimeout(uint32_t &timeout) const { return getAttrBe32(CTA_TIMEOUT, timeout); }
+            bool getId(uint32_t &id) const { return getAttrBe32(CTA_ID, id); }
+
+            /** A missing CTA_ZONE is the default zone 0 */
+            uint16_t getZone() const
+            {
+                uint16_t zone;
+
+                if (!getAttrFixed(CTA_ZONE, &zone, sizeof(zone)))
+                    return 0;
+
+                return ntohs(zone);
+            }
+
+            bool isNat() const
+            {
+                uint32_t status;
+
+                return getStatus(status) && (status & IPS_NAT_MASK) != 0;
+            }
+
+            bool getOrigTuple(ConnTrackTuple &tuple) const { return getTuple(CTA_TUPLE_ORIG, tuple); }
+            bool getReplyTuple(ConnTrackTuple &tuple) const { return getTuple(CTA_TUPLE_REPLY, tuple); }
+
+        private:
+
+            bool getAttrBe32(int type, uint32_t &value) const
+            {
+                if (!getAttrU32(type, value))
+                    return false;
+
+                value = ntohl(value);
+                return true;
+            }
+
+            bool getTuple(int type, ConnTrackTuple &tuple) const
+            {
+                RtAttrTable<CTA_TUPLE_MAX> attrs(getAttrData(type), getAttrLen(type));
+                RtAttrTable<CTA_IP_MAX> ip(attrs.getData(CTA_TUPLE_IP), attrs.getLen(CTA_TUPLE_IP));
+                RtAttrTable<CTA_PROTO_MAX> proto(attrs.getData(CTA_TUPLE_PROTO), attrs.getLen(CTA_TUPLE_PROTO));
+
+                ip_addr_t src, dst;
+                src.family = dst.family = getFamily();
+
+                switch (getFamily())
+                {
+                    case AF_INET:
+                        if (!ip.getFixed(CTA_IP_V4_SRC, &src.ip_addr, sizeof(src.ip_addr.ipv4_addr)) ||
+                            !ip.getFixed(CTA_IP_V4_DST, &dst.ip_addr, sizeof(dst.ip_addr.ipv4_addr)))
+                            return false;
+                        break;
+                    case AF_INET6:
+                        if (!ip.getFixed(CTA_IP_V6_SRC, &src.ip_addr, sizeof(src.ip_addr.ipv6_addr)) ||
+                            !ip.getFixed(CTA_IP_V6_DST, &dst.ip_addr, sizeof(dst.ip_addr.ipv6_addr)))
+                            return false;
+                        break;
+                    default:
+                        return false;
+                }
+
+                if (!proto.getFixed(CTA_PROTO_NUM, &tuple.protocol, sizeof(tuple.protocol)))
+                    return false;
+
+                uint16_t port;
+                tuple.srcPort = proto.getFixed(CTA_PROTO_SRC_PORT, &port, sizeof(port)) ? ntohs(port) : 0;
+                tuple.dstPort = proto.getFixed(CTA_PROTO_DST_PORT, &port, sizeof(port)) ? ntohs(port) : 0;
+                tuple.src = IpAddress(src);
+                tuple.dst = IpAddress(dst);
+
+                return true;
+            }
+    };
+}
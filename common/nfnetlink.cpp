@@ -1,5 +1,8 @@
 #include <string.h>
 #include <errno.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
 #include <system_error>
 #include "common/logger.h"
 #include "common/netmsg.h"
@@ -11,7 +14,12 @@ using namespace swss;
 using namespace std;
 
 NfNetlink::NfNetlink(int pri) :
-    Selectable(pri)
+    Selectable(pri),
+    m_ctSocket(NULL),
+    m_ctSeq(0),
+    m_ctBatchCount(0),
+    m_ctEntryCount(0),
+    m_ctErrorCount(0)
 {
     m_socket = nl_socket_alloc();
     if (!m_socket)
@@ -56,6 +64,12 @@ NfNetlink::~NfNetlink()
         nl_close(m_socket);
         nl_socket_free(m_socket);
     }
+
+    if (m_ctSocket != NULL)
+    {
+        nl_close(m_ctSocket);
+        nl_socket_free(m_ctSocket);
+    }
 }
 
 bool NfNetlink::setSockBufSize(uint32_t sockBufSize)
@@ -116,6 +130,293 @@ bool NfNetlink::deleteConnTrackEntry(struct nfnl_ct *ct)
     return true;
 }
 
+void NfNetlink::openConnTrackSocket()
+{
+    m_ctSocket = nl_socket_alloc();
+    if (!m_ctSocket)
+    {
+        SWSS_LOG_ERROR("Unable to allocated conntrack batch socket");
+        throw system_error(make_error_code(errc::address_not_available),
+                           "Unable to allocate conntrack batch socket");
+    }
+
+    nl_socket_disable_seq_check(m_ctSocket);
+    nl_socket_disable_auto_ack(m_ctSocket);
+
+    int err = nfnl_connect(m_ctSocket);
+    if (err < 0)
+    {
+        SWSS_LOG_ERROR("Unable to connect conntrack batch socket: %s", nl_geterror(err));
+        nl_socket_free(m_ctSocket);
+        m_ctSocket = NULL;
+        throw system_error(make_error_code(errc::address_not_available),
+                           "Unable to connect conntrack batch socket");
+    }
+
+    int fd = nl_socket_get_fd(m_ctSocket);
+
+#ifdef NETLINK_CAP_ACK
+    /* Errors carry only the header of the failed message, not all of it */
+    int one = 1;
+    setsockopt(fd, SOL_NETLINK, NETLINK_CAP_ACK, &one, sizeof(one));
+#endif
+
+    /* Do not wait forever for an ACK the kernel will never send */
+    struct timeval tv = { 1, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    nl_socket_set_buffer_size(m_ctSocket, 10485760, 0);
+}
+
+size_t NfNetlink::programConnTrackBatch(vector<ConnTrackOp> &ops)
+{
+    if (m_ctSocket == NULL)
+        openConnTrackSocket();
+
+    /* Message i of the batch has sequence number seqBase + i */
+    uint32_t seqBase = m_ctSeq;
+    m_ctSeq += static_cast<uint32_t>(ops.size());
+
+    vector<char> buffer;
+    buffer.reserve(CT_BATCH_BYTES);
+    size_t first = 0;
+
+    for (size_t i = 0; i < ops.size(); i++)
+    {
+        struct nl_msg *msg = NULL;
+        int err;
+
+        if (ops[i].type == ConnTrackOp::UPDATE)
+            err = nfnl_ct_build_add_request(ops[i].ct, NLM_F_REPLACE, &msg);
+        else
+            err = nfnl_ct_build_delete_request(ops[i].ct, 0, &msg);
+
+        if (err < 0)
+        {
+            SWSS_LOG_ERROR("Failed to build conntrack message: %s", nl_geterror(err));
+            ops[i].error = -EINVAL;
+            continue;
+        }
+
+        struct nlmsghdr *hdr = nlmsg_hdr(msg);
+        size_t len = NLMSG_ALIGN(hdr->nlmsg_len);
+
+        if (!buffer.empty() && buffer.size() + len > CT_BATCH_BYTES)
+        {
+            sendConnTrackBatch(ops, seqBase, first, i, buffer);
+            buffer.clear();
+            first = i;
+        }
+
+        hdr->nlmsg_seq = seqBase + static_cast<uint32_t>(i);
+        ops[i].error = 0;
+
+        const char *raw = reinterpret_cast<const char *>(hdr);
+        buffer.insert(buffer.end(), raw, raw + len);
+        nlmsg_free(msg);
+    }
+
+    if (!buffer.empty())
+        sendConnTrackBatch(ops, seqBase, first, ops.size(), buffer);
+
+    size_t failed = 0;
+    for (auto &op : ops)
+    {
+        if (op.error != 0)
+            failed++;
+    }
+
+    m_ctEntryCount += ops.size();
+    m_ctErrorCount += failed;
+
+    return failed;
+}
+
+void NfNetlink::sendConnTrackBatch(vector<ConnTrackOp> &ops, uint32_t seqBase,
+                                   size_t first, size_t last, vector<char> &buffer)
+{
+    /* Only the last message asks for an ACK, it completes the send */
+    struct nlmsghdr *lastHdr = NULL;
+    int remaining = static_cast<int>(buffer.size());
+    for (auto hdr = reinterpret_cast<struct nlmsghdr *>(buffer.data());
+         NLMSG_OK(hdr, remaining); hdr = NLMSG_NEXT(hdr, remaining))
+    {
+        lastHdr = hdr;
+    }
+
+    lastHdr->nlmsg_flags |= NLM_F_ACK;
+    uint32_t lastSeq = lastHdr->nlmsg_seq;
+
+    m_ctBatchCount++;
+
+    int pending = -ETIMEDOUT;
+    if (nl_sendto(m_ctSocket, buffer.data(), buffer.size()) < 0)
+    {
+        SWSS_LOG_ERROR("Failed to send %zu bytes of conntrack messages", buffer.size());
+        pending = -EIO;
+    }
+    else
+    {
+        char rbuf[8192];
+        bool lost = false;
+        int fd = nl_socket_get_fd(m_ctSocket);
+
+        while (true)
+        {
+            ssize_t len = recv(fd, rbuf, sizeof(rbuf), 0);
+            if (len < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                if (errno == ENOBUFS)
+                {
+                    /* Some errors are gone, keep reading up to the ACK */
+                    lost = true;
+                    continue;
+                }
+
+                SWSS_LOG_ERROR("No ACK for conntrack batch: %s", strerror(errno));
+                break;
+            }
+
+            bool acked = false;
+            remaining = static_cast<int>(len);
+            for (auto hdr = reinterpret_cast<struct nlmsghdr *>(rbuf);
+                 NLMSG_OK(hdr, remaining); hdr = NLMSG_NEXT(hdr, remaining))
+            {
+                if (hdr->nlmsg_type != NLMSG_ERROR ||
+                    hdr->nlmsg_len < NLMSG_LENGTH(sizeof(struct nlmsgerr)))
+                    continue;
+
+                auto nlerr = static_cast<const struct nlmsgerr *>(NLMSG_DATA(hdr));
+                size_t index = hdr->nlmsg_seq - seqBase;
+
+                if (index >= first && index < last)
+                    ops[index].error = nlerr->error;
+
+                if (hdr->nlmsg_seq == lastSeq)
+                    acked = true;
+            }
+
+            if (acked)
+            {
+                pending = lost ? -ENOBUFS : 0;
+                break;
+            }
+        }
+    }
+
+    if (pending == 0)
+        return;
+
+    /* Messages without a report have an unknown result */
+    for (size_t i = first; i < last; i++)
+    {
+        if (ops[i].error == 0)
+            ops[i].error = pending;
+    }
+}
+
+size_t NfNetlink::dumpConnTrack(const ConnTrackDumpFilter &filter, const ConnTrackDumpCallback &callback)
+{
+    if (m_ctSocket == NULL)
+        openConnTrackSocket();
+
+    struct nl_msg *msg = nlmsg_alloc_simple((NFNL_SUBSYS_CTNETLINK << 8) | IPCTNL_MSG_CT_GET,
+                                            NLM_F_REQUEST | NLM_F_DUMP);
+    if (msg == NULL)
+        SWSS_LOG_THROW("Unable to allocate conntrack dump request");
+
+    struct nfgenmsg nfg = {};
+    nfg.nfgen_family = filter.family;
+    nfg.version = NFNETLINK_V0;
+    nlmsg_append(msg, &nfg, sizeof(nfg), NLMSG_ALIGNTO);
+
+    /* The kernel only filters on mark with both CTA_MARK and CTA_MARK_MASK */
+    if (filter.hasMark)
+    {
+        nla_put_u32(msg, CTA_MARK, htonl(filter.mark));
+        nla_put_u32(msg, CTA_MARK_MASK, htonl(filter.markMask));
+    }
+
+    if (filter.hasZone)
+        nla_put_u16(msg, CTA_ZONE, htons(filter.zone));
+
+    int err = nl_send_auto(m_ctSocket, msg);
+    uint32_t seq = nlmsg_hdr(msg)->nlmsg_seq;
+    nlmsg_free(msg);
+
+    if (err < 0)
+        SWSS_LOG_THROW("Unable to request conntrack dump: %s", nl_geterror(err));
+
+    m_ctRecvBuf.resize(CT_DUMP_BUF_SIZE);
+    int fd = nl_socket_get_fd(m_ctSocket);
+    size_t count = 0;
+
+    while (true)
+    {
+        ssize_t len = recv(fd, m_ctRecvBuf.data(), m_ctRecvBuf.size(), 0);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            SWSS_LOG_THROW("Conntrack dump interrupted after %zu entries: %s", count, strerror(errno));
+        }
+
+        int remaining = static_cast<int>(len);
+        for (auto hdr = reinterpret_cast<struct nlmsghdr *>(m_ctRecvBuf.data());
+             NLMSG_OK(hdr, remaining); hdr = NLMSG_NEXT(hdr, remaining))
+        {
+            /* Leftovers of a previous batch or dump */
+            if (hdr->nlmsg_seq != seq)
+                continue;
+
+            if (hdr->nlmsg_type == NLMSG_DONE)
+                return count;
+
+            if (hdr->nlmsg_type == NLMSG_ERROR)
+            {
+                auto nlerr = static_cast<const struct nlmsgerr *>(NLMSG_DATA(hdr));
+                if (hdr->nlmsg_len >= NLMSG_LENGTH(sizeof(*nlerr)) && nlerr->error != 0)
+                    SWSS_LOG_THROW("Conntrack dump failed: %s", strerror(-nlerr->error));
+                continue;
+            }
+
+            ConnTrackMsgView view(hdr);
+            if (!view.isValid() || !matchConnTrack(filter, view))
+                continue;
+
+            callback(view);
+            count++;
+        }
+    }
+}
+
+bool NfNetlink::matchConnTrack(const ConnTrackDumpFilter &filter, const ConnTrackMsgView &view)
+{
+    if (filter.family != AF_UNSPEC && view.getFamily() != filter.family)
+        return false;
+
+    if (filter.natOnly && !view.isNat())
+        return false;
+
+    uint32_t value;
+
+    /* CTA_MARK may be left out for a zero mark */
+    if (filter.hasMark && ((view.getMark(value) ? value : 0) & filter.markMask) != filter.mark)
+        return false;
+
+    if (filter.hasZone && view.getZone() != filter.zone)
+        return false;
+
+    if (filter.hasStatus && (!view.getStatus(value) || (value & filter.statusMask) != filter.status))
+        return false;
+
+    return true;
+}
+
 int NfNetlink::getFd()
 {
     return nl_socket_get_fd(m_socket);
@@ -2,11 +2,65 @@
 #define __NFNETLINK__
 
 #include "ipaddress.h"
+#include "netmsgview.h"
 #include <netlink/netfilter/ct.h>
 #include <netlink/netfilter/nfnl.h>
 
+#include <atomic>
+#include <functional>
+#include <vector>
+
 namespace swss {
 
+/* Conntrack operation of a batch, see NfNetlink::programConnTrackBatch */
+struct ConnTrackOp
+{
+    enum Type
+    {
+        UPDATE,
+        DELETE
+    };
+
+    Type type;
+    struct nfnl_ct *ct;
+
+    /* Set by programConnTrackBatch: 0 on success, negative errno otherwise */
+    int error;
+};
+
+/* Filter of NfNetlink::dumpConnTrack, unset fields match all entries */
+struct ConnTrackDumpFilter
+{
+    ConnTrackDumpFilter() :
+        family(AF_UNSPEC), natOnly(false),
+        hasMark(false), mark(0), markMask(0),
+        hasZone(false), zone(0),
+        hasStatus(false), status(0), statusMask(0)
+    {
+    }
+
+    uint8_t family;
+
+    /* Only entries with source or destination NAT */
+    bool natOnly;
+
+    /* (entry mark & markMask) == mark */
+    bool hasMark;
+    uint32_t mark;
+    uint32_t markMask;
+
+    bool hasZone;
+    uint16_t zone;
+
+    /* (entry status & statusMask) == status */
+    bool hasStatus;
+    uint32_t status;
+    uint32_t statusMask;
+};
+
+/* The view is only valid during the call */
+typedef std::function<void(const ConnTrackMsgView &)> ConnTrackDumpCallback;
+
 class NfNetlink : public Selectable {
 public:
     NfNetlink(int pri = 0);
@@ -23,7 +77,45 @@ public:
     bool updateConnTrackEntry(struct nfnl_ct *ct);
     bool deleteConnTrackEntry(struct nfnl_ct *ct);
 
+    /* Maximum size of a single send of programConnTrackBatch */
+    static constexpr size_t CT_BATCH_BYTES = 65536;
+
+    /*
+     * Program many conntrack entries at once.
+     *
+     * Operations are packed into sends of up to CT_BATCH_BYTES, only the
+     * last message of each send asks for an ACK, the kernel still reports
+     * every failed message. The result of each operation is stored in its
+     * error field. Returns the number of failed operations.
+     */
+    size_t programConnTrackBatch(std::vector<ConnTrackOp> &ops);
+
+    /* Receive buffer size of dumpConnTrack */
+    static constexpr size_t CT_DUMP_BUF_SIZE = 65536;
+
+    /*
+     * Dump the conntrack table, passing each entry matching filter to
+     * callback as it is received.
+     *
+     * Family, mark and zone are sent to the kernel as dump filters, on
+     * kernels ignoring some of them every filter is also checked here.
+     * No libnl object or cache is built, memory use does not depend on
+     * the table size. Returns the number of entries passed to callback,
+     * throws if the dump did not complete.
+     */
+    size_t dumpConnTrack(const ConnTrackDumpFilter &filter, const ConnTrackDumpCallback &callback);
+
+    /* programConnTrackBatch counters */
+    uint64_t getConnTrackBatchCount() const { return m_ctBatchCount.load(); }
+    uint64_t getConnTrackEntryCount() const { return m_ctEntryCount.load(); }
+    uint64_t getConnTrackErrorCount() const { return m_ctErrorCount.load(); }
+
 private:
+    void openConnTrackSocket();
+    static bool matchConnTrack(const ConnTrackDumpFilter &filter, const ConnTrackMsgView &view);
+    void sendConnTrackBatch(std::vector<ConnTrackOp> &ops, uint32_t seqBase,
+                            size_t first, size_t last, std::vector<char> &buffer);
+
 #ifdef NETFILTER_UNIT_TEST
     static int onNetlinkRcv(struct nl_msg *msg, void *arg);
 #endif
@@ -31,6 +123,15 @@ private:
 
     FILE *nfPktsLogFile;
     nl_sock *m_socket;
+
+    /* Blocking socket without group membership, used for batch ACKs */
+    nl_sock *m_ctSocket;
+    uint32_t m_ctSeq;
+    std::vector<char> m_ctRecvBuf;
+
+    std::atomic<uint64_t> m_ctBatchCount;
+    std::atomic<uint64_t> m_ctEntryCount;
+    std::atomic<uint64_t> m_ctErrorCount;
 };
 
 }
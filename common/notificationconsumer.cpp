@@ -13,7 +13,10 @@ swss::NotificationConsumer::NotificationConsumer(swss::DBConnector *db, const st
     POP_BATCH_SIZE(popBatchSize),
     m_db(db),
     m_subscribe(NULL),
-    m_channel(channel)
+    m_channel(channel),
+    m_metricsGroup(db->getDbName(), channel),
+    m_notificationCount(m_metricsGroup, "notifications"),
+    m_byteCount(m_metricsGroup, "bytes")
 {
     SWSS_LOG_ENTER();
 
@@ -138,6 +141,12 @@ void swss::NotificationConsumer::processReply(redisReply *reply)
 
     SWSS_LOG_DEBUG("got message: %s", msg.c_str());
 
+    if (MetricsRegistry::isEnabled())
+    {
+        m_notificationCount.get().add();
+        m_byteCount.get().add(msg.size());
+    }
+
     m_queue.push(msg);
 }
 
@@ -10,6 +10,7 @@
 #include "dbconnector.h"
 #include "json.h"
 #include "logger.h"
+#include "metrics.h"
 #include "redisreply.h"
 #include "selectable.h"
 #include "table.h"
@@ -56,6 +57,10 @@ private:
     swss::DBConnector *m_subscribe;
     std::string m_channel;
     std::queue<std::string> m_queue;
+
+    MetricsGroup m_metricsGroup;
+    LazyMetric<Counter> m_notificationCount;
+    LazyMetric<Counter> m_byteCount;
 };
 
 }
@@ -1,4 +1,5 @@
 #include "notificationproducer.h"
+#include "capture.h"
 
 swss::NotificationProducer::NotificationProducer(swss::DBConnector *db, const std::string &channel):
     m_db(db), m_channel(channel)
@@ -9,6 +10,9 @@ int64_t swss::NotificationProducer::send(const std::string &op, const std::strin
 {
     SWSS_LOG_ENTER();
 
+    if (Capture::isEnabled())
+        Capture::record(CAPTURE_NOTIFICATION_PRODUCER, CAPTURE_SEND, m_db->getDbName(), m_channel, data, op, values);
+
     FieldValueTuple opdata(op, data);
 
     values.insert(values.begin(), opdata);
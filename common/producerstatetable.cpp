@@ -8,6 +8,8 @@
 #include "redisapi.h"
 #include "redispipeline.h"
 #include "producerstatetable.h"
+#include "trace.h"
+#include "capture.h"
 
 using namespace std;
 
@@ -26,7 +28,14 @@ ProducerStateTable::ProducerStateTable(RedisPipeline *pipeline, const string &ta
     , m_pipeowned(false)
     , m_tempViewActive(false)
     , m_pipe(pipeline)
+    , m_latencyStamps(false)
+    , m_stampSequence(0)
+    , m_metricsGroup(pipeline->getDbName(), tableName)
+    , m_setCount(m_metricsGroup, "set")
+    , m_delCount(m_metricsGroup, "del")
 {
+    // A latency stamp of a set is one more field of the state hash,
+    // the one of a del is written into the state hash once deleted.
     // num in luaSet and luaDel means number of elements that were added to the key set,
     // not including all the elements already present into the set.
     string luaSet =
@@ -43,11 +52,46 @@ ProducerStateTable::ProducerStateTable(RedisPipeline *pipeline, const string &ta
         "local added = redis.call('SADD', KEYS[2], ARGV[2])\n"
         "redis.call('SADD', KEYS[4], ARGV[2])\n"
         "redis.call('DEL', KEYS[3])\n"
+        "if ARGV[5] then\n"
+        "    redis.call('HSET', KEYS[3], ARGV[5], ARGV[6])\n"
+        "end\n"
         "if added > 0 then \n"
         "    redis.call('PUBLISH', KEYS[1], ARGV[1])\n"
         "end\n";
     m_shaDel = m_pipe->loadRedisScript(luaDel);
 
+    string luaBatchedSet =
+        "local added = 0\n"
+        "local idx = 2\n"
+        "for i = 3, #KEYS do\n"
+        "    added = added + redis.call('SADD', KEYS[2], ARGV[idx])\n"
+        "    local n = tonumber(ARGV[idx + 1])\n"
+        "    for j = 0, n - 1 do\n"
+        "        redis.call('HSET', KEYS[i], ARGV[idx + 2 + j * 2], ARGV[idx + 3 + j * 2])\n"
+        "    end\n"
+        "    idx = idx + 2 + n * 2\n"
+        "end\n"
+        "if added > 0 then\n"
+        "    redis.call('PUBLISH', KEYS[1], ARGV[1])\n"
+        "end\n";
+    m_shaBatchedSet = m_pipe->loadRedisScript(luaBatchedSet);
+
+    string luaBatchedDel =
+        "local added = 0\n"
+        "local stamped = #ARGV > #KEYS - 2\n"
+        "for i = 4, #KEYS do\n"
+        "    added = added + redis.call('SADD', KEYS[2], ARGV[i - 2])\n"
+        "    redis.call('SADD', KEYS[3], ARGV[i - 2])\n"
+        "    redis.call('DEL', KEYS[i])\n"
+        "    if stamped then\n"
+        "        redis.call('HSET', KEYS[i], ARGV[#ARGV - 1], ARGV[#ARGV])\n"
+        "    end\n"
+        "end\n"
+        "if added > 0 then\n"
+        "    redis.call('PUBLISH', KEYS[1], ARGV[1])\n"
+        "end\n";
+    m_shaBatchedDel = m_pipe->loadRedisScript(luaBatchedDel);
+
     string luaClear =
         "redis.call('DEL', KEYS[1])\n"
         "local keys = redis.call('KEYS', KEYS[2] .. '*')\n"
@@ -74,9 +118,23 @@ void ProducerStateTable::setBuffered(bool buffered)
     m_buffered = buffered;
 }
 
+void ProducerStateTable::setLatencyStamps(bool enabled)
+{
+    m_latencyStamps = enabled;
+}
+
+string ProducerStateTable::latencyStamp()
+{
+    return to_string(MetricsRegistry::now()) + ":" + to_string(++m_stampSequence);
+}
+
 void ProducerStateTable::set(const string &key, const vector<FieldValueTuple> &values,
                  const string &op /*= SET_COMMAND*/, const string &prefix)
 {
+    TraceSpan span(TRACE_PRODUCER_SET, getTableName(), key);
+    if (MetricsRegistry::isEnabled())
+        m_setCount.get().add();
+
     if (m_tempViewActive)
     {
         // Write to temp view instead of DB
@@ -87,15 +145,19 @@ void ProducerStateTable::set(const string &key, const vector<FieldValueTuple> &v
         return;
     }
 
+    if (Capture::isEnabled())
+        Capture::record(CAPTURE_PRODUCER_STATE_TABLE, CAPTURE_SET, m_pipe->getDbName(), getTableName(), key, op, values);
+
     // Assembly redis command args into a string vector
     vector<string> args;
     args.emplace_back("EVALSHA");
     args.emplace_back(m_shaSet);
-    args.emplace_back(to_string(values.size() + 2));
+    size_t hsets = values.size() + (m_latencyStamps ? 1 : 0);
+    args.emplace_back(to_string(hsets + 2));
     args.emplace_back(getChannelName());
     args.emplace_back(getKeySetName());
 
-    args.insert(args.end(), values.size(), getStateHashPrefix() + getKeyName(key));
+    args.insert(args.end(), hsets, getStateHashPrefix() + getKeyName(key));
 
     args.emplace_back("G");
     args.emplace_back(key);
@@ -105,6 +167,12 @@ void ProducerStateTable::set(const string &key, const vector<FieldValueTuple> &v
         args.emplace_back(fvValue(iv));
     }
 
+    if (m_latencyStamps)
+    {
+        args.emplace_back(getLatencyStampField());
+        args.emplace_back(latencyStamp());
+    }
+
     // Transform data structure
     vector<const char *> args1;
     transform(args.begin(), args.end(), back_inserter(args1), [](const string &s) { return s.c_str(); } );
@@ -121,6 +189,10 @@ void ProducerStateTable::set(const string &key, const vector<FieldValueTuple> &v
 
 void ProducerStateTable::del(const string &key, const string &op /*= DEL_COMMAND*/, const string &prefix)
 {
+    TraceSpan span(TRACE_PRODUCER_DEL, getTableName(), key);
+    if (MetricsRegistry::isEnabled())
+        m_delCount.get().add();
+
     if (m_tempViewActive)
     {
         // Write to temp view instead of DB
@@ -128,6 +200,9 @@ void ProducerStateTable::del(const string &key, const string &op /*= DEL_COMMAND
         return;
     }
 
+    if (Capture::isEnabled())
+        Capture::record(CAPTURE_PRODUCER_STATE_TABLE, CAPTURE_DEL, m_pipe->getDbName(), getTableName(), key, op, {});
+
     // Assembly redis command args into a string vector
     vector<string> args;
     args.emplace_back("EVALSHA");
@@ -142,8 +217,150 @@ void ProducerStateTable::del(const string &key, const string &op /*= DEL_COMMAND
     args.emplace_back("''");
     args.emplace_back("''");
 
+    if (m_latencyStamps)
+    {
+        args.emplace_back(getLatencyStampField());
+        args.emplace_back(latencyStamp());
+    }
+
+    // Transform data structure
+    vector<const char *> args1;
+    transform(args.begin(), args.end(), back_inserter(args1), [](const string &s) { return s.c_str(); } );
+
+    // Invoke redis command
+    RedisCommand command;
+    command.formatArgv((int)args1.size(), &args1[0], NULL);
+    m_pipe->push(command, REDIS_REPLY_NIL);
+    if (!m_buffered)
+    {
+        m_pipe->flush();
+    }
+}
+
+void ProducerStateTable::set(const vector<KeyOpFieldsValuesTuple> &values)
+{
+    if (values.empty())
+    {
+        return;
+    }
+
+    if (m_tempViewActive)
+    {
+        for (const auto &kfv : values)
+        {
+            set(kfvKey(kfv), kfvFieldsValues(kfv));
+        }
+        return;
+    }
+
+    if (MetricsRegistry::isEnabled())
+        m_setCount.get().add(values.size());
+
+    if (Capture::isEnabled())
+    {
+        for (const auto &kfv : values)
+            Capture::record(CAPTURE_PRODUCER_STATE_TABLE, CAPTURE_SET, m_pipe->getDbName(), getTableName(), kfvKey(kfv), SET_COMMAND, kfvFieldsValues(kfv));
+    }
+
+    // KEYS are the channel, the key set and the state hash of each key,
+    // ARGV the key and its field count followed by its fields and values
+    vector<string> args;
+    args.emplace_back("EVALSHA");
+    args.emplace_back(m_shaBatchedSet);
+    args.emplace_back(to_string(values.size() + 2));
+    args.emplace_back(getChannelName());
+    args.emplace_back(getKeySetName());
+
+    for (const auto &kfv : values)
+    {
+        args.emplace_back(getStateHashPrefix() + getKeyName(kfvKey(kfv)));
+    }
+
+    args.emplace_back("G");
+    for (const auto &kfv : values)
+    {
+        args.emplace_back(kfvKey(kfv));
+        args.emplace_back(to_string(kfvFieldsValues(kfv).size() + (m_latencyStamps ? 1 : 0)));
+        for (const auto &iv : kfvFieldsValues(kfv))
+        {
+            args.emplace_back(fvField(iv));
+            args.emplace_back(fvValue(iv));
+        }
+
+        if (m_latencyStamps)
+        {
+            args.emplace_back(getLatencyStampField());
+            args.emplace_back(latencyStamp());
+        }
+    }
+
+    // Transform data structure
+    vector<const char *> args1;
+    args1.reserve(args.size());
+    transform(args.begin(), args.end(), back_inserter(args1), [](const string &s) { return s.c_str(); } );
+
+    // Invoke redis command
+    RedisCommand command;
+    command.formatArgv((int)args1.size(), &args1[0], NULL);
+    m_pipe->push(command, REDIS_REPLY_NIL);
+    if (!m_buffered)
+    {
+        m_pipe->flush();
+    }
+}
+
+void ProducerStateTable::del(const vector<string> &keys)
+{
+    if (keys.empty())
+    {
+        return;
+    }
+
+    if (m_tempViewActive)
+    {
+        for (const auto &key : keys)
+        {
+            del(key);
+        }
+        return;
+    }
+
+    if (MetricsRegistry::isEnabled())
+        m_delCount.get().add(keys.size());
+
+    if (Capture::isEnabled())
+    {
+        for (const auto &key : keys)
+            Capture::record(CAPTURE_PRODUCER_STATE_TABLE, CAPTURE_DEL, m_pipe->getDbName(), getTableName(), key, DEL_COMMAND, {});
+    }
+
+    // KEYS are the channel, the key set, the del key set and the state hash of each key,
+    // ARGV the keys
+    vector<string> args;
+    args.emplace_back("EVALSHA");
+    args.emplace_back(m_shaBatchedDel);
+    args.emplace_back(to_string(keys.size() + 3));
+    args.emplace_back(getChannelName());
+    args.emplace_back(getKeySetName());
+    args.emplace_back(getDelKeySetName());
+
+    for (const auto &key : keys)
+    {
+        args.emplace_back(getStateHashPrefix() + getKeyName(key));
+    }
+
+    args.emplace_back("G");
+    args.insert(args.end(), keys.begin(), keys.end());
+
+    if (m_latencyStamps)
+    {
+        args.emplace_back(getLatencyStampField());
+        args.emplace_back(latencyStamp());
+    }
+
     // Transform data structure
     vector<const char *> args1;
+    args1.reserve(args.size());
     transform(args.begin(), args.end(), back_inserter(args1), [](const string &s) { return s.c_str(); } );
 
     // Invoke redis command
@@ -353,6 +570,19 @@ void ProducerStateTable::apply_temp_view()
     m_pipe->push(command, REDIS_REPLY_NIL);
     m_pipe->flush();
 
+    // Capture the view switch as the dels and sets it did
+    if (Capture::isEnabled())
+    {
+        for (const auto &key : keysToDel)
+            Capture::record(CAPTURE_PRODUCER_STATE_TABLE, CAPTURE_DEL, m_pipe->getDbName(), getTableName(), key, DEL_COMMAND, {});
+
+        for (auto const & kfvPair : m_tempViewState)
+        {
+            vector<FieldValueTuple> values(kfvPair.second.begin(), kfvPair.second.end());
+            Capture::record(CAPTURE_PRODUCER_STATE_TABLE, CAPTURE_SET, m_pipe->getDbName(), getTableName(), kfvPair.first, SET_COMMAND, values);
+        }
+    }
+
     // Clear state, temp view operation is now finished
     m_tempViewState.clear();
     m_tempViewActive = false;
@@ -3,6 +3,7 @@
 #include <memory>
 #include "table.h"
 #include "redispipeline.h"
+#include "metrics.h"
 
 namespace swss {
 
@@ -14,6 +15,16 @@ public:
     ~ProducerStateTable();
 
     void setBuffered(bool buffered);
+
+    /*
+     * Stamp every set and del with "<CLOCK_MONOTONIC ns>:<sequence>" in the
+     * latency stamp field of the state hash. ConsumerStateTable::pops strips
+     * it and records the end to end latency, so the consumer must use a
+     * library which knows the field. A key written again before the pops
+     * keeps the stamp of its last write.
+     */
+    void setLatencyStamps(bool enabled);
+
     /* Implements set() and del() commands using notification messages */
     virtual void set(const std::string &key,
                      const std::vector<FieldValueTuple> &values,
@@ -24,6 +35,11 @@ public:
                      const std::string &op = DEL_COMMAND,
                      const std::string &prefix = EMPTY_PREFIX);
 
+    /* Batched set() and del(), one script call and one notification for all keys */
+    virtual void set(const std::vector<KeyOpFieldsValuesTuple> &values);
+
+    virtual void del(const std::vector<std::string> &keys);
+
 #ifdef SWIG
     // SWIG interface file (.i) globally rename map C++ `del` to python `delete`,
     // but applications already followed the old behavior of auto renamed `_del`.
@@ -51,9 +67,19 @@ private:
     RedisPipeline *m_pipe;
     std::string m_shaSet;
     std::string m_shaDel;
+    std::string m_shaBatchedSet;
+    std::string m_shaBatchedDel;
     std::string m_shaClear;
     std::string m_shaApplyView;
     TableDump m_tempViewState;
+    bool m_latencyStamps;
+    uint64_t m_stampSequence;
+
+    MetricsGroup m_metricsGroup;
+    LazyMetric<Counter> m_setCount;
+    LazyMetric<Counter> m_delCount;
+
+    std::string latencyStamp();
 };
 
 }
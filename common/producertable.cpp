@@ -6,6 +6,7 @@
 #include "common/json.hpp"
 #include "common/logger.h"
 #include "common/redisapi.h"
+#include "common/capture.h"
 
 using namespace std;
 using json = nlohmann::json;
@@ -24,6 +25,9 @@ ProducerTable::ProducerTable(RedisPipeline *pipeline, const string &tableName, b
     , m_buffered(buffered)
     , m_pipeowned(false)
     , m_pipe(pipeline)
+    , m_metricsGroup(pipeline->getDbName(), tableName)
+    , m_setCount(m_metricsGroup, "set")
+    , m_delCount(m_metricsGroup, "del")
 {
     /*
      * KEYS[1] : tableName + "_KEY_VALUE_OP_QUEUE
@@ -84,6 +88,12 @@ void ProducerTable::enqueueDbChange(const string &key, const string &value, cons
 
 void ProducerTable::set(const string &key, const vector<FieldValueTuple> &values, const string &op, const string &prefix)
 {
+    if (MetricsRegistry::isEnabled())
+        m_setCount.get().add();
+
+    if (Capture::isEnabled())
+        Capture::record(CAPTURE_PRODUCER_TABLE, CAPTURE_SET, m_pipe->getDbName(), getTableName(), key, op, values);
+
     if (m_dumpFile.is_open())
     {
         if (!m_firstItem)
@@ -110,6 +120,12 @@ void ProducerTable::set(const string &key, const vector<FieldValueTuple> &values
 
 void ProducerTable::del(const string &key, const string &op, const string &prefix)
 {
+    if (MetricsRegistry::isEnabled())
+        m_delCount.get().add();
+
+    if (Capture::isEnabled())
+        Capture::record(CAPTURE_PRODUCER_TABLE, CAPTURE_DEL, m_pipe->getDbName(), getTableName(), key, op, {});
+
     if (m_dumpFile.is_open())
     {
         if (!m_firstItem)
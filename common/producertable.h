@@ -11,6 +11,7 @@
 #include "table.h"
 #include "redisselect.h"
 #include "redispipeline.h"
+#include "metrics.h"
 
 namespace swss {
 
@@ -60,6 +61,10 @@ private:
     RedisPipeline *m_pipe;
     std::string m_shaEnque;
 
+    MetricsGroup m_metricsGroup;
+    LazyMetric<Counter> m_setCount;
+    LazyMetric<Counter> m_delCount;
+
     void enqueueDbChange(const std::string &key, const std::string &value, const std::string &op, const std::string &prefix);
 };
 
@@ -5,6 +5,8 @@
 #include "redisreply.h"
 #include "rediscommand.h"
 #include "dbconnector.h"
+#include "trace.h"
+#include "metrics.h"
 
 namespace swss {
 
@@ -16,6 +18,11 @@ public:
     RedisPipeline(const DBConnector *db, size_t sz = 128)
         : COMMAND_MAX(sz)
         , m_remaining(0)
+        , m_metricsGroup(db->getDbName(), "RedisPipeline")
+        , m_commandCount(m_metricsGroup, "commands")
+        , m_byteCount(m_metricsGroup, "bytes")
+        , m_flushDepth(m_metricsGroup, "flush_depth")
+        , m_flushLatency(m_metricsGroup, "flush_ns")
     {
         m_db = db->newConnector(NEWCONNECTOR_TIMEOUT);
     }
@@ -27,6 +34,8 @@ public:
 
     redisReply *push(const RedisCommand& command, int expectedType)
     {
+        recordCommand(command);
+
         switch (expectedType)
         {
             case REDIS_REPLY_NIL:
@@ -56,6 +65,7 @@ public:
 
     redisReply *push(const RedisCommand& command)
     {
+        recordCommand(command);
         flush();
         RedisReply r(m_db, command);
         return r.release();
@@ -97,11 +107,27 @@ public:
 
     void flush()
     {
+        if (m_remaining == 0)
+            return;
+
+        TraceSpan span(TRACE_PIPELINE_FLUSH, "", 0, "", 0);
+        span.setCount(m_remaining);
+
+        uint64_t start = 0;
+        if (MetricsRegistry::isEnabled())
+        {
+            m_flushDepth.get().record(m_remaining);
+            start = MetricsRegistry::now();
+        }
+
         while(m_remaining)
         {
             // Construct an object to use its dtor, so that resource is released
             RedisReply r(pop());
         }
+
+        if (start)
+            m_flushLatency.get().record(MetricsRegistry::now() - start);
     }
 
     size_t size()
@@ -129,6 +155,21 @@ private:
     std::queue<int> m_expectedTypes;
     size_t m_remaining;
 
+    MetricsGroup m_metricsGroup;
+    LazyMetric<Counter> m_commandCount;
+    LazyMetric<Counter> m_byteCount;
+    LazyMetric<Histogram> m_flushDepth;
+    LazyMetric<Histogram> m_flushLatency;
+
+    void recordCommand(const RedisCommand& command)
+    {
+        if (MetricsRegistry::isEnabled())
+        {
+            m_commandCount.get().add();
+            m_byteCount.get().add(command.length());
+        }
+    }
+
     void mayflush()
     {
         if (m_remaining >= COMMAND_MAX)
@@ -3,6 +3,9 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <endian.h>
+#include <strings.h>
+
 
 boost::optional<std::string> swss::fvsGetValue(
     const std::vector<FieldValueTuple> &fvt,
@@ -30,4 +33,130 @@ boost::optional<std::string> swss::fvsGetValue(
     }
 
     return ret;
-}
\ No newline at end of file
+}
+
+namespace
+{
+    /* Same as fieldhash_detail::word, with a single load */
+    inline uint64_t loadWord(const char *str, size_t len)
+    {
+        if (len == 8)
+        {
+            uint64_t w;
+            memcpy(&w, str, 8);
+            return le64toh(w);
+        }
+
+        /* Two overlapping fixed size loads rather than a variable memcpy */
+        if (len >= 4)
+        {
+            uint32_t lo, hi;
+            memcpy(&lo, str, 4);
+            memcpy(&hi, str + len - 4, 4);
+            return le32toh(lo) | (static_cast<uint64_t>(le32toh(hi)) << ((len - 4) * 8));
+        }
+
+        uint64_t w = 0;
+        for (size_t i = 0; i < len; i++)
+            w |= static_cast<uint64_t>(static_cast<uint8_t>(str[i])) << (i * 8);
+
+        return w;
+    }
+
+    inline uint64_t loadWordNoCase(const char *str, size_t len)
+    {
+        char lower[8] = {};
+        for (size_t i = 0; i < len; i++)
+            lower[i] = str[i] >= 'A' && str[i] <= 'Z' ? static_cast<char>(str[i] | 0x20) : str[i];
+
+        return loadWord(lower, len);
+    }
+
+    template<uint64_t (*load)(const char *, size_t)>
+    inline uint64_t hashWords(const char *name, size_t len)
+    {
+        uint64_t h = len;
+
+        for (; len > 8; name += 8, len -= 8)
+            h = swss::fieldhash_detail::step(h, load(name, 8));
+
+        return swss::fieldhash_detail::step(h, load(name, len));
+    }
+}
+
+uint64_t swss::fieldHash(const char *name, size_t len)
+{
+    return hashWords<loadWord>(name, len);
+}
+
+uint64_t swss::fieldHashNoCase(const char *name, size_t len)
+{
+    return hashWords<loadWordNoCase>(name, len);
+}
+
+swss::FieldValueIndex::FieldValueIndex(
+    const std::vector<FieldValueTuple> &fvt,
+    bool case_insensitive) :
+    m_fvt(fvt),
+    m_caseInsensitive(case_insensitive),
+    m_table(m_inline),
+    m_shift(64)
+{
+    size_t capacity = 1;
+    while (capacity < fvt.size() * 2)
+    {
+        capacity <<= 1;
+        m_shift--;
+    }
+
+    if (capacity > INLINE_FIELDS * 2)
+    {
+        m_heap.resize(capacity);
+        m_table = m_heap.data();
+    }
+    else
+    {
+        std::fill(m_inline, m_inline + capacity, 0);
+    }
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < fvt.size(); i++)
+    {
+        const std::string &field = fvField(fvt[i]);
+        uint64_t hash = case_insensitive ? fieldHashNoCase(field.c_str(), field.size())
+                                         : fieldHash(field.c_str(), field.size());
+
+        /* Later duplicates land after the first one on the probe sequence */
+        size_t slot = m_shift < 64 ? static_cast<size_t>(hash >> m_shift) : 0;
+        while (m_table[slot])
+            slot = (slot + 1) & mask;
+
+        m_table[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+const std::string *swss::FieldValueIndex::find(const FieldKey &field) const
+{
+    if (m_fvt.empty())
+        return nullptr;
+
+    /* The compile time hash of a FieldKey is case sensitive */
+    uint64_t hash = m_caseInsensitive ? fieldHashNoCase(field.name(), field.size()) : field.hash();
+    size_t mask = (static_cast<size_t>(1) << (64 - m_shift)) - 1;
+    size_t slot = m_shift < 64 ? static_cast<size_t>(hash >> m_shift) : 0;
+
+    for (; m_table[slot]; slot = (slot + 1) & mask)
+    {
+        const FieldValueTuple &fv = m_fvt[m_table[slot] - 1];
+        const std::string &name = fvField(fv);
+
+        if (name.size() != field.size())
+            continue;
+
+        if (m_caseInsensitive ? strncasecmp(name.data(), field.name(), field.size()) == 0
+                              : memcmp(name.data(), field.name(), field.size()) == 0)
+            return &fvValue(fv);
+    }
+
+    return nullptr;
+}
@@ -4,6 +4,8 @@
 
 #include <boost/optional.hpp>
 
+#include <stdint.h>
+#include <string.h>
 #include <vector>
 #include <algorithm>
 
@@ -13,4 +15,137 @@ boost::optional<std::string> fvsGetValue(
     const std::vector<FieldValueTuple> &fvt,
     const std::string &field,
     bool case_insensitive = false);
+
+namespace fieldhash_detail
+{
+    const uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+    constexpr size_t length(const char *str)
+    {
+        return *str ? 1 + length(str + 1) : 0;
+    }
+
+    /* Up to 8 bytes as a little endian word */
+    constexpr uint64_t word(const char *str, size_t len)
+    {
+        return len == 0 ? 0 : static_cast<uint8_t>(str[0]) | (word(str + 1, len - 1) << 8);
+    }
+
+    constexpr uint64_t fold(uint64_t h)
+    {
+        return h ^ (h >> 29);
+    }
+
+    constexpr uint64_t step(uint64_t h, uint64_t w)
+    {
+        return fold((h ^ w) * MULTIPLIER);
+    }
+
+    constexpr uint64_t words(const char *str, size_t len, uint64_t h)
+    {
+        return len > 8 ? words(str + 8, len - 8, step(h, word(str, 8))) : step(h, word(str, len));
+    }
+}
+
+/*
+ * Hash of a field name for FieldValueIndex, mixing 8 bytes at a time. The
+ * constexpr form is meant for compile time, fieldHash(name, len) computes
+ * the same value faster at run time.
+ */
+constexpr uint64_t fieldHashConst(const char *name, size_t len)
+{
+    return fieldhash_detail::words(name, len, len);
+}
+
+constexpr uint64_t fieldHash(const char *name)
+{
+    return fieldHashConst(name, fieldhash_detail::length(name));
+}
+
+uint64_t fieldHash(const char *name, size_t len);
+
+/* Same as fieldHash with ASCII letters lowered */
+uint64_t fieldHashNoCase(const char *name, size_t len);
+
+/*
+ * Field name with its hash, computed at compile time for a constexpr
+ * FieldKey:
+ *
+ *     static constexpr FieldKey MTU("mtu");
+ */
+class FieldKey
+{
+public:
+    template<size_t N>
+    constexpr FieldKey(const char (&name)[N]) :
+        m_name(name), m_len(N - 1), m_hash(fieldHashConst(name, N - 1)) {}
+
+    FieldKey(const char *name, size_t len) :
+        m_name(name), m_len(len), m_hash(fieldHash(name, len)) {}
+
+    FieldKey(const std::string &name) :
+        m_name(name.c_str()), m_len(name.size()), m_hash(fieldHash(name.c_str(), name.size())) {}
+
+    constexpr const char *name() const
+    {
+        return m_name;
+    }
+
+    constexpr size_t size() const
+    {
+        return m_len;
+    }
+
+    constexpr uint64_t hash() const
+    {
+        return m_hash;
+    }
+
+private:
+    const char *m_name;
+    size_t m_len;
+    uint64_t m_hash;
+};
+
+/*
+ * Index over the fields of one entry, built once in O(fields) so that each
+ * lookup is a probe of a small hash table instead of a scan with string
+ * compares. Entries of up to INLINE_FIELDS fields are indexed without
+ * allocating. Returns the first matching field like fvsGetValue. The
+ * vector must outlive the index and not change.
+ */
+class FieldValueIndex
+{
+public:
+    static const size_t INLINE_FIELDS = 32;
+
+    FieldValueIndex(const std::vector<FieldValueTuple> &fvt, bool case_insensitive = false);
+
+    FieldValueIndex(const FieldValueIndex &) = delete;
+    FieldValueIndex &operator=(const FieldValueIndex &) = delete;
+
+    /* Value of field, nullptr when the entry has no such field */
+    const std::string *find(const FieldKey &field) const;
+
+    boost::optional<std::string> get(const FieldKey &field) const
+    {
+        const std::string *value = find(field);
+        return value ? boost::optional<std::string>(*value) : boost::optional<std::string>();
+    }
+
+    size_t size() const
+    {
+        return m_fvt.size();
+    }
+
+private:
+    const std::vector<FieldValueTuple> &m_fvt;
+    bool m_caseInsensitive;
+
+    /* Field index + 1 per slot, 0 for a free slot, at most half full */
+    uint32_t *m_table;
+    unsigned m_shift;
+    uint32_t m_inline[INLINE_FIELDS * 2];
+    std::vector<uint32_t> m_heap;
+};
 }
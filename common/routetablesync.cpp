@@ -0,0 +1,218 @@
+#include "common/logger.h"
+#include "common/linkcache.h"
+#include "common/netmsgview.h"
+#include "common/routetablesync.h"
+#include "common/tokenize.h"
+
+#include <algorithm>
+
+using namespace swss;
+using namespace std;
+
+RouteTableSync::RouteTableSync(ProducerStateTable &table, size_t batchSize) :
+    m_table(table), m_batchSize(batchSize > 0 ? batchSize : 1), m_routeTable(RT_TABLE_MAIN),
+    m_resolver([](int ifindex) { return LinkCache::getInstance().ifindexToName(ifindex); }),
+    m_routeCount(0), m_skippedCount(0), m_coalescedCount(0), m_batchCount(0), m_writeCount(0)
+{
+    m_pending.reserve(m_batchSize);
+}
+
+void RouteTableSync::setRouteTable(uint32_t table)
+{
+    m_routeTable = table;
+}
+
+void RouteTableSync::setIfNameResolver(const IfNameResolver &resolver)
+{
+    m_resolver = resolver;
+}
+
+void RouteTableSync::onMsg(int nlmsg_type, const struct nlmsghdr *hdr)
+{
+    RouteMsgView view(hdr);
+    IpPrefix prefix;
+
+    if (!view.isValid() || view.getTable() != m_routeTable || !view.getDst(prefix))
+    {
+        m_skippedCount++;
+        return;
+    }
+
+    string key = prefix.to_string();
+
+    if (nlmsg_type == RTM_DELROUTE)
+    {
+        m_routeCount++;
+        m_appended.erase(key);
+        update(key, true, vector<FieldValueTuple>());
+        return;
+    }
+
+    vector<FieldValueTuple> fieldValues;
+
+    if (view.getRouteType() == RTN_BLACKHOLE)
+    {
+        m_appended.erase(key);
+        fieldValues.emplace_back("blackhole", "true");
+    }
+    else if (view.getRouteType() == RTN_UNICAST)
+    {
+        vector<RouteNextHop> nextHops;
+        if (!view.getNextHops(nextHops) || nextHops.empty())
+        {
+            m_skippedCount++;
+            return;
+        }
+
+        NextHopList list;
+        list.reserve(nextHops.size());
+        for (const auto &nh : nextHops)
+        {
+            list.emplace_back(nh.hasGateway ? nh.gateway.to_string() : (prefix.isV4() ? "0.0.0.0" : "::"),
+                              m_resolver(static_cast<int>(nh.ifindex)));
+        }
+
+        if (!prefix.isV4() && (hdr->nlmsg_flags & NLM_F_APPEND))
+        {
+            auto it = m_appended.find(key);
+            if (it == m_appended.end())
+                it = m_appended.emplace(key, pendingNextHops(key)).first;
+
+            /* Nexthops added to an existing route, the lists are merged */
+            NextHopList &known = it->second;
+            for (auto &nh : list)
+            {
+                if (find(known.begin(), known.end(), nh) == known.end())
+                    known.push_back(move(nh));
+            }
+
+            list = known;
+        }
+        else if (!prefix.isV4())
+        {
+            m_appended.erase(key);
+        }
+
+        string nexthop;
+        string ifname;
+        for (const auto &nh : list)
+        {
+            if (!nexthop.empty())
+            {
+                nexthop += ',';
+                ifname += ',';
+            }
+
+            nexthop += nh.first;
+            ifname += nh.second;
+        }
+
+        fieldValues.emplace_back("nexthop", move(nexthop));
+        fieldValues.emplace_back("ifname", move(ifname));
+    }
+    else
+    {
+        m_skippedCount++;
+        return;
+    }
+
+    m_routeCount++;
+    update(key, false, move(fieldValues));
+}
+
+void RouteTableSync::update(const string &key, bool del, vector<FieldValueTuple> &&fieldValues)
+{
+    auto it = m_pending.find(key);
+
+    if (it == m_pending.end())
+    {
+        PendingRoute &route = m_pending[key];
+        route.del = del;
+        route.replace = false;
+        route.fieldValues = move(fieldValues);
+
+        if (m_pending.size() >= m_batchSize)
+            writeBatch();
+        return;
+    }
+
+    /* Only the last state of a prefix is written */
+    PendingRoute &route = it->second;
+    m_coalescedCount++;
+
+    route.replace = !del && (route.del || route.replace);
+    route.del = del;
+    route.fieldValues = move(fieldValues);
+}
+
+RouteTableSync::NextHopList RouteTableSync::pendingNextHops(const string &key) const
+{
+    NextHopList list;
+
+    auto it = m_pending.find(key);
+    if (it == m_pending.end() || it->second.del)
+        return list;
+
+    vector<string> nexthops;
+    vector<string> ifnames;
+    for (const auto &fv : it->second.fieldValues)
+    {
+        if (fvField(fv) == "nexthop")
+            nexthops = tokenize(fvValue(fv), ',');
+        else if (fvField(fv) == "ifname")
+            ifnames = tokenize(fvValue(fv), ',');
+    }
+
+    for (size_t i = 0; i < nexthops.size() && i < ifnames.size(); i++)
+    {
+        list.emplace_back(move(nexthops[i]), move(ifnames[i]));
+    }
+
+    return list;
+}
+
+void RouteTableSync::onResyncBegin()
+{
+    m_appended.clear();
+}
+
+void RouteTableSync::onResyncEnd()
+{
+    m_appended.clear();
+    flush();
+}
+
+void RouteTableSync::flush()
+{
+    writeBatch();
+    m_table.flush();
+}
+
+void RouteTableSync::writeBatch()
+{
+    if (m_pending.empty())
+        return;
+
+    vector<string> dels;
+    vector<KeyOpFieldsValuesTuple> sets;
+    sets.reserve(m_pending.size());
+
+    for (auto &kv : m_pending)
+    {
+        if (kv.second.del || kv.second.replace)
+            dels.push_back(kv.first);
+
+        if (!kv.second.del)
+            sets.emplace_back(kv.first, SET_COMMAND, move(kv.second.fieldValues));
+    }
+
+    /* Deletes go first so a replaced route starts from empty fields */
+    m_table.del(dels);
+    m_table.set(sets);
+
+    m_batchCount++;
+    m_writeCount += m_pending.size();
+    m_pending.clear();
+
+    SWSS_LOG_DEBUG("Wrote %zu route deletes and %zu route sets", dels.size(), sets.size());
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "netmsg.h"
+#include "producerstatetable.h"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace swss
+{
+    /*
+     * Writes kernel routes from RTM_NEWROUTE / RTM_DELROUTE into a
+     * ProducerStateTable, e.g. ROUTE_TABLE of APPL_DB, with the fields used
+     * by fpmsyncd: nexthop and ifname lists, or blackhole.
+     *
+     * Register it as raw handler of both message types, then feed it a
+     * route dump or route events. Updates are coalesced by prefix into a
+     * pending batch of at most batchSize keys, written with the batched
+     * ProducerStateTable set and del. A full batch is written right away
+     * and blocks until the pipeline accepted it. Reading the netlink socket
+     * pauses meanwhile, which paces the kernel dump, and memory use does
+     * not depend on the table size.
+     *
+     * The kernel may send an IPv6 ECMP route one nexthop per message, with
+     * NLM_F_APPEND on all but the first. The nexthops of such routes are
+     * kept until the route is replaced or deleted; the first ones are
+     * taken from the pending batch. An append to a route which was written
+     * in an earlier batch and never appended to carries its own nexthops
+     * only.
+     *
+     * Call flush() when the dump is done and after each read of events.
+     */
+    class RouteTableSync : public RawNetMsg
+    {
+        public:
+
+            static constexpr size_t DEFAULT_BATCH_SIZE = 1024;
+
+            typedef std::function<std::string(int ifindex)> IfNameResolver;
+
+            RouteTableSync(ProducerStateTable &table, size_t batchSize = DEFAULT_BATCH_SIZE);
+
+            /* Only routes of this kernel table are written, RT_TABLE_MAIN by default */
+            void setRouteTable(uint32_t table);
+
+            /* Outgoing interface names are resolved through LinkCache by default */
+            void setIfNameResolver(const IfNameResolver &resolver);
+
+            void onMsg(int nlmsg_type, const struct nlmsghdr *hdr) override;
+
+            /* A resync dump sends complete routes, the appended nexthops are dropped */
+            void onResyncBegin() override;
+
+            /* Routes re-dumped by a resync are written without waiting for a flush */
+            void onResyncEnd() override;
+
+            /* Write the pending batch and flush the table pipeline */
+            void flush();
+
+            /* Route messages turned into an update */
+            uint64_t getRouteCount() const { return m_routeCount; }
+
+            /* Route messages of other tables, types or families, or malformed */
+            uint64_t getSkippedCount() const { return m_skippedCount; }
+
+            /* Updates merged into a pending update of the same prefix */
+            uint64_t getCoalescedCount() const { return m_coalescedCount; }
+
+            /* Batches and keys written to the table */
+            uint64_t getBatchCount() const { return m_batchCount; }
+            uint64_t getWriteCount() const { return m_writeCount; }
+
+        private:
+
+            struct PendingRoute
+            {
+                bool del;
+                /* A delete preceded this set in the batch, delete first */
+                bool replace;
+                std::vector<FieldValueTuple> fieldValues;
+            };
+
+            /* Gateway and ifname of each nexthop */
+            typedef std::vector<std::pair<std::string, std::string>> NextHopList;
+
+            void update(const std::string &key, bool del, std::vector<FieldValueTuple> &&fieldValues);
+            void writeBatch();
+
+            /* Nexthops of the pending update of key, empty if none */
+            NextHopList pendingNextHops(const std::string &key) const;
+
+            ProducerStateTable &m_table;
+            size_t m_batchSize;
+            uint32_t m_routeTable;
+            IfNameResolver m_resolver;
+
+            std::unordered_map<std::string, PendingRoute> m_pending;
+
+            /* Nexthops of the IPv6 routes which received NLM_F_APPEND, by prefix */
+            std::unordered_map<std::string, NextHopList> m_appended;
+
+            uint64_t m_routeCount;
+            uint64_t m_skippedCount;
+            uint64_t m_coalescedCount;
+            uint64_t m_batchCount;
+            uint64_t m_writeCount;
+    };
+}
@@ -367,6 +367,7 @@ namespace swss {
 #define STATE_PORT_PERIPHERAL_TABLE                 "PORT_PERIPHERAL_TABLE"
 #define STATE_BUFFER_POOL_TABLE_NAME                "BUFFER_POOL_TABLE"
 #define STATE_BUFFER_PROFILE_TABLE_NAME             "BUFFER_PROFILE_TABLE"
+#define STATE_SWSS_METRICS_TABLE_NAME               "SWSS_METRICS_TABLE"
 /***** MISC *****/
 
 #define IPV4_NAME "IPv4"
@@ -1,6 +1,8 @@
 #include "common/selectable.h"
 #include "common/logger.h"
 #include "common/select.h"
+#include "common/trace.h"
+#include "common/metrics.h"
 #include <algorithm>
 #include <stdio.h>
 #include <sys/time.h>
@@ -8,6 +10,7 @@
 #include <sys/epoll.h>
 #include <unistd.h>
 #include <string.h>
+#include <typeinfo>
 
 using namespace std;
 
@@ -102,6 +105,8 @@ int Select::poll_descriptors(Selectable **c, unsigned int timeout)
     if (ret < 0)
         return Select::ERROR;
 
+    uint64_t woken = Trace::isEnabled() ? Trace::now() : 0;
+
     for (int i = 0; i < ret; ++i)
     {
         int fd = events[i].data.fd;
@@ -142,12 +147,42 @@ int Select::poll_descriptors(Selectable **c, unsigned int timeout)
 
         sel->updateAfterRead();
 
+        if (woken && Trace::isEnabled())
+        {
+            /* The class of the object and its fd, from the wakeup to the return */
+            const char *name = typeid(*sel).name();
+            Trace::record(TRACE_SELECT_DISPATCH, woken, Trace::now() - woken,
+                          name, strlen(name), "", 0, static_cast<uint32_t>(sel->getFd()));
+        }
+
         return Select::OBJECT;
     }
 
     return Select::TIMEOUT;
 }
 
+/* Results of all the Selects of the process */
+static void recordResult(int result)
+{
+    static const MetricsGroup group("", "Select");
+    static LazyMetric<Counter> objects(group, "objects");
+    static LazyMetric<Counter> timeouts(group, "timeouts");
+    static LazyMetric<Counter> errors(group, "errors");
+
+    switch (result)
+    {
+        case Select::OBJECT:
+            objects.get().add();
+            break;
+        case Select::TIMEOUT:
+            timeouts.get().add();
+            break;
+        default:
+            errors.get().add();
+            break;
+    }
+}
+
 int Select::select(Selectable **c, int timeout)
 {
     SWSS_LOG_ENTER();
@@ -161,11 +196,18 @@ int Select::select(Selectable **c, int timeout)
 
     /* return if we have data, we have an error or desired timeout was 0 */
     if (ret != Select::TIMEOUT || timeout == 0)
+    {
+        if (MetricsRegistry::isEnabled())
+            recordResult(ret);
         return ret;
+    }
 
     /* wait for data */
     ret = poll_descriptors(c, timeout);
 
+    if (MetricsRegistry::isEnabled())
+        recordResult(ret);
+
     return ret;
 
 }
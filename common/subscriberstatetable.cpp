@@ -9,6 +9,7 @@
 #include "redisapi.h"
 #include "tokenize.h"
 #include "subscriberstatetable.h"
+#include "trace.h"
 
 using namespace std;
 
@@ -94,12 +95,16 @@ bool SubscriberStateTable::hasCachedData()
 
 void SubscriberStateTable::pops(deque<KeyOpFieldsValuesTuple> &vkco, const string& /*prefix*/)
 {
+    TraceSpan span(TRACE_CONSUMER_POPS, getTableName());
+    uint64_t start = popsStart();
     vkco.clear();
 
     if (!m_buffer.empty())
     {
         vkco.insert(vkco.end(), m_buffer.begin(), m_buffer.end());
         m_buffer.clear();
+        span.setCount(vkco.size());
+        recordPops(start, vkco.size());
         return;
     }
 
@@ -122,7 +127,7 @@ void SubscriberStateTable::pops(deque<KeyOpFieldsValuesTuple> &vkco, const strin
             continue;
         }
 
-        string msg = message.channel;
+        const string &msg = message.channel;
         size_t pos = msg.find(':');
         if (pos == msg.npos)
         {
@@ -130,14 +135,15 @@ void SubscriberStateTable::pops(deque<KeyOpFieldsValuesTuple> &vkco, const strin
             continue;
         }
 
-        string table_entry = msg.substr(pos + 1);
-        pos = table_entry.find(m_table.getTableNameSeparator());
-        if (pos == table_entry.npos)
+        /* Only the key is copied out of the channel */
+        const char *table_entry = msg.c_str() + pos + 1;
+        pos = msg.find(m_table.getTableNameSeparator(), pos + 1);
+        if (pos == msg.npos)
         {
             SWSS_LOG_ERROR("invalid key %s returned for pmessage of %s", ctx->str, m_keyspace.c_str());
             continue;
         }
-        string key = table_entry.substr(pos + 1);
+        string key = msg.substr(pos + 1);
 
         string op = message.data;
         if ("del" == op)
@@ -149,7 +155,7 @@ void SubscriberStateTable::pops(deque<KeyOpFieldsValuesTuple> &vkco, const strin
         {
             if (!m_table.get(key, kfvFieldsValues(kco)))
             {
-                SWSS_LOG_ERROR("Failed to get content for table key %s", table_entry.c_str());
+                SWSS_LOG_ERROR("Failed to get content for table key %s", table_entry);
                 continue;
             }
             kfvKey(kco) = key;
@@ -160,6 +166,8 @@ void SubscriberStateTable::pops(deque<KeyOpFieldsValuesTuple> &vkco, const strin
     }
 
     m_keyspace_event_buffer.clear();
+    span.setCount(vkco.size());
+    recordPops(start, vkco.size());
 
     return;
 }
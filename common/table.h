@@ -62,7 +62,7 @@ public:
             throw std::invalid_argument("Invalid table name separator");
     }
 
-    std::string getTableName() const { return m_tableName; }
+    const std::string &getTableName() const { return m_tableName; }
 
     /* Return the actual key name as a combination of tableName<table_separator>key */
     std::string getKeyName(const std::string &key)
@@ -230,6 +230,9 @@ public:
     std::string getKeySetName() const { return m_key; }
     std::string getDelKeySetName() const { return m_delkey; }
     std::string getStateHashPrefix() const { return "_"; }
+
+    /* Field of the state hash carrying a latency stamp, stripped by the pops */
+    std::string getLatencyStampField() const { return "__latency_stamp"; }
 };
 
 }
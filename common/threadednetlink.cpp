@@ -0,0 +1,317 @@
+#include "common/logger.h"
+#include "common/netlink.h"
+#include "common/netdispatcher.h"
+#include "common/threadednetlink.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <system_error>
+#include <cstring>
+
+using namespace swss;
+using namespace std;
+
+/* Select is woken up at least every this many datagrams while they keep coming */
+static const unsigned int NOTIFY_BATCH = 16;
+
+/* Time to wait for the reader when the ring is full, in milliseconds */
+static const int RING_FULL_WAIT = 1;
+
+ThreadedNetLink::ThreadedNetLink(int pri, size_t ringSize, size_t bufSize) :
+    Selectable(pri), m_socket(NULL), m_efd(-1), m_stopFd(-1),
+    m_readBudget(DEFAULT_READ_BUDGET),
+    m_ringSize(ringSize), m_bufSize(bufSize),
+    m_buffers(ringSize * bufSize), m_lengths(ringSize),
+    m_head(0), m_tail(0),
+    m_resync(NetLink::DEFAULT_SOCK_BUF_SIZE),
+    m_datagramCount(0)
+{
+    if (ringSize == 0 || bufSize == 0)
+        throw invalid_argument("ThreadedNetLink ring and buffer sizes must not be 0");
+
+    m_socket = nl_socket_alloc();
+    if (!m_socket)
+    {
+        SWSS_LOG_ERROR("Unable to allocated netlink socket");
+        throw system_error(make_error_code(errc::address_not_available),
+                           "Unable to allocated netlink socket");
+    }
+
+    nl_socket_disable_seq_check(m_socket);
+
+    int err = nl_connect(m_socket, NETLINK_ROUTE);
+    if (err < 0)
+    {
+        SWSS_LOG_ERROR("Unable to connect netlink socket: %s", nl_geterror(err));
+        nl_socket_free(m_socket);
+        m_socket = NULL;
+        throw system_error(make_error_code(errc::address_not_available),
+                           "Unable to connect netlink socket");
+    }
+
+    nl_socket_set_nonblocking(m_socket);
+    nl_socket_set_buffer_size(m_socket, NetLink::DEFAULT_SOCK_BUF_SIZE, 0);
+
+    m_efd = eventfd(0, EFD_NONBLOCK);
+    m_stopFd = eventfd(0, EFD_NONBLOCK);
+    if (m_efd == -1 || m_stopFd == -1)
+    {
+        SWSS_LOG_ERROR("failed to create eventfd, errno: %s", strerror(errno));
+        if (m_efd != -1)
+            close(m_efd);
+        if (m_stopFd != -1)
+            close(m_stopFd);
+        nl_close(m_socket);
+        nl_socket_free(m_socket);
+        throw runtime_error("failed to create eventfd");
+    }
+}
+
+ThreadedNetLink::~ThreadedNetLink()
+{
+    stop();
+
+    close(m_efd);
+    close(m_stopFd);
+    nl_close(m_socket);
+    nl_socket_free(m_socket);
+}
+
+void ThreadedNetLink::registerGroup(int rtnlGroup)
+{
+    int err = nl_socket_add_membership(m_socket, rtnlGroup);
+    if (err < 0)
+    {
+        SWSS_LOG_ERROR("Unable to register to group %d: %s", rtnlGroup,
+                       nl_geterror(err));
+        throw system_error(make_error_code(errc::address_not_available),
+                           "Unable to register group");
+    }
+}
+
+void ThreadedNetLink::dumpRequest(int rtmGetCommand)
+{
+    int err = nl_rtgen_request(m_socket, rtmGetCommand, AF_UNSPEC, NLM_F_DUMP);
+    if (err < 0)
+    {
+        SWSS_LOG_ERROR("Unable to request dump on group %d: %s", rtmGetCommand,
+                       nl_geterror(err));
+        throw system_error(make_error_code(errc::address_not_available),
+                           "Unable to request dump");
+    }
+}
+
+bool ThreadedNetLink::setSockBufSize(uint32_t sockBufSize)
+{
+    if (nl_socket_set_buffer_size(m_socket, sockBufSize, 0) < 0)
+    {
+        return false;
+    }
+    m_resync.setSockBufSize(sockBufSize);
+    return true;
+}
+
+void ThreadedNetLink::enableAutoResync(const vector<int> &rtmGetCommands)
+{
+    m_resync.setCommands(rtmGetCommands);
+}
+
+void ThreadedNetLink::setAdaptiveSockBufSize(uint32_t maxSockBufSize)
+{
+    m_resync.setMaxSockBufSize(maxSockBufSize);
+}
+
+void ThreadedNetLink::setReadBudget(unsigned int datagrams)
+{
+    m_readBudget = datagrams > 0 ? datagrams : 1;
+}
+
+void ThreadedNetLink::start()
+{
+    if (m_thread.joinable())
+        return;
+
+    m_thread = thread(&ThreadedNetLink::receiveLoop, this);
+}
+
+void ThreadedNetLink::stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    uint64_t value = 1;
+    if (write(m_stopFd, &value, sizeof(value)) != sizeof(value))
+        SWSS_LOG_ERROR("Unable to stop netlink receive thread: %s", strerror(errno));
+
+    m_thread.join();
+
+    /* Clear the stop request so the thread can be started again */
+    if (read(m_stopFd, &value, sizeof(value)) != sizeof(value))
+        SWSS_LOG_DEBUG("No stop request pending");
+}
+
+size_t ThreadedNetLink::getPendingCount() const
+{
+    return m_head.load(memory_order_acquire) - m_tail.load(memory_order_acquire);
+}
+
+int ThreadedNetLink::getSocketFd()
+{
+    return nl_socket_get_fd(m_socket);
+}
+
+int ThreadedNetLink::getFd()
+{
+    return m_efd;
+}
+
+uint64_t ThreadedNetLink::readData()
+{
+    uint64_t value;
+    ssize_t s;
+
+    /* Only clear the wake up, datagrams are dispatched in updateAfterRead */
+    do
+    {
+        s = read(m_efd, &value, sizeof(value));
+    }
+    while (s == -1 && errno == EINTR);
+
+    return 0;
+}
+
+bool ThreadedNetLink::hasData()
+{
+    return getPendingCount() > 0;
+}
+
+bool ThreadedNetLink::hasCachedData()
+{
+    return getPendingCount() > m_readBudget;
+}
+
+void ThreadedNetLink::updateAfterRead()
+{
+    size_t tail = m_tail.load(memory_order_relaxed);
+    size_t head = m_head.load(memory_order_acquire);
+
+    for (unsigned int n = 0; n < m_readBudget && tail != head; n++)
+    {
+        size_t slot = tail % m_ringSize;
+
+        /* The slot is not written by the receive thread until m_tail moves past it */
+        if (m_lengths[slot] == 0)
+            m_resync.startResync();
+        else
+            m_resync.dispatchDatagram(&m_buffers[slot * m_bufSize], m_lengths[slot]);
+        m_tail.store(++tail, memory_order_release);
+    }
+
+    m_resync.continueResync(m_socket);
+}
+
+void ThreadedNetLink::notify()
+{
+    uint64_t value = 1;
+
+    if (write(m_efd, &value, sizeof(value)) != sizeof(value))
+        SWSS_LOG_ERROR("Unable to wake up netlink reader: %s", strerror(errno));
+}
+
+void ThreadedNetLink::receiveLoop()
+{
+    struct pollfd fds[2];
+    fds[0].fd = getSocketFd();
+    fds[0].events = POLLIN;
+    fds[1].fd = m_stopFd;
+    fds[1].events = POLLIN;
+
+    while (true)
+    {
+        int ret = poll(fds, 2, -1);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            SWSS_LOG_ERROR("netlink receive thread poll failed: %s", strerror(errno));
+            return;
+        }
+
+        if (fds[1].revents & POLLIN)
+            return;
+
+        /* Ring is full, datagrams wait in the socket until the reader catches up */
+        while (!receiveAvailable())
+        {
+            if (poll(&fds[1], 1, RING_FULL_WAIT) > 0)
+                return;
+        }
+    }
+}
+
+bool ThreadedNetLink::receiveAvailable()
+{
+    int fd = getSocketFd();
+    unsigned int unnotified = 0;
+    bool full = false;
+
+    while (true)
+    {
+        size_t head = m_head.load(memory_order_relaxed);
+        if (head - m_tail.load(memory_order_acquire) == m_ringSize)
+        {
+            full = true;
+            break;
+        }
+
+        size_t slot = head % m_ringSize;
+        ssize_t len = recv(fd, &m_buffers[slot * m_bufSize], m_bufSize, MSG_DONTWAIT | MSG_TRUNC);
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            if (errno != ENOBUFS)
+            {
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    SWSS_LOG_ERROR("netlink reports an error=%d on reading a netlink socket", errno);
+                break;
+            }
+
+            /* Queued as an empty slot, the reader starts the resync after the datagrams received before */
+            m_resync.noteOverflow(m_socket);
+            len = 0;
+        }
+        else if (len == 0)
+        {
+            continue;
+        }
+        else if (static_cast<size_t>(len) > m_bufSize)
+        {
+            SWSS_LOG_ERROR("netlink datagram truncated, receive buffer of %zu bytes is too small", m_bufSize);
+            continue;
+        }
+        else
+        {
+            m_datagramCount++;
+        }
+
+        m_lengths[slot] = static_cast<size_t>(len);
+        m_head.store(head + 1, memory_order_release);
+
+        if (++unnotified == NOTIFY_BATCH)
+        {
+            notify();
+            unnotified = 0;
+        }
+    }
+
+    if (unnotified > 0)
+        notify();
+
+    return !full;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "selectable.h"
+#include "netlinkresync.h"
+
+#include <netlink/netlink.h>
+#include <netlink/route/rtnl.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace swss
+{
+    /*
+     * Netlink socket received from by its own thread.
+     *
+     * The thread copies datagrams into a lock-free single producer, single
+     * consumer ring and wakes up Select. Messages are dispatched through
+     * NetDispatcher from updateAfterRead, on the thread running Select, so
+     * handlers are not called concurrently.
+     *
+     * Use one instance per group, or per set of groups, that should be
+     * serviced independently. Select returns the ready instance with the
+     * highest priority first and each return dispatches at most the read
+     * budget, so link and neighbor events given a higher priority than
+     * route events are not delayed by a route storm.
+     *
+     * While the ring is full, datagrams wait in the socket, which may then
+     * overflow. Overflow is recovered from as by NetLink: the socket buffer
+     * is grown and the resync dumps are replayed from the dispatch thread.
+     */
+    class ThreadedNetLink :
+        public Selectable
+    {
+        public:
+
+            static constexpr size_t DEFAULT_RING_SIZE = 128;
+            static constexpr size_t DEFAULT_RECV_BUF_SIZE = 32768;
+            static constexpr unsigned int DEFAULT_READ_BUDGET = 64;
+
+            /* ringSize datagrams of up to bufSize bytes are held between the threads */
+            ThreadedNetLink(int pri = 0, size_t ringSize = DEFAULT_RING_SIZE,
+                            size_t bufSize = DEFAULT_RECV_BUF_SIZE);
+            ~ThreadedNetLink() override;
+
+            void registerGroup(int rtnlGroup);
+            void dumpRequest(int rtmGetCommand);
+            bool setSockBufSize(uint32_t sockBufSize);
+
+            /* Same as NetLink::enableAutoResync and NetLink::setAdaptiveSockBufSize */
+            void enableAutoResync(const std::vector<int> &rtmGetCommands);
+            void setAdaptiveSockBufSize(uint32_t maxSockBufSize);
+
+            /* Maximum number of datagrams dispatched per Select return */
+            void setReadBudget(unsigned int datagrams);
+
+            /* Start and stop the receive thread, stop is also done on destruction */
+            void start();
+            void stop();
+
+            uint64_t getOverflowCount() const { return m_resync.getOverflowCount(); }
+            uint64_t getResyncCount() const { return m_resync.getResyncCount(); }
+            uint32_t getSockBufSize() const { return m_resync.getSockBufSize(); }
+            bool isResyncInProgress() const { return m_resync.isResyncInProgress(); }
+            uint64_t getDatagramCount() const { return m_datagramCount.load(); }
+
+            /* Number of datagrams received and not dispatched yet */
+            size_t getPendingCount() const;
+
+            /* Netlink socket, e.g. to find its port id */
+            int getSocketFd();
+
+            /* The eventfd signaled by the receive thread */
+            int getFd() override;
+            uint64_t readData() override;
+            bool hasData() override;
+            bool hasCachedData() override;
+            void updateAfterRead() override;
+
+        private:
+
+            void receiveLoop();
+            bool receiveAvailable();
+            void notify();
+
+            struct nl_sock *m_socket;
+            int m_efd;
+            int m_stopFd;
+            std::thread m_thread;
+
+            unsigned int m_readBudget;
+
+            /*
+             * Ring of datagrams, m_head is written by the receive thread, m_tail by the reader.
+             * A length of 0 marks a socket overflow at that point of the stream.
+             */
+            size_t m_ringSize;
+            size_t m_bufSize;
+            std::vector<char> m_buffers;
+            std::vector<size_t> m_lengths;
+            std::atomic<size_t> m_head;
+            std::atomic<size_t> m_tail;
+
+            NetLinkResync m_resync;
+            std::atomic<uint64_t> m_datagramCount;
+    };
+}
@@ -6,30 +6,23 @@ namespace swss {
 
 vector<string> tokenize(const string &str, const char token)
 {
-    string tmp;
     vector<string> ret;
-    istringstream iss(str);
+    Tokenizer tokenizer(str, token);
+    StringRef tok;
 
-    while (getline(iss, tmp, token))
-        ret.push_back(tmp);
+    while (tokenizer.next(tok))
+        ret.emplace_back(tok.data(), tok.size());
 
     return ret;
 }
 vector<string> tokenize(const string &str, const char token, const size_t firstN)
 {
     vector<string> ret;
-    string tmp = str;
-    size_t i = 0;
-    auto pos = tmp.find(token);
-
-    while (pos != string::npos && i++ < firstN)
-    {
-        ret.push_back(tmp.substr(0, pos));
-        tmp = tmp.substr(pos+1);
-        pos = tmp.find(token);
-    }
-
-    ret.push_back(tmp);
+    Tokenizer tokenizer(str, token, firstN);
+    StringRef tok;
+
+    while (tokenizer.next(tok))
+        ret.emplace_back(tok.data(), tok.size());
 
     return ret;
 }
@@ -1,7 +1,10 @@
 #ifndef __TOKENIZE__
 #define __TOKENIZE__
 
+#include <stdint.h>
+#include <string.h>
 #include <sstream>
+#include <string>
 #include <vector>
 
 namespace swss {
@@ -9,6 +12,157 @@ namespace swss {
 std::vector<std::string> tokenize(const std::string &, const char token);
 std::vector<std::string> tokenize(const std::string &, const char token, const size_t firstN);
 
+/*
+ * Piece of a string, not owning: valid as long as the tokenized string is
+ * alive and unchanged.
+ */
+class StringRef
+{
+public:
+    StringRef() : m_data(""), m_size(0) {}
+    StringRef(const char *data, size_t size) : m_data(data), m_size(size) {}
+    StringRef(const std::string &str) : m_data(str.data()), m_size(str.size()) {}
+
+    inline const char *data() const
+    {
+        return m_data;
+    }
+
+    inline size_t size() const
+    {
+        return m_size;
+    }
+
+    inline bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    inline std::string str() const
+    {
+        return std::string(m_data, m_size);
+    }
+
+    inline bool operator==(const StringRef &o) const
+    {
+        return m_size == o.m_size && memcmp(m_data, o.m_data, m_size) == 0;
+    }
+
+    inline bool operator!=(const StringRef &o) const
+    {
+        return !(*this == o);
+    }
+
+    inline bool operator==(const char *str) const
+    {
+        return *this == StringRef(str, strlen(str));
+    }
+
+    inline bool operator!=(const char *str) const
+    {
+        return !(*this == str);
+    }
+
+private:
+    const char *m_data;
+    size_t m_size;
+};
+
+/*
+ * Splits a string on token without copying, one StringRef per call to
+ * next(). Yields the same tokens as tokenize(): without firstN a trailing
+ * empty token is dropped, with firstN the rest of the string after firstN
+ * splits is always the last token.
+ */
+class Tokenizer
+{
+public:
+    Tokenizer(const char *str, size_t len, char token) :
+        m_pos(str), m_end(str + len), m_token(token),
+        m_splits(SIZE_MAX), m_limited(false), m_done(false) {}
+
+    Tokenizer(const char *str, size_t len, char token, size_t firstN) :
+        m_pos(str), m_end(str + len), m_token(token),
+        m_splits(firstN), m_limited(true), m_done(false) {}
+
+    Tokenizer(const std::string &str, char token) :
+        Tokenizer(str.data(), str.size(), token) {}
+
+    Tokenizer(const std::string &str, char token, size_t firstN) :
+        Tokenizer(str.data(), str.size(), token, firstN) {}
+
+    /* Tokens would point into a destroyed temporary */
+    Tokenizer(std::string &&, char) = delete;
+    Tokenizer(std::string &&, char, size_t) = delete;
+
+    /* Returns false once all tokens were returned */
+    inline bool next(StringRef &tok)
+    {
+        if (m_done)
+            return false;
+
+        const char *found = m_splits == 0 ? nullptr :
+            static_cast<const char *>(memchr(m_pos, m_token, static_cast<size_t>(m_end - m_pos)));
+
+        if (found)
+        {
+            tok = StringRef(m_pos, static_cast<size_t>(found - m_pos));
+            m_pos = found + 1;
+            m_splits--;
+            return true;
+        }
+
+        m_done = true;
+        if (!m_limited && m_pos == m_end)
+            return false;
+
+        tok = StringRef(m_pos, static_cast<size_t>(m_end - m_pos));
+        return true;
+    }
+
+    /* Rest of the string after the tokens returned so far */
+    inline StringRef rest() const
+    {
+        return m_done ? StringRef() : StringRef(m_pos, static_cast<size_t>(m_end - m_pos));
+    }
+
+private:
+    const char *m_pos;
+    const char *m_end;
+    char m_token;
+    size_t m_splits;
+    bool m_limited;
+    bool m_done;
+};
+
+/*
+ * Split into at most N tokens stored in out, the last one holding the rest
+ * of the string like tokenize(str, token, N - 1). Returns the number of
+ * tokens, e.g. 2 for "Ethernet0|10.0.0.1/31" split on '|' into out[2].
+ */
+template<size_t N>
+inline size_t tokenize(const char *str, size_t len, const char token, StringRef (&out)[N])
+{
+    static_assert(N > 0, "tokenize needs room for at least one token");
+
+    Tokenizer tokenizer(str, len, token, N - 1);
+    size_t count = 0;
+
+    while (count < N && tokenizer.next(out[count]))
+        count++;
+
+    return count;
+}
+
+template<size_t N>
+inline size_t tokenize(const std::string &str, const char token, StringRef (&out)[N])
+{
+    return tokenize(str.data(), str.size(), token, out);
+}
+
+template<size_t N>
+size_t tokenize(std::string &&, const char, StringRef (&)[N]) = delete;
+
 }
 
 #endif /* TOKENIZE */
@@ -0,0 +1,251 @@
+#include "trace.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+using namespace swss;
+
+std::atomic<Trace::File *> Trace::m_file(nullptr);
+
+namespace
+{
+
+std::runtime_error traceError(const std::string &what, const std::string &path)
+{
+    return std::runtime_error(what + " " + path + ": " + strerror(errno));
+}
+
+uint64_t clockNow(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t ticksPerSecond()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    /* Count the TSC ticks over 10 ms of CLOCK_MONOTONIC */
+    uint64_t monotonic = clockNow(CLOCK_MONOTONIC);
+    uint64_t ticks = Trace::now();
+
+    struct timespec delay = { 0, 10000000 };
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR);
+
+    ticks = Trace::now() - ticks;
+    monotonic = clockNow(CLOCK_MONOTONIC) - monotonic;
+
+    return ticks * 1000000000ULL / monotonic;
+#else
+    return 1000000000ULL;
+#endif
+}
+
+/* ns of a number of ticks, which may be negative */
+double tickToNs(double ticks, uint64_t ticksPerSecond)
+{
+    return ticks * 1e9 / static_cast<double>(ticksPerSecond);
+}
+
+uint32_t threadId()
+{
+    static thread_local uint32_t tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    return tid;
+}
+
+inline uint8_t copyTruncated(char *dst, size_t size, const char *src, size_t len)
+{
+    if (len > size)
+        len = size;
+
+    memcpy(dst, src, len);
+    return static_cast<uint8_t>(len);
+}
+
+}
+
+void Trace::open(const std::string &path, size_t capacity)
+{
+    uint64_t records = 1;
+    while (records < capacity)
+        records <<= 1;
+
+    size_t size = TRACE_HEADER_SIZE + records * sizeof(TraceRecord);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw traceError("Unable to create trace file", path);
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        auto error = traceError("Unable to size trace file", path);
+        ::close(fd);
+        throw error;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        throw traceError("Unable to map trace file", path);
+
+    /* The file is all zeros, so every record starts incomplete */
+    auto header = new (map) TraceFileHeader();
+    memcpy(header->magic, TRACE_MAGIC, sizeof(header->magic));
+    header->version = TRACE_VERSION;
+    header->recordSize = static_cast<uint32_t>(sizeof(TraceRecord));
+    header->capacity = records;
+    header->pid = static_cast<uint64_t>(getpid());
+    header->ticksPerSecond = ticksPerSecond();
+    header->tickBase = now();
+    header->realtimeBase = clockNow(CLOCK_REALTIME);
+    header->next.store(0, std::memory_order_relaxed);
+
+    File *file = new File;
+    file->header = header;
+    file->records = reinterpret_cast<TraceRecord *>(static_cast<char *>(map) + TRACE_HEADER_SIZE);
+    file->mask = records - 1;
+
+    /* A previous file stays mapped, see close() */
+    m_file.store(file, std::memory_order_release);
+}
+
+void Trace::close()
+{
+    m_file.store(nullptr, std::memory_order_release);
+}
+
+void Trace::record(TraceEvent event, uint64_t timestamp, uint64_t duration,
+                   const char *table, size_t tableLen, const char *key, size_t keyLen, uint32_t count)
+{
+    File *file = m_file.load(std::memory_order_acquire);
+    if (!file)
+        return;
+
+    uint64_t index = file->header->next.fetch_add(1, std::memory_order_relaxed);
+    TraceRecord &record = file->records[index & file->mask];
+
+    /* Readers skip the record until seq is set again */
+    record.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    record.timestamp = timestamp;
+    record.duration = duration;
+    record.tid = threadId();
+    record.count = count;
+    record.event = static_cast<uint8_t>(event);
+    record.tableLen = copyTruncated(record.table, sizeof(record.table), table, tableLen);
+    record.keyLen = copyTruncated(record.key, sizeof(record.key), key, keyLen);
+
+    record.seq.store(index + 1, std::memory_order_release);
+}
+
+TraceReader::TraceReader(const std::string &path) : m_map(MAP_FAILED), m_size(0)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw traceError("Unable to open trace file", path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        auto error = traceError("Unable to stat trace file", path);
+        ::close(fd);
+        throw error;
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size >= TRACE_HEADER_SIZE)
+        m_map = mmap(NULL, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (m_map == MAP_FAILED)
+        throw std::runtime_error("Unable to map trace file " + path);
+
+    m_header = static_cast<const TraceFileHeader *>(m_map);
+    m_records = reinterpret_cast<const TraceRecord *>(static_cast<const char *>(m_map) + TRACE_HEADER_SIZE);
+
+    uint64_t capacity = m_header->capacity;
+    if (memcmp(m_header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        m_header->version != TRACE_VERSION ||
+        m_header->recordSize != sizeof(TraceRecord) ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0 || m_header->ticksPerSecond == 0 ||
+        capacity > (m_size - TRACE_HEADER_SIZE) / sizeof(TraceRecord))
+    {
+        munmap(m_map, m_size);
+        throw std::runtime_error("Not a trace file " + path);
+    }
+}
+
+TraceReader::~TraceReader()
+{
+    munmap(m_map, m_size);
+}
+
+std::vector<TraceEntry> TraceReader::read() const
+{
+    std::vector<TraceEntry> entries;
+
+    uint64_t capacity = m_header->capacity;
+    uint64_t next = m_header->next.load(std::memory_order_acquire);
+    uint64_t first = next > capacity ? next - capacity : 0;
+
+    entries.reserve(static_cast<size_t>(next - first));
+
+    for (uint64_t index = first; index < next; index++)
+    {
+        const TraceRecord &record = m_records[index & (capacity - 1)];
+        if (record.seq.load(std::memory_order_acquire) != index + 1)
+            continue;
+
+        TraceEntry entry;
+        entry.seq = index;
+        entry.timestamp = record.timestamp;
+        entry.duration = record.duration;
+        entry.tid = record.tid;
+        entry.count = record.count;
+        entry.event = static_cast<TraceEvent>(record.event);
+        entry.table.assign(record.table, std::min<size_t>(record.tableLen, sizeof(record.table)));
+        entry.key.assign(record.key, std::min<size_t>(record.keyLen, sizeof(record.key)));
+
+        /* Overwritten while copied */
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (record.seq.load(std::memory_order_relaxed) != index + 1)
+            continue;
+
+        /* Records of other cores may be a few ticks before the base */
+        double sinceBase = static_cast<double>(static_cast<int64_t>(entry.timestamp - m_header->tickBase));
+        entry.timestamp = m_header->realtimeBase +
+                          static_cast<uint64_t>(static_cast<int64_t>(tickToNs(sinceBase, m_header->ticksPerSecond)));
+        entry.duration = static_cast<uint64_t>(tickToNs(static_cast<double>(entry.duration), m_header->ticksPerSecond));
+
+        entries.push_back(entry);
+    }
+
+    return entries;
+}
+
+const char *TraceReader::eventName(TraceEvent event)
+{
+    switch (event)
+    {
+        case TRACE_PRODUCER_SET:
+            return "ProducerStateTable::set";
+        case TRACE_PRODUCER_DEL:
+            return "ProducerStateTable::del";
+        case TRACE_CONSUMER_POPS:
+            return "pops";
+        case TRACE_PIPELINE_FLUSH:
+            return "RedisPipeline::flush";
+        case TRACE_SELECT_DISPATCH:
+            return "Select";
+        default:
+            return "unknown";
+    }
+}
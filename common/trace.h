@@ -0,0 +1,210 @@
+#ifndef __TRACE__
+#define __TRACE__
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace swss {
+
+enum TraceEvent
+{
+    TRACE_PRODUCER_SET = 1,     /* ProducerStateTable::set, table and key */
+    TRACE_PRODUCER_DEL,         /* ProducerStateTable::del, table and key */
+    TRACE_CONSUMER_POPS,        /* pops of a consumer table, count popped */
+    TRACE_PIPELINE_FLUSH,       /* RedisPipeline::flush, count of replies */
+    TRACE_SELECT_DISPATCH,      /* Select returning an object, its class and fd */
+};
+
+static const size_t TRACE_TABLE_SIZE = 32;
+static const size_t TRACE_KEY_SIZE = 56;
+
+/* One fixed-size record of the trace file, strings are truncated */
+struct TraceRecord
+{
+    /* Index of the record + 1 once complete, 0 while being written */
+    std::atomic<uint64_t> seq;
+    uint64_t timestamp;         /* Trace::now() at the start */
+    uint64_t duration;          /* In Trace::now() ticks */
+    uint32_t tid;
+    uint32_t count;
+    uint8_t event;
+    uint8_t tableLen;
+    uint8_t keyLen;
+    uint8_t reserved[5];
+    char table[TRACE_TABLE_SIZE];
+    char key[TRACE_KEY_SIZE];
+};
+
+static_assert(sizeof(TraceRecord) == 128, "trace records are two cache lines");
+
+/* Start of the trace file, the records follow at TRACE_HEADER_SIZE */
+struct TraceFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t capacity;          /* Records in the ring, a power of two */
+    uint64_t pid;
+    uint64_t tickBase;          /* Trace::now() taken with realtimeBase */
+    uint64_t realtimeBase;      /* CLOCK_REALTIME ns */
+    uint64_t ticksPerSecond;
+
+    /* Records written so far, the next one goes to next % capacity */
+    alignas(64) std::atomic<uint64_t> next;
+};
+
+static const char TRACE_MAGIC[8] = { 'S', 'W', 'S', 'S', 'T', 'R', 'C', '\0' };
+static const uint32_t TRACE_VERSION = 1;
+static const size_t TRACE_HEADER_SIZE = 4096;
+
+/*
+ * Binary trace of table operations into a ring of records in a memory
+ * mapped file, written without locks from any thread. The file outlives a
+ * crash of the process; swsstrace exports it as text or Chrome trace JSON.
+ */
+class Trace
+{
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+    /*
+     * Create or truncate path with room for capacity records, rounded up to
+     * a power of two, and start tracing. Throws std::runtime_error.
+     */
+    static void open(const std::string &path, size_t capacity = DEFAULT_CAPACITY);
+
+    /*
+     * Stop tracing. The mapping is kept until exit, for the records still
+     * being written by other threads.
+     */
+    static void close();
+
+    static inline bool isEnabled()
+    {
+        return m_file.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    /*
+     * Timestamp of the records: the TSC on x86, which costs half of
+     * clock_gettime(), and CLOCK_MONOTONIC ns elsewhere. open() calibrates
+     * the ticks against the clocks for the reader.
+     */
+    static inline uint64_t now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+    }
+
+    static void record(TraceEvent event, uint64_t timestamp, uint64_t duration,
+                       const char *table, size_t tableLen, const char *key, size_t keyLen, uint32_t count);
+
+private:
+    struct File
+    {
+        TraceFileHeader *header;
+        TraceRecord *records;
+        uint64_t mask;
+    };
+
+    static std::atomic<File *> m_file;
+};
+
+/*
+ * Records the time from its construction to its destruction, when tracing.
+ * The strings must not change meanwhile.
+ */
+class TraceSpan
+{
+public:
+    TraceSpan(TraceEvent event, const std::string &table) :
+        TraceSpan(event, table.data(), table.size(), "", 0) {}
+
+    TraceSpan(TraceEvent event, const std::string &table, const std::string &key) :
+        TraceSpan(event, table.data(), table.size(), key.data(), key.size()) {}
+
+    TraceSpan(TraceEvent event, const char *table, size_t tableLen, const char *key, size_t keyLen) :
+        m_event(event), m_table(table), m_tableLen(tableLen), m_key(key), m_keyLen(keyLen),
+        m_count(0), m_start(Trace::isEnabled() ? Trace::now() : 0) {}
+
+    ~TraceSpan()
+    {
+        if (m_start && Trace::isEnabled())
+        {
+            Trace::record(m_event, m_start, Trace::now() - m_start, m_table, m_tableLen, m_key, m_keyLen, m_count);
+        }
+    }
+
+    inline void setCount(size_t count)
+    {
+        m_count = count > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(count);
+    }
+
+private:
+    TraceSpan(const TraceSpan &other);
+    TraceSpan &operator=(const TraceSpan &other);
+
+    TraceEvent m_event;
+    const char *m_table;
+    size_t m_tableLen;
+    const char *m_key;
+    size_t m_keyLen;
+    uint32_t m_count;
+    uint64_t m_start;
+};
+
+/* A complete record read back from a trace file */
+struct TraceEntry
+{
+    uint64_t seq;
+    uint64_t timestamp;         /* CLOCK_REALTIME ns */
+    uint64_t duration;          /* ns */
+    uint32_t tid;
+    uint32_t count;
+    TraceEvent event;
+    std::string table;
+    std::string key;
+};
+
+/* Reads a trace file, also while it is being written */
+class TraceReader
+{
+public:
+    /* Throws std::runtime_error when path is not a trace file */
+    TraceReader(const std::string &path);
+    ~TraceReader();
+
+    /* Complete records still in the ring, oldest first */
+    std::vector<TraceEntry> read() const;
+
+    inline uint64_t getPid() const
+    {
+        return m_header->pid;
+    }
+
+    static const char *eventName(TraceEvent event);
+
+private:
+    TraceReader(const TraceReader &other);
+    TraceReader &operator=(const TraceReader &other);
+
+    void *m_map;
+    size_t m_size;
+    const TraceFileHeader *m_header;
+    const TraceRecord *m_records;
+};
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <stdexcept>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <cxxabi.h>
+#include "trace.h"
+#include "json.hpp"
+
+using namespace swss;
+using json = nlohmann::json;
+
+[[ noreturn ]] void usage(const std::string &program, int status, const std::string &message)
+{
+    if (message.size() != 0)
+    {
+        std::cout << message << std::endl << std::endl;
+    }
+
+    std::cout << "Usage: " << program << " [OPTIONS]" << std::endl
+              << "Export a SONiC table operation trace file." << std::endl << std::endl
+              << "Options:" << std::endl
+              << "\t -h\tprint this message" << std::endl
+              << "\t -f\ttrace file written with swss::Trace::open()" << std::endl
+              << "\t -j\texport in the Chrome trace event JSON format instead of text" << std::endl << std::endl
+              << "Examples:" << std::endl
+              << "\t" << program << " -f /var/log/swss/orchagent.trace # print the records" << std::endl
+              << "\t" << program << " -f /var/log/swss/orchagent.trace -j > trace.json # for chrome://tracing" << std::endl;
+
+    exit(status);
+}
+
+/* Select records mangled class names */
+std::string tableName(const TraceEntry &entry)
+{
+    if (entry.event != TRACE_SELECT_DISPATCH)
+        return entry.table;
+
+    int status = 0;
+    char *name = abi::__cxa_demangle(entry.table.c_str(), NULL, NULL, &status);
+    if (status != 0 || name == NULL)
+        return entry.table;
+
+    std::string demangled(name);
+    free(name);
+    return demangled;
+}
+
+void printText(const std::vector<TraceEntry> &entries)
+{
+    for (const auto &entry : entries)
+    {
+        time_t seconds = static_cast<time_t>(entry.timestamp / 1000000000ULL);
+        struct tm tm;
+        char date[32];
+
+        localtime_r(&seconds, &tm);
+        strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &tm);
+
+        std::cout << date << "." << std::setfill('0') << std::setw(9) << entry.timestamp % 1000000000ULL
+                  << std::setfill(' ') << " " << std::setw(7) << entry.tid << " "
+                  << std::left << std::setw(24) << TraceReader::eventName(entry.event) << std::right;
+
+        std::string table = tableName(entry);
+        if (entry.event == TRACE_SELECT_DISPATCH)
+            std::cout << " " << table << " fd=" << entry.count;
+        else if (!table.empty())
+            std::cout << " " << table;
+
+        if (!entry.key.empty())
+            std::cout << ":" << entry.key;
+
+        if (entry.event == TRACE_CONSUMER_POPS || entry.event == TRACE_PIPELINE_FLUSH)
+            std::cout << " count=" << entry.count;
+
+        std::cout << " " << entry.duration << "ns" << std::endl;
+    }
+}
+
+void printJson(const TraceReader &reader, const std::vector<TraceEntry> &entries)
+{
+    json events = json::array();
+
+    for (const auto &entry : entries)
+    {
+        json args = json::object();
+        std::string table = tableName(entry);
+
+        if (!table.empty())
+            args["table"] = table;
+        if (!entry.key.empty())
+            args["key"] = entry.key;
+        if (entry.event == TRACE_SELECT_DISPATCH)
+            args["fd"] = entry.count;
+        else if (entry.event == TRACE_CONSUMER_POPS || entry.event == TRACE_PIPELINE_FLUSH)
+            args["count"] = entry.count;
+
+        /* Chrome expects microseconds */
+        events.push_back({
+            {"name", TraceReader::eventName(entry.event)},
+            {"cat", "swss"},
+            {"ph", "X"},
+            {"ts", static_cast<double>(entry.timestamp) / 1000.0},
+            {"dur", static_cast<double>(entry.duration) / 1000.0},
+            {"pid", reader.getPid()},
+            {"tid", entry.tid},
+            {"args", args},
+        });
+    }
+
+    json trace = {
+        {"traceEvents", events},
+        {"displayTimeUnit", "ns"},
+    };
+
+    std::cout << trace.dump() << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    bool chrome = false;
+    std::string path;
+    auto exitWithUsage = std::bind(usage, argv[0], std::placeholders::_1, std::placeholders::_2);
+
+    while ((opt = getopt (argc, argv, "f:jh")) != -1)
+    {
+        switch(opt)
+        {
+            case 'f':
+                path = optarg;
+                break;
+            case 'j':
+                chrome = true;
+                break;
+            case 'h':
+                exitWithUsage(EXIT_SUCCESS, "");
+                break;
+            default:
+                exitWithUsage(EXIT_FAILURE, "Invalid option");
+        }
+    }
+
+    if (path.empty())
+    {
+        exitWithUsage(EXIT_FAILURE, "No trace file given");
+    }
+
+    try
+    {
+        TraceReader reader(path);
+        auto entries = reader.read();
+
+        if (chrome)
+            printJson(reader, entries);
+        else
+            printText(entries);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
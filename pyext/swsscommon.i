@@ -35,6 +35,8 @@
 #include "notificationproducer.h"
 #include "warm_restart.h"
 #include "logger.h"
+#include "logsettingwatcher.h"
+#include "metrics.h"
 %}
 
 %include <std_string.i>
@@ -154,3 +156,5 @@ T castSelectableObj(swss::Selectable *temp)
 %include "warm_restart.h"
 %include "dbinterface.h"
 %include "logger.h"
+%include "logsettingwatcher.h"
+%include "metrics.h"
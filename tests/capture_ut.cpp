@@ -0,0 +1,212 @@
+#include <unistd.h>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "common/capture.h"
+#include "common/dbconnector.h"
+#include "common/producerstatetable.h"
+#include "common/producertable.h"
+#include "common/notificationproducer.h"
+
+using namespace std;
+using namespace swss;
+
+static const string CAPTURE_FILE = "./capture_ut.capture";
+
+static void clearCaptureTable(DBConnector &db, const string &tableName)
+{
+    for (const auto &key : db.keys("*" + tableName + "*"))
+        db.del(key);
+}
+
+static vector<CaptureEntry> readCapture(const string &path)
+{
+    CaptureReader reader(path);
+    vector<CaptureEntry> entries;
+    CaptureEntry entry;
+
+    while (reader.read(entry))
+        entries.push_back(entry);
+
+    return entries;
+}
+
+TEST(Capture, records)
+{
+    string tableName = "UT_CAPTURE_TABLE";
+    DBConnector db("APPL_DB", 0, true);
+    clearCaptureTable(db, tableName);
+
+    ProducerStateTable p(&db, tableName);
+    ProducerTable pq(&db, tableName);
+    NotificationProducer np(&db, "UT_CAPTURE_CHANNEL");
+
+    Capture::open(CAPTURE_FILE);
+    EXPECT_TRUE(Capture::isEnabled());
+
+    p.set("key1", { { "field1", "value1" }, { "field2", "value2" } });
+    p.del("key2");
+    p.set({ KeyOpFieldsValuesTuple("key3", SET_COMMAND, { { "field", "value" } }),
+            KeyOpFieldsValuesTuple("key4", SET_COMMAND, {}) });
+    p.del(vector<string>{ "key5" });
+    pq.set("key6", { { "field", "value" } }, "create");
+    pq.del("key7", "remove");
+    vector<FieldValueTuple> values = { { "field", "value" } };
+    np.send("op", "data", values);
+
+    Capture::close();
+    EXPECT_FALSE(Capture::isEnabled());
+    p.set("not captured", { { "field", "value" } });
+
+    CaptureReader reader(CAPTURE_FILE);
+    EXPECT_EQ(reader.getPid(), static_cast<uint64_t>(getpid()));
+
+    auto entries = readCapture(CAPTURE_FILE);
+    ASSERT_EQ(entries.size(), 8U);
+
+    EXPECT_EQ(entries[0].source, CAPTURE_PRODUCER_STATE_TABLE);
+    EXPECT_EQ(entries[0].operation, CAPTURE_SET);
+    EXPECT_EQ(entries[0].dbName, "APPL_DB");
+    EXPECT_EQ(entries[0].table, tableName);
+    EXPECT_EQ(entries[0].key, "key1");
+    EXPECT_EQ(entries[0].op, SET_COMMAND);
+    ASSERT_EQ(entries[0].values.size(), 2U);
+    EXPECT_EQ(fvField(entries[0].values[1]), "field2");
+    EXPECT_EQ(fvValue(entries[0].values[1]), "value2");
+
+    EXPECT_EQ(entries[1].operation, CAPTURE_DEL);
+    EXPECT_EQ(entries[1].key, "key2");
+    EXPECT_TRUE(entries[1].values.empty());
+
+    EXPECT_EQ(entries[2].key, "key3");
+    EXPECT_EQ(entries[3].key, "key4");
+    EXPECT_TRUE(entries[3].values.empty());
+    EXPECT_EQ(entries[4].operation, CAPTURE_DEL);
+    EXPECT_EQ(entries[4].key, "key5");
+
+    EXPECT_EQ(entries[5].source, CAPTURE_PRODUCER_TABLE);
+    EXPECT_EQ(entries[5].operation, CAPTURE_SET);
+    EXPECT_EQ(entries[5].op, "create");
+    EXPECT_EQ(entries[6].operation, CAPTURE_DEL);
+    EXPECT_EQ(entries[6].op, "remove");
+
+    EXPECT_EQ(entries[7].source, CAPTURE_NOTIFICATION_PRODUCER);
+    EXPECT_EQ(entries[7].operation, CAPTURE_SEND);
+    EXPECT_EQ(entries[7].table, "UT_CAPTURE_CHANNEL");
+    EXPECT_EQ(entries[7].op, "op");
+    EXPECT_EQ(entries[7].key, "data");
+    EXPECT_EQ(entries[7].values.size(), 1U);
+
+    for (size_t i = 1; i < entries.size(); i++)
+    {
+        EXPECT_GE(entries[i].timestamp, entries[i - 1].timestamp);
+    }
+
+    unlink(CAPTURE_FILE.c_str());
+    clearCaptureTable(db, tableName);
+}
+
+TEST(Capture, tempView)
+{
+    string tableName = "UT_CAPTURE_VIEW";
+    DBConnector db("APPL_DB", 0, true);
+    clearCaptureTable(db, tableName);
+
+    Table table(&db, tableName);
+    table.set("stale", { { "field", "value" } });
+    table.set("same", { { "field", "value" } });
+
+    ProducerStateTable p(&db, tableName);
+    Capture::open(CAPTURE_FILE);
+
+    p.create_temp_view();
+    p.set("same", { { "field", "value" } });
+    p.set("new", { { "field", "value" } });
+    p.apply_temp_view();
+
+    Capture::close();
+
+    /* Only what the view switch wrote */
+    auto entries = readCapture(CAPTURE_FILE);
+    ASSERT_EQ(entries.size(), 2U);
+    EXPECT_EQ(entries[0].operation, CAPTURE_DEL);
+    EXPECT_EQ(entries[0].key, "stale");
+    EXPECT_EQ(entries[1].operation, CAPTURE_SET);
+    EXPECT_EQ(entries[1].key, "new");
+    EXPECT_EQ(entries[1].values.size(), 1U);
+
+    unlink(CAPTURE_FILE.c_str());
+    clearCaptureTable(db, tableName);
+}
+
+TEST(Capture, truncated)
+{
+    Capture::open(CAPTURE_FILE);
+    for (int i = 0; i < 3; i++)
+    {
+        Capture::record(CAPTURE_PRODUCER_STATE_TABLE, CAPTURE_SET, "APPL_DB", "ROUTE_TABLE",
+                        "10.0.0." + to_string(i) + "/32", SET_COMMAND, { { "nexthop", "10.1.0.1" } });
+    }
+    Capture::close();
+
+    /* Cut in the last record, as by a crash */
+    ifstream in(CAPTURE_FILE, ios::binary | ios::ate);
+    auto size = static_cast<off_t>(in.tellg());
+    in.close();
+    ASSERT_EQ(truncate(CAPTURE_FILE.c_str(), size - 5), 0);
+
+    auto entries = readCapture(CAPTURE_FILE);
+    ASSERT_EQ(entries.size(), 2U);
+    EXPECT_EQ(entries[1].key, "10.0.0.1/32");
+
+    unlink(CAPTURE_FILE.c_str());
+}
+
+TEST(Capture, concurrentWriters)
+{
+    const int threads = 4;
+    const int records = 1000;
+
+    Capture::open(CAPTURE_FILE);
+
+    vector<thread> writers;
+    for (int t = 0; t < threads; t++)
+    {
+        writers.emplace_back([t]() {
+            for (int i = 0; i < records; i++)
+            {
+                Capture::record(CAPTURE_PRODUCER_STATE_TABLE, CAPTURE_SET, "APPL_DB", "ROUTE_TABLE",
+                                to_string(t) + ":" + to_string(i), SET_COMMAND, {});
+            }
+        });
+    }
+
+    for (auto &writer : writers)
+        writer.join();
+
+    Capture::close();
+
+    /* Stamped in file order whatever the thread */
+    auto entries = readCapture(CAPTURE_FILE);
+    ASSERT_EQ(entries.size(), static_cast<size_t>(threads * records));
+    for (size_t i = 1; i < entries.size(); i++)
+    {
+        ASSERT_GE(entries[i].timestamp, entries[i - 1].timestamp);
+    }
+
+    unlink(CAPTURE_FILE.c_str());
+}
+
+TEST(Capture, notCaptureFile)
+{
+    {
+        ofstream out(CAPTURE_FILE);
+        out << "not a capture file, longer than the header" << endl;
+    }
+
+    EXPECT_THROW(CaptureReader reader(CAPTURE_FILE), runtime_error);
+    EXPECT_THROW(CaptureReader reader("./capture_ut.missing"), runtime_error);
+
+    unlink(CAPTURE_FILE.c_str());
+}
@@ -91,3 +91,103 @@ TEST(CONVERTER, uppercase)
     const string c_val = "AbCd123$%^";
     EXPECT_EQ("ABCD123$%^", to_upper(c_val));
 }
+
+TEST(CONVERTER, try_convert)
+{
+    uint64_t u = 1;
+    int64_t i = 1;
+    uint16_t u16 = 1;
+    int8_t i8 = 1;
+
+    EXPECT_EQ(CONVERT_OK, try_to_uint<uint64_t>("18446744073709551615", u));
+    EXPECT_EQ(18446744073709551615LU, u);
+    EXPECT_EQ(CONVERT_OK, try_to_uint<uint64_t>("0x1F", u));
+    EXPECT_EQ(31LU, u);
+    EXPECT_EQ(CONVERT_OK, try_to_uint<uint64_t>("017", u));
+    EXPECT_EQ(15LU, u);
+    EXPECT_EQ(CONVERT_OK, try_to_uint<uint64_t>(" \t+42", u));
+    EXPECT_EQ(42LU, u);
+    EXPECT_EQ(CONVERT_OK, try_to_int<int64_t>("-9223372036854775808", i));
+    EXPECT_EQ(numeric_limits<int64_t>::min(), i);
+    EXPECT_EQ(CONVERT_OK, try_to_int<int64_t>("-0x10", i));
+    EXPECT_EQ(-16, i);
+
+    /* Only part of the buffer is converted */
+    const char counters[] = "1234,5678";
+    EXPECT_EQ(CONVERT_OK, try_to_uint64(counters, 4, u));
+    EXPECT_EQ(1234LU, u);
+    EXPECT_EQ(CONVERT_OK, try_to_uint64(counters + 5, 4, u));
+    EXPECT_EQ(5678LU, u);
+
+    u = 7;
+    EXPECT_EQ(CONVERT_ERROR_INVALID, try_to_uint<uint64_t>("", u));
+    EXPECT_EQ(CONVERT_ERROR_INVALID, try_to_uint<uint64_t>("str1", u));
+    EXPECT_EQ(CONVERT_ERROR_INVALID, try_to_uint<uint64_t>("- 1", u));
+    EXPECT_EQ(CONVERT_ERROR_TRAILING, try_to_uint<uint64_t>("1234asd", u));
+    EXPECT_EQ(CONVERT_ERROR_TRAILING, try_to_uint<uint64_t>("0x", u));
+    EXPECT_EQ(CONVERT_ERROR_TRAILING, try_to_uint<uint64_t>("08", u));
+    EXPECT_EQ(CONVERT_ERROR_TRAILING, try_to_uint<uint64_t>("1 ", u));
+    EXPECT_EQ(CONVERT_ERROR_OVERFLOW, try_to_uint<uint64_t>("18446744073709551616", u));
+    EXPECT_EQ(7LU, u);
+
+    EXPECT_EQ(CONVERT_ERROR_OVERFLOW, try_to_int<int64_t>("9223372036854775808", i));
+    EXPECT_EQ(CONVERT_ERROR_OVERFLOW, try_to_int<int64_t>("-9223372036854775809", i));
+
+    EXPECT_EQ(CONVERT_ERROR_RANGE, try_to_uint<uint16_t>("65536", u16));
+    EXPECT_EQ(CONVERT_ERROR_RANGE, try_to_uint<uint16_t>("10", u16, 11, 20));
+    EXPECT_EQ(CONVERT_OK, try_to_uint<uint16_t>("15", u16, 11, 20));
+    EXPECT_EQ(15U, u16);
+    EXPECT_EQ(CONVERT_ERROR_RANGE, try_to_int<int8_t>("-129", i8));
+    EXPECT_EQ(CONVERT_OK, try_to_int<int8_t>("-128", i8));
+    EXPECT_EQ(-128, i8);
+}
+
+template <typename F>
+static string outcome(F convert)
+{
+    try
+    {
+        return to_string(convert());
+    }
+    catch (const out_of_range &)
+    {
+        return "out_of_range";
+    }
+    catch (const invalid_argument &)
+    {
+        return "invalid_argument";
+    }
+}
+
+TEST(CONVERTER, same_as_stoul)
+{
+    vector<string> corpus = {
+        "0", "1", "-1", "+1", "  12", "\n12", "12 ", "0x", "0x1g", "0X7fffffffffffffff",
+        "0x8000000000000000", "0xffffffffffffffff", "0x10000000000000000", "0777", "0778",
+        "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+        "-9223372036854775809", "18446744073709551615", "18446744073709551616",
+        "-18446744073709551615", "99999999999999999999999", "", " ", "+", "-", "+-1", "abc",
+    };
+
+    for (const auto &str : corpus)
+    {
+        /* The checks done by __to_uint64 and __to_int64 before they were rebuilt */
+        string expected = outcome([&str]() {
+            size_t idx = 0;
+            uint64_t ret = stoul(str, &idx, 0);
+            if (str[idx])
+                throw invalid_argument(str);
+            return ret;
+        });
+        EXPECT_EQ(expected, outcome([&str]() { return to_uint<uint64_t>(str); })) << str;
+
+        expected = outcome([&str]() {
+            size_t idx = 0;
+            int64_t ret = stol(str, &idx, 0);
+            if (str[idx])
+                throw invalid_argument(str);
+            return ret;
+        });
+        EXPECT_EQ(expected, outcome([&str]() { return to_int<int64_t>(str); })) << str;
+    }
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "common/flathashmap.h"
+#include "common/ipaddress.h"
+#include "common/ipprefix.h"
+#include "common/macaddress.h"
+
+#include <random>
+#include <unordered_map>
+
+using namespace std;
+using namespace swss;
+
+TEST(FlatHashMap, basic)
+{
+    FlatHashMap<IpAddress, string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(IpAddress("10.0.0.1")), nullptr);
+    EXPECT_FALSE(map.erase(IpAddress("10.0.0.1")));
+
+    EXPECT_TRUE(map.insert(IpAddress("10.0.0.1"), "a"));
+    EXPECT_FALSE(map.insert(IpAddress("10.0.0.1"), "b"));
+    EXPECT_TRUE(map.insert(IpAddress("::ffff:10.0.0.1"), "c"));
+    map[IpAddress("fe80::1")] = "d";
+    EXPECT_EQ(map.size(), 3u);
+
+    ASSERT_NE(map.find(IpAddress("10.0.0.1")), nullptr);
+    EXPECT_EQ(*map.find(IpAddress("10.0.0.1")), "a");
+    EXPECT_EQ(*map.find(IpAddress("::ffff:10.0.0.1")), "c");
+    EXPECT_EQ(map[IpAddress("fe80::1")], "d");
+    EXPECT_TRUE(map.contains(IpAddress("fe80::1")));
+
+    EXPECT_TRUE(map.erase(IpAddress("10.0.0.1")));
+    EXPECT_FALSE(map.contains(IpAddress("10.0.0.1")));
+    EXPECT_TRUE(map.contains(IpAddress("::ffff:10.0.0.1")));
+    EXPECT_EQ(map.size(), 2u);
+
+    size_t count = 0;
+    map.forEach([&](const IpAddress &, string &value) { value += "!"; count++; });
+    EXPECT_EQ(count, 2u);
+    EXPECT_EQ(map[IpAddress("fe80::1")], "d!");
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(IpAddress("fe80::1")));
+}
+
+/* Compare with std::unordered_map over random inserts and erases, with many collisions */
+TEST(FlatHashMap, random)
+{
+    FlatHashMap<uint32_t, uint32_t> map;
+    unordered_map<uint32_t, uint32_t> reference;
+    mt19937 gen(1);
+
+    for (uint32_t i = 0; i < 200000; i++)
+    {
+        uint32_t key = static_cast<uint32_t>(gen() % 5000);
+
+        switch (gen() % 3)
+        {
+            case 0:
+                EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+                break;
+            case 1:
+                EXPECT_EQ(map.insert(key, i), reference.insert(make_pair(key, i)).second);
+                break;
+            default:
+                map[key] = i;
+                reference[key] = i;
+                break;
+        }
+    }
+
+    ASSERT_EQ(map.size(), reference.size());
+    for (const auto &kv : reference)
+    {
+        ASSERT_NE(map.find(kv.first), nullptr);
+        EXPECT_EQ(*map.find(kv.first), kv.second);
+    }
+
+    size_t count = 0;
+    map.forEach([&](const uint32_t &key, uint32_t &value) {
+        count++;
+        EXPECT_EQ(reference[key], value);
+    });
+    EXPECT_EQ(count, reference.size());
+}
+
+TEST(FlatHashSet, keys)
+{
+    FlatHashSet<MacAddress> macs;
+    macs.reserve(1000);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        uint8_t mac[ETHER_ADDR_LEN] = { 0x52, 0x54, 0x00, 0, static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i) };
+        EXPECT_TRUE(macs.insert(MacAddress(mac)));
+    }
+
+    EXPECT_EQ(macs.size(), 1000u);
+    EXPECT_FALSE(macs.insert(MacAddress("52:54:00:00:00:01")));
+    EXPECT_TRUE(macs.contains(MacAddress("52:54:00:00:03:e7")));
+    EXPECT_FALSE(macs.contains(MacAddress("52:54:00:00:03:e8")));
+    EXPECT_TRUE(macs.erase(MacAddress("52:54:00:00:00:01")));
+    EXPECT_EQ(macs.size(), 999u);
+
+    FlatHashSet<IpPrefix> prefixes;
+    EXPECT_TRUE(prefixes.insert(IpPrefix("10.0.0.0/8")));
+    EXPECT_TRUE(prefixes.insert(IpPrefix("10.0.0.0/16")));
+    EXPECT_TRUE(prefixes.insert(IpPrefix("2001:db8::/32")));
+    EXPECT_FALSE(prefixes.insert(IpPrefix("10.0.0.0/8")));
+    EXPECT_TRUE(prefixes.contains(IpPrefix("10.0.0.0/16")));
+    EXPECT_FALSE(prefixes.contains(IpPrefix("10.0.0.0/24")));
+
+    /* Same address key as 10.0.0.0/8, other family */
+    EXPECT_TRUE(prefixes.insert(IpPrefix("::ffff:10.0.0.0/8")));
+    EXPECT_TRUE(prefixes.contains(IpPrefix("::ffff:10.0.0.0/8")));
+    EXPECT_TRUE(prefixes.erase(IpPrefix("10.0.0.0/8")));
+    EXPECT_TRUE(prefixes.contains(IpPrefix("::ffff:10.0.0.0/8")));
+    EXPECT_FALSE(prefixes.contains(IpPrefix("10.0.0.0/8")));
+
+    size_t count = 0;
+    prefixes.forEach([&](const IpPrefix &) { count++; });
+    EXPECT_EQ(count, 3u);
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "common/ipaddresses.h"
 
+#include <arpa/inet.h>
+#include <random>
+
 using namespace std;
 using namespace swss;
 
@@ -97,3 +100,163 @@ TEST(IpAddress, getAddrScope)
     EXPECT_EQ(IpAddress::AddrScope::MCAST_SCOPE,  ip19.getAddrScope());
     EXPECT_EQ(IpAddress::AddrScope::MCAST_SCOPE,  ip20.getAddrScope());
 }
+
+TEST(IpAddress, getKey)
+{
+    uint64_t hi, lo;
+
+    IpAddress("10.1.2.3").getKey(hi, lo);
+    EXPECT_EQ(hi, 0u);
+    EXPECT_EQ(lo, 0xFFFF0A010203ULL);
+
+    IpAddress("2001:db8::1:2").getKey(hi, lo);
+    EXPECT_EQ(hi, 0x20010DB800000000ULL);
+    EXPECT_EQ(lo, 0x0000000000010002ULL);
+
+    /* Same key, told apart by the hash and by comparison */
+    IpAddress v4("10.1.2.3");
+    IpAddress mapped("::ffff:10.1.2.3");
+    EXPECT_NE(v4, mapped);
+    EXPECT_NE(hash<IpAddress>()(v4), hash<IpAddress>()(mapped));
+
+    EXPECT_EQ(hash<IpAddress>()(IpAddress("fe80::1")), hash<IpAddress>()(IpAddress("fe80::1")));
+}
+
+/* Compare IpAddress::parse with inet_pton, as used before */
+static void checkParse(const string &str)
+{
+    int family = str.find(':') != string::npos ? AF_INET6 : AF_INET;
+    unsigned char expected[16] = { 0 };
+    bool valid = inet_pton(family, str.c_str(), expected) == 1;
+
+    IpAddress ip;
+    ASSERT_EQ(IpAddress::parse(str.data(), str.size(), ip), valid) << "\"" << str << "\"";
+    if (!valid)
+        return;
+
+    ip_addr_t addr = ip.getIp();
+    ASSERT_EQ(addr.family, family);
+    EXPECT_EQ(memcmp(&addr.ip_addr, expected, family == AF_INET ? 4 : 16), 0) << str;
+}
+
+/* Compare IpAddress::to_string with inet_ntop */
+static void checkFormat(const ip_addr_t &addr)
+{
+    char expected[INET6_ADDRSTRLEN];
+    ASSERT_NE(inet_ntop(addr.family, &addr.ip_addr, expected, sizeof(expected)), nullptr);
+
+    IpAddress ip(addr);
+    char buf[IpAddress::MAX_STRING_SIZE];
+    size_t len = ip.to_string(buf, sizeof(buf));
+    EXPECT_EQ(len, strlen(expected));
+    EXPECT_STREQ(buf, expected);
+}
+
+TEST(IpAddress, parseEquivalence)
+{
+    /* Every string of up to 4 characters from a small alphabet */
+    const string alphabet = "019aF:.x";
+    vector<string> strings(1, "");
+    for (size_t len = 1; len <= 4; len++)
+    {
+        vector<string> longer;
+        for (const auto &prefix : strings)
+        {
+            if (prefix.size() != len - 1)
+                continue;
+            for (char c : alphabet)
+                longer.push_back(prefix + c);
+        }
+        strings.insert(strings.end(), longer.begin(), longer.end());
+    }
+
+    for (const auto &str : strings)
+        checkParse(str);
+
+    /* Edge cases of both families */
+    const char *edges[] = {
+        "0.0.0.0", "255.255.255.255", "256.0.0.1", "1.2.3", "1.2.3.4.", ".1.2.3.4", "01.2.3.4",
+        "1.2.3.04", "1..2.3", "1.2.3.4 ", " 1.2.3.4", "1.2.3.-4", "4294967295",
+        "::", ":::", "::1", "1::", "1:::2", ":1::2", "1::2:", "1:2:3:4:5:6:7:8", "1:2:3:4:5:6:7:8:9",
+        "1:2:3:4:5:6:7::", "::2:3:4:5:6:7:8", "1:2:3:4:5:6:7:8::", "12345::", "fFfF::", "g::",
+        "::ffff:1.2.3.4", "::1.2.3.4", "1:2:3:4:5:6:1.2.3.4", "1:2:3:4:5:6:7:1.2.3.4",
+        "::1.2.3.4:5", "::1.2.3", "::256.1.2.3", "1.2.3.4::", "fe80::1%eth0", "[::1]",
+    };
+    for (const char *edge : edges)
+        checkParse(edge);
+
+    /* Random edits of valid addresses */
+    mt19937 gen(1);
+    const string chars = "0123456789abcdefABCDEF:.g ";
+    for (int i = 0; i < 200000; i++)
+    {
+        ip_addr_t addr;
+        addr.family = gen() % 2 ? AF_INET : AF_INET6;
+        for (auto &b : addr.ip_addr.ipv6_addr)
+            b = gen() % 3 ? 0 : static_cast<unsigned char>(gen());
+
+        string str = IpAddress(addr).to_string();
+        for (unsigned int edits = static_cast<unsigned int>(gen() % 3); edits > 0 && !str.empty(); edits--)
+        {
+            size_t pos = gen() % str.size();
+            switch (gen() % 3)
+            {
+                case 0: str.erase(pos, 1); break;
+                case 1: str.insert(pos, 1, chars[gen() % chars.size()]); break;
+                default: str[pos] = chars[gen() % chars.size()]; break;
+            }
+        }
+
+        checkParse(str);
+    }
+}
+
+TEST(IpAddress, formatEquivalence)
+{
+    ip_addr_t addr;
+
+    /* IPv4, every value of each octet and a stride over the whole space */
+    addr.family = AF_INET;
+    for (uint64_t v = 0; v <= 0xFFFFFFFFULL; v += 65521)
+    {
+        addr.ip_addr.ipv4_addr = static_cast<uint32_t>(v);
+        checkFormat(addr);
+    }
+    for (uint32_t v = 0; v < 256; v++)
+    {
+        addr.ip_addr.ipv4_addr = v * 0x01010101U;
+        checkFormat(addr);
+    }
+
+    /* IPv6, every pattern of zero and non zero words with varying digits */
+    addr.family = AF_INET6;
+    const uint16_t values[] = { 0x1, 0xa, 0x10, 0xff, 0x100, 0xfff, 0x1000, 0xffff };
+    for (uint32_t pattern = 0; pattern < 256; pattern++)
+    {
+        for (int v = 0; v < 8; v++)
+        {
+            for (int w = 0; w < 8; w++)
+            {
+                uint16_t word = (pattern & (1u << w)) ? values[(v + w) % 8] : 0;
+                addr.ip_addr.ipv6_addr[2 * w] = static_cast<unsigned char>(word >> 8);
+                addr.ip_addr.ipv6_addr[2 * w + 1] = static_cast<unsigned char>(word);
+            }
+            checkFormat(addr);
+        }
+    }
+
+    /* IPv4-mapped and compatible forms */
+    const char *special[] = { "::ffff:1.2.3.4", "::1.2.3.4", "::ffff:0.0.0.0", "::0.0.1.0", "::ffff:0:0", "0:0:0:0:0:fffe:1.2.3.4" };
+    for (const char *str : special)
+    {
+        addr = IpAddress(str).getIp();
+        checkFormat(addr);
+    }
+
+    /* Too small buffers */
+    char buf[IpAddress::MAX_STRING_SIZE];
+    IpAddress ip("10.1.2.3");
+    EXPECT_EQ(ip.to_string(buf, 8), 0u);
+    EXPECT_EQ(ip.to_string(buf, 9), 8u);
+    EXPECT_STREQ(buf, "10.1.2.3");
+}
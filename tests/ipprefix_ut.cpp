@@ -174,4 +174,65 @@ TEST(IpPrefix, maskLen)
     EXPECT_EQ(0, prefix4.getMaskLength());
     EXPECT_EQ(64, prefix5.getMaskLength());
     EXPECT_EQ(128, prefix6.getMaskLength());
-}
\ No newline at end of file
+}
+
+TEST(IpPrefix, getKey)
+{
+    uint64_t hi, lo;
+    uint8_t len;
+
+    IpPrefix("10.1.2.0/24").getKey(hi, lo, len);
+    EXPECT_EQ(hi, 0u);
+    EXPECT_EQ(lo, 0xFFFF0A010200ULL);
+    EXPECT_EQ(len, 24u);
+
+    IpPrefix("2001:db8::/32").getKey(hi, lo, len);
+    EXPECT_EQ(hi, 0x20010DB800000000ULL);
+    EXPECT_EQ(lo, 0u);
+    EXPECT_EQ(len, 32u);
+
+    IpPrefix("::/0").getKey(hi, lo, len);
+    EXPECT_EQ(hi, 0u);
+    EXPECT_EQ(lo, 0u);
+    EXPECT_EQ(len, 0u);
+}
+
+TEST(IpPrefix, hash)
+{
+    EXPECT_EQ(hash<IpPrefix>()(IpPrefix("10.0.0.0/8")), hash<IpPrefix>()(IpPrefix("10.0.0.0/8")));
+    EXPECT_NE(hash<IpPrefix>()(IpPrefix("10.0.0.0/8")), hash<IpPrefix>()(IpPrefix("10.0.0.0/16")));
+    EXPECT_NE(hash<IpPrefix>()(IpPrefix("10.0.0.0/8")), hash<IpPrefix>()(IpPrefix("11.0.0.0/8")));
+    EXPECT_NE(hash<IpPrefix>()(IpPrefix("10.0.0.0/8")), hash<IpPrefix>()(IpPrefix("::ffff:10.0.0.0/8")));
+}
+
+TEST(IpPrefix, parse)
+{
+    const char *valid[] = { "10.0.0.0/8", "10.1.2.3", "/24", "", "::/0", "2001:db8::/32", "fe80::1",
+                            "10.0.0.0/ 8", "10.0.0.0/+8", "10.0.0.0/8abc", "10.0.0.0/-0", "::/128" };
+    for (const char *str : valid)
+    {
+        IpPrefix parsed;
+        EXPECT_TRUE(IpPrefix::parse(str, strlen(str), parsed)) << str;
+        EXPECT_EQ(parsed, IpPrefix(str));
+
+        char buf[IpPrefix::MAX_STRING_SIZE];
+        EXPECT_EQ(parsed.to_string(buf, sizeof(buf)), parsed.to_string().size());
+        EXPECT_EQ(string(buf), IpPrefix(str).getIp().to_string() + "/" + std::to_string(IpPrefix(str).getMaskLength()));
+    }
+
+    const char *invalid[] = { "10.0.0.0/33", "10.0.0.0/", "10.0.0.0/x", "10.0.0.0/-1", "::/129",
+                              "10.0.0/8", "1::2::3/64", "10.0.0.0/99999999999" };
+    for (const char *str : invalid)
+    {
+        IpPrefix parsed("1.1.1.1/32");
+        EXPECT_FALSE(IpPrefix::parse(str, strlen(str), parsed)) << str;
+        EXPECT_EQ(parsed, IpPrefix("1.1.1.1/32"));
+        EXPECT_THROW(IpPrefix p(str), invalid_argument) << str;
+    }
+
+    char buf[IpPrefix::MAX_STRING_SIZE];
+    EXPECT_EQ(IpPrefix("10.0.0.0/8").to_string(buf, 10), 0u);
+    EXPECT_EQ(IpPrefix("10.0.0.0/8").to_string(buf, 11), 10u);
+    EXPECT_EQ(IpPrefix("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255/128").to_string(buf, sizeof(buf)),
+              string("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff/128").size());
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "common/ipprefixbatch.h"
+
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+static IpAddress randomAddress(mt19937 &gen, bool v4)
+{
+    ip_addr_t ip;
+    ip.family = v4 ? AF_INET : AF_INET6;
+    for (auto &b : ip.ip_addr.ipv6_addr)
+        b = static_cast<unsigned char>(gen());
+
+    /* Share the high bits with 10.0.0.0/8 and 2001:db8::/32 half of the time */
+    if (gen() % 2)
+    {
+        ip.ip_addr.ipv6_addr[0] = v4 ? 10 : 0x20;
+        ip.ip_addr.ipv6_addr[1] = v4 ? ip.ip_addr.ipv6_addr[1] : 0x01;
+        ip.ip_addr.ipv6_addr[2] = v4 ? static_cast<unsigned char>(gen() % 2) : 0x0d;
+        ip.ip_addr.ipv6_addr[3] = v4 ? ip.ip_addr.ipv6_addr[3] : 0xb8;
+    }
+
+    return IpAddress(ip);
+}
+
+TEST(IpPrefixMatcher, match)
+{
+    mt19937 gen(1);
+    const char *prefixes[] = { "10.0.0.0/8", "10.1.0.0/16", "10.0.0.7/32", "0.0.0.0/0",
+                               "2001:db8::/32", "2001:db8::/127", "::/0", "2001:db8:1::1/128" };
+
+    for (const char *str : prefixes)
+    {
+        IpPrefix prefix(str);
+        IpPrefixMatcher matcher(prefix);
+        EXPECT_EQ(matcher.isV4(), prefix.isV4());
+
+        /* Sizes around the 16 address vector blocks */
+        for (size_t count : { 0, 1, 15, 16, 17, 33, 1000 })
+        {
+            vector<IpAddress> addresses;
+            vector<uint32_t> v4;
+            vector<PackedIpV6> v6;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                addresses.push_back(randomAddress(gen, prefix.isV4()));
+                v4.push_back(addresses.back().getV4Addr());
+                v6.push_back(PackedIpV6::pack(addresses.back()));
+            }
+
+            vector<uint8_t> result(count + 1, 0xAA);
+            size_t matched = prefix.isV4() ? matcher.match(v4.data(), count, result.data())
+                                           : matcher.match(v6.data(), count, result.data());
+
+            size_t expected = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                bool in = prefix.isAddressInSubnet(addresses[i]);
+                expected += in;
+                EXPECT_EQ(result[i], in ? 1 : 0) << str << " " << addresses[i].to_string();
+            }
+            EXPECT_EQ(matched, expected);
+            EXPECT_EQ(result[count], 0xAA);
+
+            /* Addresses of the other family never match */
+            size_t other = prefix.isV4() ? matcher.match(v6.data(), count, result.data())
+                                         : matcher.match(v4.data(), count, result.data());
+            EXPECT_EQ(other, 0u);
+            for (size_t i = 0; i < count; i++)
+                EXPECT_EQ(result[i], 0);
+        }
+    }
+}
+
+TEST(PackedPrefixes, findContaining)
+{
+    mt19937 gen(2);
+
+    for (bool v4 : { true, false })
+    {
+        PackedPrefixes packed(v4);
+        vector<IpPrefix> prefixes;
+
+        for (int i = 0; i < 100; i++)
+        {
+            int len = static_cast<int>(gen() % (v4 ? 33 : 129));
+            prefixes.push_back(IpPrefix(randomAddress(gen, v4).getIp(), len));
+            packed.add(prefixes.back());
+        }
+        EXPECT_EQ(packed.size(), prefixes.size());
+        EXPECT_THROW(packed.add(IpPrefix(v4 ? "::/0" : "0.0.0.0/0")), invalid_argument);
+
+        vector<uint8_t> result(prefixes.size());
+        for (int i = 0; i < 1000; i++)
+        {
+            IpAddress addr = randomAddress(gen, v4);
+            size_t matched = packed.findContaining(addr, result.data());
+
+            size_t expected = 0;
+            for (size_t j = 0; j < prefixes.size(); j++)
+            {
+                bool in = prefixes[j].isAddressInSubnet(addr);
+                expected += in;
+                EXPECT_EQ(result[j], in ? 1 : 0);
+            }
+            EXPECT_EQ(matched, expected);
+        }
+
+        EXPECT_EQ(packed.findContaining(IpAddress(v4 ? "::1" : "1.1.1.1"), result.data()), 0u);
+
+        packed.clear();
+        EXPECT_EQ(packed.size(), 0u);
+    }
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "common/ipprefixtrie.h"
+
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+static vector<string> covering(const IpPrefixTrie<int> &trie, const string &prefix)
+{
+    vector<string> result;
+    trie.forEachCovering(IpPrefix(prefix), [&](const IpPrefix &p, const int &) {
+        result.push_back(p.to_string());
+    });
+    return result;
+}
+
+static vector<string> covered(const IpPrefixTrie<int> &trie, const string &prefix)
+{
+    vector<string> result;
+    trie.forEachCovered(IpPrefix(prefix), [&](const IpPrefix &p, const int &) {
+        result.push_back(p.to_string());
+    });
+    return result;
+}
+
+TEST(IpPrefixTrie, ipv4)
+{
+    IpPrefixTrie<int> trie;
+    EXPECT_TRUE(trie.empty());
+
+    EXPECT_TRUE(trie.insert(IpPrefix("0.0.0.0/0"), 0));
+    EXPECT_TRUE(trie.insert(IpPrefix("10.0.0.0/8"), 8));
+    EXPECT_TRUE(trie.insert(IpPrefix("10.1.0.0/16"), 16));
+    EXPECT_TRUE(trie.insert(IpPrefix("10.1.2.3/24"), 24));
+    EXPECT_TRUE(trie.insert(IpPrefix("10.1.3.0/24"), 25));
+    EXPECT_TRUE(trie.insert(IpPrefix("10.1.2.1/32"), 32));
+    EXPECT_EQ(trie.size(), 6u);
+
+    /* Host bits are ignored */
+    EXPECT_FALSE(trie.insert(IpPrefix("10.1.2.0/24"), 124));
+    EXPECT_EQ(trie.size(), 6u);
+    ASSERT_NE(trie.find(IpPrefix("10.1.2.0/24")), nullptr);
+    EXPECT_EQ(*trie.find(IpPrefix("10.1.2.0/24")), 124);
+    EXPECT_EQ(trie.find(IpPrefix("10.1.0.0/17")), nullptr);
+
+    IpPrefix matched;
+    ASSERT_NE(trie.longestMatch(IpAddress("10.1.2.1"), &matched), nullptr);
+    EXPECT_EQ(matched.to_string(), "10.1.2.1/32");
+    EXPECT_EQ(*trie.longestMatch(IpAddress("10.1.2.2"), &matched), 124);
+    EXPECT_EQ(matched.to_string(), "10.1.2.0/24");
+    EXPECT_EQ(*trie.longestMatch(IpAddress("10.1.4.1")), 16);
+    EXPECT_EQ(*trie.longestMatch(IpAddress("10.2.0.1")), 8);
+    EXPECT_EQ(*trie.longestMatch(IpAddress("11.0.0.1")), 0);
+    EXPECT_EQ(trie.longestMatch(IpAddress("::1")), nullptr);
+
+    EXPECT_EQ(covering(trie, "10.1.2.128/25"),
+              vector<string>({ "0.0.0.0/0", "10.0.0.0/8", "10.1.0.0/16", "10.1.2.0/24" }));
+    EXPECT_EQ(covered(trie, "10.1.0.0/16"),
+              vector<string>({ "10.1.0.0/16", "10.1.2.0/24", "10.1.2.1/32", "10.1.3.0/24" }));
+    EXPECT_EQ(covered(trie, "10.1.2.0/23"),
+              vector<string>({ "10.1.2.0/24", "10.1.2.1/32", "10.1.3.0/24" }));
+    EXPECT_TRUE(covered(trie, "192.168.0.0/16").empty());
+
+    /* Removing a prefix keeps the more specific ones */
+    EXPECT_TRUE(trie.erase(IpPrefix("10.1.0.0/16")));
+    EXPECT_FALSE(trie.erase(IpPrefix("10.1.0.0/16")));
+    EXPECT_EQ(*trie.longestMatch(IpAddress("10.1.4.1")), 8);
+    EXPECT_EQ(*trie.longestMatch(IpAddress("10.1.3.1")), 25);
+
+    EXPECT_TRUE(trie.erase(IpPrefix("10.1.2.1/32")));
+    EXPECT_TRUE(trie.erase(IpPrefix("10.1.2.0/24")));
+    EXPECT_EQ(*trie.longestMatch(IpAddress("10.1.2.1")), 8);
+    EXPECT_EQ(trie.size(), 3u);
+
+    trie.clear();
+    EXPECT_TRUE(trie.empty());
+    EXPECT_EQ(trie.longestMatch(IpAddress("10.1.2.1")), nullptr);
+}
+
+TEST(IpPrefixTrie, ipv6)
+{
+    IpPrefixTrie<string> trie;
+
+    trie.insert(IpPrefix("::/0"), "default");
+    trie.insert(IpPrefix("2001:db8::/32"), "doc");
+    trie.insert(IpPrefix("2001:db8:0:1::/64"), "subnet");
+    trie.insert(IpPrefix("2001:db8:0:1::1/128"), "host");
+    trie.insert(IpPrefix("10.0.0.0/8"), "v4");
+
+    IpPrefix matched;
+    EXPECT_EQ(*trie.longestMatch(IpAddress("2001:db8:0:1::1"), &matched), "host");
+    EXPECT_EQ(matched.to_string(), "2001:db8:0:1::1/128");
+    EXPECT_EQ(*trie.longestMatch(IpAddress("2001:db8:0:1::2"), &matched), "subnet");
+    EXPECT_EQ(matched.to_string(), "2001:db8:0:1::/64");
+    EXPECT_EQ(*trie.longestMatch(IpAddress("2001:db8:ffff::1")), "doc");
+    EXPECT_EQ(*trie.longestMatch(IpAddress("fe80::1")), "default");
+    EXPECT_EQ(*trie.longestMatch(IpAddress("10.0.0.1")), "v4");
+
+    vector<string> all;
+    trie.forEach([&](const IpPrefix &p, const string &) { all.push_back(p.to_string()); });
+    EXPECT_EQ(all, vector<string>({ "10.0.0.0/8", "::/0", "2001:db8::/32",
+                                    "2001:db8:0:1::/64", "2001:db8:0:1::1/128" }));
+}
+
+/* Compare with a std::map scan over random prefixes, inserts and erases */
+TEST(IpPrefixTrie, random)
+{
+    IpPrefixTrie<int> trie;
+    map<IpPrefix, int> reference;
+    mt19937 gen(1);
+
+    for (int i = 0; i < 4000; i++)
+    {
+        /* Few distinct high bits so prefixes nest */
+        uint32_t addr = (gen() & 0x0f0f0000) | (gen() & 0xff);
+        int len = static_cast<int>(gen() % 33);
+        IpPrefix prefix = IpPrefix(htonl(addr), len).getSubnet();
+
+        if (gen() % 4 == 0)
+        {
+            EXPECT_EQ(trie.erase(prefix), reference.erase(prefix) == 1);
+        }
+        else
+        {
+            EXPECT_EQ(trie.insert(prefix, i), reference.count(prefix) == 0);
+            reference[prefix] = i;
+        }
+    }
+
+    EXPECT_EQ(trie.size(), reference.size());
+
+    for (int i = 0; i < 2000; i++)
+    {
+        IpAddress addr(htonl((gen() & 0x0f0f0000) | (gen() & 0xff)));
+
+        const int *expected = nullptr;
+        int bestLen = -1;
+        for (const auto &kv : reference)
+        {
+            if (kv.first.getMaskLength() > bestLen && kv.first.isAddressInSubnet(addr))
+            {
+                expected = &kv.second;
+                bestLen = kv.first.getMaskLength();
+            }
+        }
+
+        const int *found = trie.longestMatch(addr);
+        if (expected == nullptr)
+        {
+            EXPECT_EQ(found, nullptr);
+        }
+        else
+        {
+            ASSERT_NE(found, nullptr);
+            EXPECT_EQ(*found, *expected);
+        }
+    }
+
+    size_t visited = 0;
+    trie.forEach([&](const IpPrefix &p, const int &value) {
+        visited++;
+        ASSERT_EQ(reference.count(p), 1u);
+        EXPECT_EQ(reference[p], value);
+    });
+    EXPECT_EQ(visited, reference.size());
+}
@@ -0,0 +1,178 @@
+#include "common/linkcache.h"
+
+#include "gtest/gtest.h"
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <netlink/route/link.h>
+#include <linux/rtnetlink.h>
+
+using namespace std;
+using namespace swss;
+
+static struct nl_msg *buildLinkMsg(int nlmsg_type, int ifindex, const char *name)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(nlmsg_type, 0);
+
+    struct ifinfomsg ifi = {};
+    ifi.ifi_family = AF_UNSPEC;
+    ifi.ifi_index = ifindex;
+    nlmsg_append(msg, &ifi, sizeof(ifi), NLMSG_ALIGNTO);
+    if (name != nullptr)
+        nla_put_string(msg, IFLA_IFNAME, name);
+
+    return msg;
+}
+
+static void sendLinkMsg(LinkCache &cache, int nlmsg_type, int ifindex, const char *name)
+{
+    struct nl_msg *msg = buildLinkMsg(nlmsg_type, ifindex, name);
+    cache.onMsg(nlmsg_type, nlmsg_hdr(msg));
+    nlmsg_free(msg);
+}
+
+TEST(LinkCache, loopback)
+{
+    auto &cache = LinkCache::getInstance();
+
+    EXPECT_EQ(cache.ifindexToName(1), "lo");
+    EXPECT_GE(cache.getRefillCount(), 1u);
+
+    struct rtnl_link *link = cache.getLinkByName("lo");
+    ASSERT_NE(link, nullptr);
+    EXPECT_EQ(rtnl_link_get_ifindex(link), 1);
+    rtnl_link_put(link);
+
+    EXPECT_EQ(cache.getLinkByName("UtNoSuchLink"), nullptr);
+}
+
+TEST(LinkCache, events)
+{
+    auto &cache = LinkCache::getInstance();
+    const int denseIndex = 4000;
+    const int sparseIndex = LinkCache::LINK_TABLE_SIZE + 4000;
+
+    sendLinkMsg(cache, RTM_NEWLINK, denseIndex, "Ethernet4000");
+    sendLinkMsg(cache, RTM_NEWLINK, sparseIndex, "Vlan4000");
+
+    uint64_t refills = cache.getRefillCount();
+    uint64_t lookups = cache.getKernelLookupCount();
+    EXPECT_EQ(cache.ifindexToName(denseIndex), "Ethernet4000");
+    EXPECT_EQ(cache.ifindexToName(sparseIndex), "Vlan4000");
+    EXPECT_EQ(cache.getKernelLookupCount(), lookups);
+
+    /* Messages without name do not change the entry */
+    sendLinkMsg(cache, RTM_NEWLINK, denseIndex, nullptr);
+    EXPECT_EQ(cache.ifindexToName(denseIndex), "Ethernet4000");
+
+    sendLinkMsg(cache, RTM_NEWLINK, denseIndex, "Ethernet4000.10");
+    EXPECT_EQ(cache.ifindexToName(denseIndex), "Ethernet4000.10");
+
+    /* Known by the events, no kernel query */
+    struct rtnl_link *link = cache.getLinkByName("Ethernet4000.10");
+    ASSERT_NE(link, nullptr);
+    EXPECT_EQ(rtnl_link_get_ifindex(link), denseIndex);
+    rtnl_link_put(link);
+    EXPECT_EQ(cache.getKernelLookupCount(), lookups);
+
+    /* Unknown links are returned as numbers without asking the kernel */
+    cache.setKernelLookup(false);
+    sendLinkMsg(cache, RTM_DELLINK, denseIndex, nullptr);
+    sendLinkMsg(cache, RTM_DELLINK, sparseIndex, nullptr);
+    EXPECT_EQ(cache.ifindexToName(denseIndex), to_string(denseIndex));
+    EXPECT_EQ(cache.ifindexToName(sparseIndex), to_string(sparseIndex));
+    EXPECT_EQ(cache.getLinkByName("Ethernet4000"), nullptr);
+    EXPECT_EQ(cache.getLinkByName("Vlan4000"), nullptr);
+    EXPECT_EQ(cache.getKernelLookupCount(), lookups);
+    EXPECT_EQ(cache.getRefillCount(), refills);
+    cache.setKernelLookup(true);
+}
+
+TEST(LinkCache, kernelLookup)
+{
+    auto &cache = LinkCache::getInstance();
+
+    /* A link created after the dump, before its RTM_NEWLINK is seen */
+    cache.removeLink(1);
+    uint64_t lookups = cache.getKernelLookupCount();
+
+    cache.setKernelLookup(false);
+    EXPECT_EQ(cache.ifindexToName(1), "1");
+    EXPECT_EQ(cache.getLinkByName("lo"), nullptr);
+    EXPECT_EQ(cache.getKernelLookupCount(), lookups);
+    cache.setKernelLookup(true);
+
+    struct rtnl_link *link = cache.getLinkByName("lo");
+    ASSERT_NE(link, nullptr);
+    EXPECT_EQ(rtnl_link_get_ifindex(link), 1);
+    rtnl_link_put(link);
+    EXPECT_EQ(cache.getKernelLookupCount(), lookups + 1);
+
+    /* Kept by the kernel lookup */
+    EXPECT_EQ(cache.ifindexToName(1), "lo");
+    link = cache.getLinkByName("lo");
+    ASSERT_NE(link, nullptr);
+    rtnl_link_put(link);
+    EXPECT_EQ(cache.getKernelLookupCount(), lookups + 1);
+}
+
+TEST(LinkCache, createdAfterConstruction)
+{
+    auto &cache = LinkCache::getInstance();
+    const char *name = "UtLinkCache0";
+
+    /* No handler is registered, the cache never sees the RTM_NEWLINK */
+    struct nl_sock *sock = nl_socket_alloc();
+    ASSERT_NE(sock, nullptr);
+    ASSERT_EQ(nl_connect(sock, NETLINK_ROUTE), 0);
+
+    struct rtnl_link *bridge = rtnl_link_alloc();
+    rtnl_link_set_type(bridge, "bridge");
+    rtnl_link_set_name(bridge, name);
+    int err = rtnl_link_add(sock, bridge, NLM_F_CREATE | NLM_F_EXCL);
+    rtnl_link_put(bridge);
+    if (err == -NLE_PERM || err == -NLE_OPNOTSUPP)
+    {
+        nl_socket_free(sock);
+        GTEST_SKIP() << "Unable to create a bridge: " << nl_geterror(err);
+    }
+    ASSERT_EQ(err, 0);
+
+    struct rtnl_link *created = NULL;
+    ASSERT_EQ(rtnl_link_get_kernel(sock, 0, name, &created), 0);
+    int ifindex = rtnl_link_get_ifindex(created);
+
+    uint64_t lookups = cache.getKernelLookupCount();
+    struct rtnl_link *link = cache.getLinkByName(name);
+    ASSERT_NE(link, nullptr);
+    EXPECT_EQ(rtnl_link_get_ifindex(link), ifindex);
+    rtnl_link_put(link);
+    EXPECT_EQ(cache.ifindexToName(ifindex), name);
+    EXPECT_EQ(cache.getKernelLookupCount(), lookups + 1);
+
+    rtnl_link_delete(sock, created);
+    rtnl_link_put(created);
+    nl_socket_free(sock);
+
+    cache.removeLink(ifindex);
+    EXPECT_EQ(cache.getLinkByName(name), nullptr);
+}
+
+TEST(LinkCache, resync)
+{
+    auto &cache = LinkCache::getInstance();
+
+    cache.updateLink(4001, "Ethernet4001");
+    cache.updateLink(4002, "Ethernet4002");
+
+    cache.onResyncBegin();
+    sendLinkMsg(cache, RTM_NEWLINK, 4002, "Ethernet4002");
+    cache.onResyncEnd();
+
+    EXPECT_EQ(cache.ifindexToName(4002), "Ethernet4002");
+    EXPECT_EQ(cache.ifindexToName(4001), "4001");
+
+    cache.refill();
+    EXPECT_EQ(cache.ifindexToName(1), "lo");
+    EXPECT_EQ(cache.ifindexToName(4002), "4002");
+}
@@ -3,8 +3,15 @@
 #include "common/consumerstatetable.h"
 #include "common/select.h"
 #include "common/schema.h"
+#include "common/logformat.h"
+#include "common/logsettingwatcher.h"
 #include "gtest/gtest.h"
+#include <errno.h>
 #include <unistd.h>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 using namespace std;
 using namespace swss;
@@ -69,3 +76,349 @@ TEST(LOGGER, loglevel)
 
     cout << "Done." << endl;
 }
+
+static mutex watchedMutex;
+static condition_variable watchedChanged;
+static string watchedPrio;
+
+static void watchedPrioNotify(const string &component, const string &prioStr)
+{
+    lock_guard<mutex> lock(watchedMutex);
+    watchedPrio = prioStr;
+    watchedChanged.notify_all();
+}
+
+static bool waitWatchedPrio(const string &prio)
+{
+    unique_lock<mutex> lock(watchedMutex);
+    return watchedChanged.wait_for(lock, chrono::seconds(1), [&prio]() { return watchedPrio == prio; });
+}
+
+static string getWatchedPrio()
+{
+    lock_guard<mutex> lock(watchedMutex);
+    return watchedPrio;
+}
+
+TEST(LOGGER, settingWatcher)
+{
+    DBConnector db("LOGLEVEL_DB", 0);
+    clearLoglevelDB();
+
+    string key = "watched";
+    Logger::linkToDb(key, watchedPrioNotify, "NOTICE");
+    EXPECT_TRUE(waitWatchedPrio("NOTICE"));
+
+    /* Watched in the Select of the application */
+    LogSettingWatcher watcher;
+    Select select;
+    select.addSelectable(&watcher);
+
+    for (const string prio : { "DEBUG", "INFO", "ERROR" })
+    {
+        auto deadline = chrono::steady_clock::now() + chrono::milliseconds(500);
+        setLoglevel(db, key, prio);
+
+        /* Applied when Select reads the notification, which is not returned */
+        while (getWatchedPrio() != prio && chrono::steady_clock::now() < deadline)
+        {
+            Selectable *selectable = nullptr;
+            int ret = select.select(&selectable, 10);
+            EXPECT_EQ(ret, Select::TIMEOUT);
+            EXPECT_EQ(selectable, nullptr);
+        }
+
+        EXPECT_EQ(getWatchedPrio(), prio);
+    }
+
+    select.removeSelectable(&watcher);
+}
+
+TEST(LOGGER, settingThread)
+{
+    DBConnector db("LOGLEVEL_DB", 0);
+    auto prio = Logger::getMinPrio();
+
+    string key = "native";
+    Logger::linkToDbNative(key);
+
+    for (const string level : { "DEBUG", "ERROR", "NOTICE" })
+    {
+        setLoglevel(db, key, level);
+
+        /* The setting thread does not wait for a timeout */
+        auto expected = Logger::priorityStringMap.at(level);
+        auto deadline = chrono::steady_clock::now() + chrono::milliseconds(500);
+        while (Logger::getMinPrio() != expected && chrono::steady_clock::now() < deadline)
+            this_thread::sleep_for(chrono::microseconds(100));
+
+        EXPECT_EQ(Logger::getMinPrio(), expected);
+    }
+
+    Logger::setMinPrio(prio);
+}
+
+static size_t countLines(const string &text)
+{
+    size_t lines = 0;
+    for (char c : text)
+        lines += c == '\n';
+
+    return lines;
+}
+
+TEST(LOGGER, async)
+{
+    const int threads = 4, messages = 1000;
+    uint64_t dropped = Logger::getDroppedCount();
+
+    /* No DEBUG messages of other threads left from LOGGER.loglevel */
+    auto prio = Logger::getMinPrio();
+    Logger::setMinPrio(Logger::SWSS_NOTICE);
+
+    Logger::setOutput(Logger::SWSS_STDERR);
+    Logger::enableAsync(Logger::SWSS_LOG_BLOCK, 8);
+    EXPECT_TRUE(Logger::isAsync());
+
+    testing::internal::CaptureStderr();
+
+    vector<thread> writers;
+    for (int t = 0; t < threads; t++)
+    {
+        writers.emplace_back([t]() {
+            for (int i = 0; i < messages; i++)
+                SWSS_LOG_NOTICE("thread %d message %d", t, i);
+        });
+    }
+
+    for (auto &writer : writers)
+        writer.join();
+
+    Logger::flush();
+    string out = testing::internal::GetCapturedStderr();
+
+    Logger::disableAsync();
+    Logger::setOutput(Logger::SWSS_SYSLOG);
+    Logger::setMinPrio(prio);
+    EXPECT_FALSE(Logger::isAsync());
+
+    /* Nothing dropped, and messages of each thread in order */
+    EXPECT_EQ(Logger::getDroppedCount(), dropped);
+    EXPECT_EQ(countLines(out), static_cast<size_t>(threads * messages));
+
+    vector<int> next(threads, 0);
+    istringstream lines(out);
+    string line;
+    while (getline(lines, line))
+    {
+        int t, i;
+        size_t pos = line.find("thread ");
+        ASSERT_NE(pos, string::npos) << line;
+        ASSERT_EQ(sscanf(line.c_str() + pos, "thread %d message %d", &t, &i), 2) << line;
+        EXPECT_EQ(line.compare(0, pos, "NOTICE:- operator(): "), 0) << line;
+        EXPECT_EQ(i, next[t]++);
+    }
+}
+
+TEST(LOGGER, asyncDrop)
+{
+    const int messages = 1000;
+    uint64_t dropped = Logger::getDroppedCount();
+
+    auto prio = Logger::getMinPrio();
+    Logger::setMinPrio(Logger::SWSS_NOTICE);
+
+    Logger::setOutput(Logger::SWSS_STDERR);
+    Logger::enableAsync(Logger::SWSS_LOG_DROP, 4);
+
+    testing::internal::CaptureStderr();
+
+    thread writer([]() {
+        for (int i = 0; i < messages; i++)
+            SWSS_LOG_NOTICE("message %d", i);
+    });
+    writer.join();
+
+    Logger::disableAsync();
+    string out = testing::internal::GetCapturedStderr();
+    Logger::setOutput(Logger::SWSS_SYSLOG);
+    Logger::setMinPrio(prio);
+
+    /* Every message is either written or counted as dropped */
+    EXPECT_EQ(countLines(out) + (Logger::getDroppedCount() - dropped), static_cast<size_t>(messages));
+}
+
+TEST(LOGGER, asyncFlushOnAbort)
+{
+    EXPECT_DEATH({
+        Logger::setOutput(Logger::SWSS_STDERR);
+        Logger::enableAsync();
+        SWSS_LOG_NOTICE("pending message");
+        ABORT_IF_NOT(false, "fatal %d", 1);
+    }, "pending message\n.*Aborting: .*fatal 1");
+}
+
+/* Levels below INFO compiled out for the SWSS_LOG_* uses in this test only */
+#pragma push_macro("SWSS_LOG_COMPILE_MIN_PRIO")
+#undef SWSS_LOG_COMPILE_MIN_PRIO
+#define SWSS_LOG_COMPILE_MIN_PRIO swss::Logger::SWSS_INFO
+
+TEST(LOGGER, compileMinPrio)
+{
+    auto prio = Logger::getMinPrio();
+    Logger::setMinPrio(Logger::SWSS_DEBUG);
+    Logger::setOutput(Logger::SWSS_STDERR);
+
+    int evaluated = 0;
+    testing::internal::CaptureStderr();
+    SWSS_LOG_DEBUG("debug %d", ++evaluated);
+    SWSS_LOG_INFO("info %d", ++evaluated);
+    string out = testing::internal::GetCapturedStderr();
+
+    Logger::setOutput(Logger::SWSS_SYSLOG);
+    Logger::setMinPrio(prio);
+
+    /* Other threads may log at DEBUG meanwhile */
+    EXPECT_EQ(evaluated, 1);
+    EXPECT_NE(out.find("  INFO:- TestBody: info 1\n"), string::npos);
+    EXPECT_EQ(out.find("TestBody: debug"), string::npos);
+}
+
+#pragma pop_macro("SWSS_LOG_COMPILE_MIN_PRIO")
+
+TEST(LOGGER, disabledNotEvaluated)
+{
+    auto prio = Logger::getMinPrio();
+    Logger::setMinPrio(Logger::SWSS_NOTICE);
+
+    int evaluated = 0;
+    SWSS_LOG_INFO("info %d", ++evaluated);
+    SWSS_LOG_DEBUG("debug %d", ++evaluated);
+    {
+        SWSS_LOG_ENTER();
+    }
+
+    Logger::setMinPrio(prio);
+    EXPECT_EQ(evaluated, 0);
+}
+
+static string deferred(const char *fmt, ...)
+#ifdef __GNUC__
+    __attribute__ ((format (printf, 1, 2)))
+#endif
+;
+
+/* Formats through DeferredFormat, "<rejected>" when capture fails */
+static string deferred(const char *fmt, ...)
+{
+    char args[1024];
+    size_t used = 0;
+
+    va_list ap;
+    va_start(ap, fmt);
+    bool captured = DeferredFormat::capture(fmt, ap, args, sizeof(args), used);
+    va_end(ap);
+
+    if (!captured)
+        return "<rejected>";
+
+    char out[256];
+    size_t len = DeferredFormat::format(fmt, args, used, out, sizeof(out));
+    EXPECT_EQ(len, strlen(out));
+    return out;
+}
+
+static string formatted(const char *fmt, ...)
+#ifdef __GNUC__
+    __attribute__ ((format (printf, 1, 2)))
+#endif
+;
+
+static string formatted(const char *fmt, ...)
+{
+    char out[256];
+
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(out, sizeof(out), fmt, ap);
+    va_end(ap);
+
+    return out;
+}
+
+#define EXPECT_DEFERRED(FMT, ...) EXPECT_EQ(deferred(FMT, ##__VA_ARGS__), formatted(FMT, ##__VA_ARGS__))
+
+TEST(LOGGER, deferredFormat)
+{
+    const char *null = NULL;
+    const char unterminated[3] = { 'a', 'b', 'c' };
+    int value = 42;
+
+    EXPECT_DEFERRED("plain text");
+    EXPECT_DEFERRED("%d %i %u %x %X %o", -1, 2, 3u, 255u, 255u, 8u);
+    EXPECT_DEFERRED("%hhd %hhu %hd %hu", 300, 300u, 70000, 70000u);
+    EXPECT_DEFERRED("%ld %lu %lld %llu", -1L, ~0UL, -1LL, ~0ULL);
+    EXPECT_DEFERRED("%jd %zu %zd %td", INTMAX_MIN, SIZE_MAX, static_cast<ssize_t>(-5), static_cast<ptrdiff_t>(-6));
+    EXPECT_DEFERRED("%+05d|%-5d|% d|%#x|%#o", 7, 7, 7, 255u, 8u);
+    EXPECT_DEFERRED("%*d|%-*d|%*d", 6, 1, 6, 2, -6, 3);
+    EXPECT_DEFERRED("%.*d|%.3d|%.0d", 5, 1, 2, 0);
+    EXPECT_DEFERRED("%f %.2f %e %G %a %10.3lf", 1.5, 3.14159, 12345.678, 0.0001, 1.0, 2.5);
+    EXPECT_DEFERRED("%c%c%c", 'a', 'b', 'c');
+    EXPECT_DEFERRED("%s|%10s|%-10s|%.2s", "str", "right", "left", "cut");
+    EXPECT_DEFERRED("%s|%10s|%.3s|%.6s", null, null, null, null);
+    EXPECT_DEFERRED("%.3s|%.*s", unterminated, 2, unterminated);
+    EXPECT_DEFERRED("%.*s", -1, "negative precision");
+    EXPECT_DEFERRED("%p %p", static_cast<void *>(&value), static_cast<void *>(NULL));
+    EXPECT_DEFERRED("100%% %s", "done");
+    EXPECT_DEFERRED(":- %s: %s took %lf sec", "fun", "msg", 0.25);
+
+    /* Output truncated like snprintf */
+    string longText(300, 'x');
+    EXPECT_DEFERRED("%s", longText.c_str());
+    EXPECT_DEFERRED("%s%d", string(255, 'y').c_str(), 12345);
+
+    EXPECT_EQ(deferred("%n", &value), "<rejected>");
+    EXPECT_EQ(deferred("%m"), "<rejected>");
+    EXPECT_EQ(deferred("%1$d", 1), "<rejected>");
+    EXPECT_EQ(deferred("%Lf", 1.0L), "<rejected>");
+    EXPECT_EQ(deferred("%ls", L"wide"), "<rejected>");
+
+    /* Arguments which do not fit are rejected too */
+    string hugeText(2000, 'z');
+    EXPECT_EQ(deferred("%s", hugeText.c_str()), "<rejected>");
+}
+
+TEST(LOGGER, asyncDeferred)
+{
+    const int messages = 100;
+
+    auto prio = Logger::getMinPrio();
+    Logger::setMinPrio(Logger::SWSS_NOTICE);
+
+    Logger::setOutput(Logger::SWSS_STDERR);
+    Logger::enableAsync(Logger::SWSS_LOG_BLOCK, 8, true);
+
+    testing::internal::CaptureStderr();
+
+    for (int i = 0; i < messages; i++)
+    {
+        /* Overwritten before the background thread formats the message */
+        char name[16];
+        snprintf(name, sizeof(name), "port%d", i);
+        SWSS_LOG_NOTICE("message %d %s %.1f", i, name, i / 2.0);
+        memset(name, 'X', sizeof(name) - 1);
+    }
+
+    Logger::flush();
+    string out = testing::internal::GetCapturedStderr();
+
+    Logger::disableAsync();
+    Logger::setOutput(Logger::SWSS_SYSLOG);
+    Logger::setMinPrio(prio);
+
+    ostringstream expected;
+    for (int i = 0; i < messages; i++)
+        expected << "NOTICE:- TestBody: message " << i << " port" << i << " " << formatted("%.1f", i / 2.0) << "\n";
+
+    EXPECT_EQ(out, expected.str());
+}
@@ -3,6 +3,9 @@
 #include <stdexcept>
 #include "common/macaddress.h"
 
+#include <algorithm>
+#include <random>
+
 using namespace swss;
 using namespace std;
 
@@ -63,3 +66,63 @@ TEST(MacAddress, parse)
 
     EXPECT_THROW(MacAddress("52:54:00:25:E9"), invalid_argument);
 }
+
+TEST(MacAddress, toUint64)
+{
+    MacAddress mac("52:54:00:ac:3a:99");
+    EXPECT_EQ(mac.toUint64(), 0x525400AC3A99ULL);
+    EXPECT_EQ(MacAddress().toUint64(), 0u);
+    EXPECT_EQ(hash<MacAddress>()(mac), hash<MacAddress>()(MacAddress("52:54:00:ac:3a:99")));
+}
+
+/* The checks done by parseMacString before the fast path */
+static bool referenceParse(const string &str, uint8_t *mac)
+{
+    if (str.size() != 17 || (str[2] != ':' && str[2] != '-'))
+        return false;
+
+    for (size_t i = 0; i < 17; i++)
+    {
+        if (i % 3 == 2 ? str[i] != str[2] : !isxdigit(static_cast<unsigned char>(str[i])))
+            return false;
+    }
+
+    for (int i = 0; i < 6; i++)
+        mac[i] = static_cast<uint8_t>(stoul(str.substr(i * 3, 2), nullptr, 16));
+
+    return true;
+}
+
+TEST(MacAddress, parseEquivalence)
+{
+    mt19937 gen(1);
+    const string chars = "0123456789abcdefABCDEF:-gG/ ";
+
+    for (int i = 0; i < 200000; i++)
+    {
+        uint8_t bin[ETHER_ADDR_LEN];
+        for (auto &b : bin)
+            b = static_cast<uint8_t>(gen());
+
+        string str = MacAddress(bin).to_string();
+        if (gen() % 2)
+            replace(str.begin(), str.end(), ':', '-');
+        for (unsigned int edits = static_cast<unsigned int>(gen() % 3); edits > 0; edits--)
+            str[gen() % str.size()] = chars[gen() % chars.size()];
+
+        uint8_t expected[ETHER_ADDR_LEN];
+        uint8_t parsed[ETHER_ADDR_LEN];
+        bool valid = referenceParse(str, expected);
+        ASSERT_EQ(MacAddress::parseMacString(str.data(), str.size(), parsed), valid) << str;
+        if (valid)
+        {
+            EXPECT_EQ(memcmp(parsed, expected, ETHER_ADDR_LEN), 0) << str;
+        }
+    }
+
+    char buf[MacAddress::STRING_SIZE];
+    MacAddress mac("52:54:00:ac:3a:99");
+    EXPECT_EQ(mac.to_string(buf, sizeof(buf) - 1), 0u);
+    EXPECT_EQ(mac.to_string(buf, sizeof(buf)), 17u);
+    EXPECT_STREQ(buf, "52:54:00:ac:3a:99");
+}
@@ -0,0 +1,309 @@
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "common/metrics.h"
+#include "common/dbconnector.h"
+#include "common/select.h"
+#include "common/schema.h"
+#include "common/table.h"
+#include "common/producerstatetable.h"
+#include "common/consumerstatetable.h"
+#include "common/producertable.h"
+#include "common/consumertable.h"
+#include "common/notificationproducer.h"
+#include "common/notificationconsumer.h"
+
+using namespace std;
+using namespace swss;
+
+static void clearMetricsTable(DBConnector &db, const string &tableName)
+{
+    for (const auto &key : db.keys("*" + tableName + "*"))
+        db.del(key);
+}
+
+static uint64_t counterValue(const string &group, const string &name)
+{
+    return MetricsRegistry::getInstance().counter(group, name).value();
+}
+
+TEST(Metrics, counter)
+{
+    Counter counter;
+    const int threads = 16;
+    const int adds = 10000;
+
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&counter, adds]() {
+            for (int i = 0; i < adds; i++)
+                counter.add();
+        });
+    }
+
+    for (auto &worker : workers)
+        worker.join();
+
+    counter.add(5);
+    EXPECT_EQ(counter.value(), static_cast<uint64_t>(threads * adds + 5));
+}
+
+TEST(Metrics, histogramBuckets)
+{
+    EXPECT_EQ(Histogram::bucketOf(0), 0U);
+    EXPECT_EQ(Histogram::bucketOf(15), 15U);
+    EXPECT_EQ(Histogram::bucketOf(16), 16U);
+    EXPECT_EQ(Histogram::bucketOf(17), 17U);
+    EXPECT_EQ(Histogram::bucketOf(32), 32U);
+    EXPECT_EQ(Histogram::bucketOf(34), 33U);
+    EXPECT_EQ(Histogram::bucketOf(UINT64_MAX), Histogram::BUCKETS - 1);
+
+    /* Every value is in a bucket ending within 1/16 above it */
+    for (uint64_t value = 1; value < (1ULL << Histogram::MAX_BITS); value = value * 3 / 2 + 1)
+    {
+        size_t bucket = Histogram::bucketOf(value);
+        ASSERT_LT(bucket, Histogram::BUCKETS);
+
+        uint64_t high = Histogram::bucketHigh(bucket);
+        EXPECT_GE(high, value);
+        EXPECT_LE(high - value, value / 16);
+
+        if (bucket > 0)
+        {
+            EXPECT_LT(Histogram::bucketHigh(bucket - 1), value);
+        }
+    }
+}
+
+TEST(Metrics, histogramPercentiles)
+{
+    Histogram histogram;
+
+    HistogramSnapshot empty = histogram.snapshot();
+    EXPECT_EQ(empty.count, 0U);
+    EXPECT_EQ(empty.percentile(50), 0U);
+
+    for (uint64_t value = 1; value <= 1000; value++)
+        histogram.record(value);
+
+    HistogramSnapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 1000U);
+    EXPECT_EQ(snapshot.sum, 500500U);
+    EXPECT_EQ(snapshot.max, 1000U);
+
+    EXPECT_GE(snapshot.percentile(50), 500U);
+    EXPECT_LE(snapshot.percentile(50), 500U + 500U / 16);
+    EXPECT_GE(snapshot.percentile(99), 990U);
+    EXPECT_LE(snapshot.percentile(99), 1000U);
+    EXPECT_EQ(snapshot.percentile(100), 1000U);
+    EXPECT_EQ(snapshot.percentile(0), 1U);
+}
+
+TEST(Metrics, collect)
+{
+    auto &registry = MetricsRegistry::getInstance();
+
+    registry.counter("UT_METRICS_COLLECT", "events").add(3);
+    registry.histogram("UT_METRICS_COLLECT", "size").record(7);
+
+    auto metrics = registry.collect();
+    ASSERT_EQ(metrics.count("UT_METRICS_COLLECT"), 1U);
+
+    auto &fields = metrics["UT_METRICS_COLLECT"];
+    EXPECT_EQ(fields["events"], "3");
+    EXPECT_EQ(fields["size_count"], "1");
+    EXPECT_EQ(fields["size_sum"], "7");
+    EXPECT_EQ(fields["size_p50"], "7");
+    EXPECT_EQ(fields["size_p99"], "7");
+    EXPECT_EQ(fields["size_max"], "7");
+
+    EXPECT_EQ(&registry.counter("UT_METRICS_COLLECT", "events"), &registry.counter("UT_METRICS_COLLECT", "events"));
+}
+
+TEST(Metrics, disabled)
+{
+    string tableName = "UT_METRICS_DISABLED";
+    DBConnector db("APPL_DB", 0, true);
+    clearMetricsTable(db, tableName);
+
+    ProducerStateTable p(&db, tableName);
+    p.set("key", { { "field", "value" } });
+
+    EXPECT_EQ(counterValue(MetricsRegistry::tableGroup("APPL_DB", tableName), "set"), 0U);
+}
+
+TEST(Metrics, tables)
+{
+    string tableName = "UT_METRICS_TABLE";
+    string group = MetricsRegistry::tableGroup("APPL_DB", tableName);
+    DBConnector db("APPL_DB", 0, true);
+    clearMetricsTable(db, tableName);
+
+    MetricsRegistry::setEnabled(true);
+
+    uint64_t commands = counterValue(MetricsRegistry::tableGroup("APPL_DB", "RedisPipeline"), "commands");
+    uint64_t objects = counterValue("Select", "objects");
+
+    ProducerStateTable p(&db, tableName);
+    ConsumerStateTable c(&db, tableName);
+    Select s;
+    s.addSelectable(&c);
+
+    p.set("key1", { { "field", "value" } });
+    p.set({ KeyOpFieldsValuesTuple("key2", SET_COMMAND, { { "field", "value" } }),
+            KeyOpFieldsValuesTuple("key3", SET_COMMAND, { { "field", "value" } }) });
+    p.del("key1");
+
+    Selectable *sel;
+    ASSERT_EQ(s.select(&sel, 1000), Select::OBJECT);
+    deque<KeyOpFieldsValuesTuple> kcos;
+    c.pops(kcos);
+    EXPECT_EQ(kcos.size(), 3U);
+
+    EXPECT_EQ(counterValue(group, "set"), 3U);
+    EXPECT_EQ(counterValue(group, "del"), 1U);
+    EXPECT_EQ(counterValue(group, "pops"), 1U);
+    EXPECT_GE(counterValue("Select", "objects"), objects + 1);
+    EXPECT_GE(counterValue(MetricsRegistry::tableGroup("APPL_DB", "RedisPipeline"), "commands"), commands + 3);
+
+    HistogramSnapshot batch = MetricsRegistry::getInstance().histogram(group, "pops_batch").snapshot();
+    EXPECT_EQ(batch.count, 1U);
+    EXPECT_EQ(batch.max, 3U);
+    EXPECT_EQ(MetricsRegistry::getInstance().histogram(group, "pops_ns").snapshot().count, 1U);
+
+    /* ProducerTable and ConsumerTable of another table */
+    string queueName = "UT_METRICS_QUEUE";
+    string queueGroup = MetricsRegistry::tableGroup("APPL_DB", queueName);
+    clearMetricsTable(db, queueName);
+
+    ProducerTable pq(&db, queueName);
+    ConsumerTable cq(&db, queueName);
+    pq.set("key", { { "field", "value" } });
+    pq.del("key");
+    cq.pops(kcos);
+
+    EXPECT_EQ(counterValue(queueGroup, "set"), 1U);
+    EXPECT_EQ(counterValue(queueGroup, "del"), 1U);
+    EXPECT_EQ(counterValue(queueGroup, "pops"), 1U);
+
+    MetricsRegistry::setEnabled(false);
+}
+
+TEST(Metrics, latencyStamps)
+{
+    string tableName = "UT_METRICS_STAMPS";
+    string group = MetricsRegistry::tableGroup("APPL_DB", tableName);
+    DBConnector db("APPL_DB", 0, true);
+    clearMetricsTable(db, tableName);
+
+    MetricsRegistry::setEnabled(true);
+
+    ProducerStateTable p(&db, tableName);
+    ConsumerStateTable c(&db, tableName);
+    Table table(&db, tableName);
+    p.setLatencyStamps(true);
+
+    p.set("key1", { { "field", "value" } });
+    p.set({ KeyOpFieldsValuesTuple("key2", SET_COMMAND, { { "field", "value" } }),
+            KeyOpFieldsValuesTuple("key3", SET_COMMAND, { { "field", "value" } }) });
+    p.del("key4");
+    p.del(vector<string>{ "key5", "key6" });
+
+    deque<KeyOpFieldsValuesTuple> kcos;
+    c.pops(kcos);
+    ASSERT_EQ(kcos.size(), 6U);
+
+    for (const auto &kco : kcos)
+    {
+        const string &key = kfvKey(kco);
+        if (key == "key1" || key == "key2" || key == "key3")
+        {
+            EXPECT_EQ(kfvOp(kco), SET_COMMAND);
+            ASSERT_EQ(kfvFieldsValues(kco).size(), 1U);
+            EXPECT_EQ(fvField(kfvFieldsValues(kco)[0]), "field");
+
+            /* Not written into the table either */
+            vector<FieldValueTuple> values;
+            ASSERT_TRUE(table.get(key, values));
+            EXPECT_EQ(values.size(), 1U);
+        }
+        else
+        {
+            EXPECT_EQ(kfvOp(kco), DEL_COMMAND);
+            EXPECT_TRUE(kfvFieldsValues(kco).empty());
+        }
+    }
+
+    HistogramSnapshot latency = MetricsRegistry::getInstance().histogram(group, "e2e_ns").snapshot();
+    EXPECT_EQ(latency.count, 6U);
+    EXPECT_GT(latency.max, 0U);
+    EXPECT_LT(latency.max, 10000000000ULL);
+
+    /* Stripped but not recorded without the metrics */
+    MetricsRegistry::setEnabled(false);
+    p.set("key1", { { "field", "value2" } });
+    c.pops(kcos);
+    ASSERT_EQ(kcos.size(), 1U);
+    EXPECT_EQ(kfvFieldsValues(kcos[0]).size(), 1U);
+    EXPECT_EQ(MetricsRegistry::getInstance().histogram(group, "e2e_ns").snapshot().count, 6U);
+}
+
+TEST(Metrics, notifications)
+{
+    DBConnector db("APPL_DB", 0, true);
+    string group = MetricsRegistry::tableGroup("APPL_DB", "UT_METRICS_CHANNEL");
+
+    MetricsRegistry::setEnabled(true);
+
+    NotificationConsumer nc(&db, "UT_METRICS_CHANNEL");
+    NotificationProducer np(&db, "UT_METRICS_CHANNEL");
+    vector<FieldValueTuple> values;
+    np.send("op", "data", values);
+
+    Select s;
+    s.addSelectable(&nc);
+    Selectable *sel;
+    ASSERT_EQ(s.select(&sel, 1000), Select::OBJECT);
+
+    EXPECT_EQ(counterValue(group, "notifications"), 1U);
+    EXPECT_GT(counterValue(group, "bytes"), 0U);
+
+    MetricsRegistry::setEnabled(false);
+}
+
+TEST(Metrics, exporter)
+{
+    string tableName = "UT_METRICS_EXPORT";
+    DBConnector db("APPL_DB", 0, true);
+    DBConnector stateDb("STATE_DB", 0, true);
+    clearMetricsTable(db, tableName);
+    clearMetricsTable(stateDb, STATE_SWSS_METRICS_TABLE_NAME);
+
+    Table metrics(&stateDb, STATE_SWSS_METRICS_TABLE_NAME);
+    string key = "metrics_ut" + metrics.getTableNameSeparator() + MetricsRegistry::tableGroup("APPL_DB", tableName);
+
+    {
+        MetricsExporter exporter("STATE_DB", "metrics_ut", 20);
+        EXPECT_TRUE(MetricsRegistry::isEnabled());
+
+        ProducerStateTable p(&db, tableName);
+        p.set("key", { { "field", "value" } });
+
+        /* Exported by the thread, maybe first before the set */
+        string value;
+        for (int i = 0; i < 100 && !(metrics.hget(key, "set", value) && value == "1"); i++)
+            this_thread::sleep_for(chrono::milliseconds(10));
+        EXPECT_EQ(value, "1");
+
+        p.del("key");
+        exporter.exportMetrics();
+        ASSERT_TRUE(metrics.hget(key, "del", value));
+        EXPECT_EQ(value, "1");
+    }
+
+    MetricsRegistry::setEnabled(false);
+    clearMetricsTable(stateDb, STATE_SWSS_METRICS_TABLE_NAME);
+}
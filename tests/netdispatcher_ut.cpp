@@ -0,0 +1,116 @@
+#include "common/netdispatcher.h"
+#include "common/netmsg.h"
+
+#include "gtest/gtest.h"
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <linux/rtnetlink.h>
+
+using namespace std;
+using namespace swss;
+
+class CountingNetMsg : public NetMsg
+{
+public:
+    void onMsg(int nlmsg_type, struct nl_object *obj) override
+    {
+        m_lastType = nlmsg_type;
+        m_count++;
+    }
+
+    int m_lastType = 0;
+    int m_count = 0;
+};
+
+static struct nl_msg *buildLinkMsg(int nlmsg_type)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(nlmsg_type, 0);
+    nlmsg_set_proto(msg, NETLINK_ROUTE);
+
+    struct ifinfomsg ifi = {};
+    ifi.ifi_family = AF_UNSPEC;
+    ifi.ifi_index = 7;
+    nlmsg_append(msg, &ifi, sizeof(ifi), NLMSG_ALIGNTO);
+    nla_put_string(msg, IFLA_IFNAME, "Ethernet7");
+
+    return msg;
+}
+
+TEST(NetDispatcher, dispatch)
+{
+    CountingNetMsg handler;
+    auto &dispatcher = NetDispatcher::getInstance();
+    struct nl_msg *msg = buildLinkMsg(RTM_NEWLINK);
+
+    // Not registered messages are dropped
+    dispatcher.onNetlinkMessage(msg);
+    EXPECT_EQ(handler.m_count, 0);
+
+    dispatcher.registerMessageHandler(RTM_NEWLINK, &handler);
+    dispatcher.onNetlinkMessage(msg);
+    EXPECT_EQ(handler.m_count, 1);
+    EXPECT_EQ(handler.m_lastType, RTM_NEWLINK);
+
+    dispatcher.unregisterMessageHandler(RTM_NEWLINK);
+    dispatcher.onNetlinkMessage(msg);
+    EXPECT_EQ(handler.m_count, 1);
+
+    nlmsg_free(msg);
+}
+
+TEST(NetDispatcher, registration)
+{
+    CountingNetMsg handler;
+    auto &dispatcher = NetDispatcher::getInstance();
+    const int outOfTableType = NetDispatcher::DISPATCH_TABLE_SIZE + 1;
+
+    dispatcher.registerMessageHandler(RTM_NEWLINK, &handler);
+    EXPECT_ANY_THROW(dispatcher.registerMessageHandler(RTM_NEWLINK, &handler));
+    dispatcher.unregisterMessageHandler(RTM_NEWLINK);
+    EXPECT_ANY_THROW(dispatcher.unregisterMessageHandler(RTM_NEWLINK));
+
+    dispatcher.registerMessageHandler(outOfTableType, &handler);
+    EXPECT_ANY_THROW(dispatcher.registerMessageHandler(outOfTableType, &handler));
+    dispatcher.unregisterMessageHandler(outOfTableType);
+    EXPECT_ANY_THROW(dispatcher.unregisterMessageHandler(outOfTableType));
+}
+
+class CountingRawNetMsg : public RawNetMsg
+{
+public:
+    void onMsg(int nlmsg_type, const struct nlmsghdr *hdr) override
+    {
+        m_lastType = nlmsg_type;
+        m_count++;
+    }
+
+    int m_lastType = 0;
+    int m_count = 0;
+};
+
+TEST(NetDispatcher, rawDispatch)
+{
+    CountingNetMsg handler;
+    CountingRawNetMsg rawHandler;
+    auto &dispatcher = NetDispatcher::getInstance();
+    struct nl_msg *msg = buildLinkMsg(RTM_NEWLINK);
+
+    dispatcher.registerRawMessageHandler(RTM_NEWLINK, &rawHandler);
+    EXPECT_ANY_THROW(dispatcher.registerMessageHandler(RTM_NEWLINK, &handler));
+    EXPECT_ANY_THROW(dispatcher.registerRawMessageHandler(RTM_NEWLINK, &rawHandler));
+
+    dispatcher.onNetlinkMessage(msg);
+    EXPECT_EQ(rawHandler.m_count, 1);
+    EXPECT_EQ(rawHandler.m_lastType, RTM_NEWLINK);
+    EXPECT_EQ(handler.m_count, 0);
+
+    dispatcher.unregisterRawMessageHandler(RTM_NEWLINK);
+    EXPECT_ANY_THROW(dispatcher.unregisterRawMessageHandler(RTM_NEWLINK));
+    EXPECT_ANY_THROW(dispatcher.registerRawMessageHandler(NetDispatcher::DISPATCH_TABLE_SIZE, &rawHandler));
+
+    dispatcher.onNetlinkMessage(msg);
+    EXPECT_EQ(rawHandler.m_count, 1);
+
+    nlmsg_free(msg);
+}
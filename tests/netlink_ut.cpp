@@ -0,0 +1,211 @@
+#include "common/netlink.h"
+#include "common/netdispatcher.h"
+#include "common/netmsg.h"
+
+#include "gtest/gtest.h"
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+    class CountingLinkHandler : public NetMsg
+    {
+    public:
+        void onMsg(int nlmsg_type, struct nl_object *obj) override
+        {
+            m_count++;
+        }
+
+        int m_count = 0;
+    };
+
+    class CountingRawLinkHandler : public RawNetMsg
+    {
+    public:
+        void onMsg(int nlmsg_type, const struct nlmsghdr *hdr) override
+        {
+            m_count++;
+        }
+
+        void onResyncBegin() override
+        {
+            m_resyncBegin++;
+        }
+
+        void onResyncEnd() override
+        {
+            m_resyncEnd++;
+        }
+
+        int m_count = 0;
+        int m_resyncBegin = 0;
+        int m_resyncEnd = 0;
+    };
+
+    /* Send a datagram of msgsPerDatagram RTM_NEWLINK messages to the netlink socket */
+    void injectLinkMessages(NetLink &netlink, int msgsPerDatagram)
+    {
+        struct sockaddr_nl dst;
+        socklen_t len = sizeof(dst);
+        ASSERT_EQ(getsockname(netlink.getFd(), (struct sockaddr *)&dst, &len), 0);
+
+        struct nl_msg *msg = nlmsg_alloc_simple(RTM_NEWLINK, 0);
+        struct ifinfomsg ifi = {};
+        ifi.ifi_index = 100;
+        nlmsg_append(msg, &ifi, sizeof(ifi), NLMSG_ALIGNTO);
+        nla_put_string(msg, IFLA_IFNAME, "Ethernet100");
+
+        vector<char> datagram;
+        struct nlmsghdr *hdr = nlmsg_hdr(msg);
+        const char *raw = reinterpret_cast<const char *>(hdr);
+        for (int i = 0; i < msgsPerDatagram; i++)
+        {
+            datagram.insert(datagram.end(), raw, raw + NLMSG_ALIGN(hdr->nlmsg_len));
+        }
+        nlmsg_free(msg);
+
+        int fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+        ASSERT_GE(fd, 0);
+        EXPECT_GT(sendto(fd, datagram.data(), datagram.size(), 0, (struct sockaddr *)&dst, sizeof(dst)), 0);
+        close(fd);
+    }
+
+    /* Multicast link messages to a group until listeners overflow */
+    void floodGroup(int group)
+    {
+        struct sockaddr_nl dst = {};
+        dst.nl_family = AF_NETLINK;
+        dst.nl_groups = 1u << (group - 1);
+
+        struct nl_msg *msg = nlmsg_alloc_simple(RTM_NEWLINK, 0);
+        struct ifinfomsg ifi = {};
+        nlmsg_append(msg, &ifi, sizeof(ifi), NLMSG_ALIGNTO);
+        nla_put_string(msg, IFLA_IFNAME, "Ethernet100");
+        struct nlmsghdr *hdr = nlmsg_hdr(msg);
+
+        int fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+        ASSERT_GE(fd, 0);
+        for (int i = 0; i < 1000; i++)
+        {
+            sendto(fd, hdr, hdr->nlmsg_len, MSG_DONTWAIT, (struct sockaddr *)&dst, sizeof(dst));
+        }
+        close(fd);
+        nlmsg_free(msg);
+    }
+
+    void checkOverflowResync(bool batched)
+    {
+        CountingRawLinkHandler handler;
+        NetLink netlink;
+        if (batched)
+        {
+            netlink.setBatchedRecv();
+        }
+        netlink.setSockBufSize(4096);
+        netlink.setAdaptiveSockBufSize(65536);
+        netlink.enableAutoResync({ RTM_GETLINK });
+        netlink.registerGroup(RTNLGRP_NOTIFY);
+        NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &handler);
+
+        floodGroup(RTNLGRP_NOTIFY);
+
+        for (int i = 0; i < 1000 && handler.m_resyncEnd == 0; i++)
+        {
+            netlink.readData();
+        }
+
+        EXPECT_GE(netlink.getOverflowCount(), 1u);
+        EXPECT_EQ(netlink.getResyncCount(), 1u);
+        EXPECT_FALSE(netlink.isResyncInProgress());
+        EXPECT_EQ(handler.m_resyncBegin, 1);
+        EXPECT_EQ(handler.m_resyncEnd, 1);
+        EXPECT_GT(netlink.getSockBufSize(), 4096u);
+        EXPECT_LE(netlink.getSockBufSize(), 65536u);
+
+        NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWLINK);
+    }
+}
+
+TEST(NetLink, batchedRecvRaw)
+{
+    CountingRawLinkHandler handler;
+    NetLink netlink;
+    netlink.setBatchedRecv(4);
+    NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &handler);
+
+    // More datagrams than the batch size are all read in one call
+    for (int i = 0; i < 10; i++)
+    {
+        injectLinkMessages(netlink, 3);
+    }
+    netlink.readData();
+    EXPECT_EQ(handler.m_count, 30);
+
+    // Nothing left to read
+    netlink.readData();
+    EXPECT_EQ(handler.m_count, 30);
+
+    NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWLINK);
+}
+
+TEST(NetLink, batchedRecvLibnl)
+{
+    CountingLinkHandler handler;
+    NetLink netlink;
+    netlink.setBatchedRecv();
+    NetDispatcher::getInstance().registerMessageHandler(RTM_NEWLINK, &handler);
+
+    injectLinkMessages(netlink, 2);
+    netlink.readData();
+    EXPECT_EQ(handler.m_count, 2);
+
+    NetDispatcher::getInstance().unregisterMessageHandler(RTM_NEWLINK);
+}
+
+TEST(NetLink, batchedRecvTruncated)
+{
+    CountingRawLinkHandler handler;
+    NetLink netlink;
+    netlink.setBatchedRecv(2, 64);
+    NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &handler);
+
+    // Datagram larger than the receive buffer is dropped
+    injectLinkMessages(netlink, 4);
+    netlink.readData();
+    EXPECT_EQ(handler.m_count, 0);
+
+    NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWLINK);
+}
+
+TEST(NetLink, recv)
+{
+    CountingLinkHandler handler;
+    NetLink netlink;
+    EXPECT_TRUE(netlink.setSockBufSize(NetLink::DEFAULT_SOCK_BUF_SIZE));
+    NetDispatcher::getInstance().registerMessageHandler(RTM_NEWLINK, &handler);
+
+    injectLinkMessages(netlink, 2);
+    netlink.readData();
+    EXPECT_EQ(handler.m_count, 2);
+
+    NetDispatcher::getInstance().unregisterMessageHandler(RTM_NEWLINK);
+}
+
+TEST(NetLink, overflowResync)
+{
+    checkOverflowResync(false);
+}
+
+TEST(NetLink, overflowResyncBatched)
+{
+    checkOverflowResync(true);
+}
@@ -0,0 +1,249 @@
+#include "common/netmsgview.h"
+
+#include "gtest/gtest.h"
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <arpa/inet.h>
+
+using namespace std;
+using namespace swss;
+
+TEST(NetMsgView, route)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(RTM_NEWROUTE, 0);
+    struct rtmsg rtm = {};
+    rtm.rtm_family = AF_INET;
+    rtm.rtm_dst_len = 24;
+    rtm.rtm_table = RT_TABLE_MAIN;
+    rtm.rtm_protocol = RTPROT_BGP;
+    nlmsg_append(msg, &rtm, sizeof(rtm), NLMSG_ALIGNTO);
+
+    uint32_t dst = inet_addr("10.1.2.0");
+    uint32_t gw = inet_addr("10.0.0.1");
+    nla_put(msg, RTA_DST, sizeof(dst), &dst);
+    nla_put(msg, RTA_GATEWAY, sizeof(gw), &gw);
+    nla_put_u32(msg, RTA_OIF, 5);
+    nla_put_u32(msg, RTA_TABLE, 1000);
+
+    RouteMsgView view(nlmsg_hdr(msg));
+    ASSERT_TRUE(view.isValid());
+    EXPECT_EQ(view.getType(), RTM_NEWROUTE);
+    EXPECT_EQ(view.getProtocol(), RTPROT_BGP);
+    EXPECT_EQ(view.getTable(), 1000u);
+
+    IpPrefix prefix;
+    EXPECT_TRUE(view.getDst(prefix));
+    EXPECT_EQ(prefix.to_string(), "10.1.2.0/24");
+
+    IpAddress gateway;
+    EXPECT_TRUE(view.getGateway(gateway));
+    EXPECT_EQ(gateway.to_string(), "10.0.0.1");
+
+    uint32_t oif = 0, priority = 0;
+    EXPECT_TRUE(view.getOif(oif));
+    EXPECT_EQ(oif, 5u);
+    EXPECT_FALSE(view.getPriority(priority));
+    EXPECT_FALSE(view.hasMultipath());
+
+    nlmsg_free(msg);
+}
+
+TEST(NetMsgView, multipathRoute)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(RTM_NEWROUTE, 0);
+    struct rtmsg rtm = {};
+    rtm.rtm_family = AF_INET;
+    rtm.rtm_dst_len = 16;
+    rtm.rtm_table = RT_TABLE_MAIN;
+    rtm.rtm_type = RTN_UNICAST;
+    nlmsg_append(msg, &rtm, sizeof(rtm), NLMSG_ALIGNTO);
+
+    uint32_t dst = inet_addr("10.2.0.0");
+    nla_put(msg, RTA_DST, sizeof(dst), &dst);
+
+    struct nlattr *mp = nla_nest_start(msg, RTA_MULTIPATH);
+    for (int i = 1; i <= 2; i++)
+    {
+        struct rtnexthop *rtnh = static_cast<struct rtnexthop *>(nlmsg_reserve(msg, sizeof(*rtnh), NLMSG_ALIGNTO));
+        rtnh->rtnh_flags = 0;
+        rtnh->rtnh_hops = 0;
+        rtnh->rtnh_ifindex = 10 + i;
+
+        uint32_t gw = inet_addr(i == 1 ? "10.0.0.1" : "10.0.0.2");
+        nla_put(msg, RTA_GATEWAY, sizeof(gw), &gw);
+        rtnh->rtnh_len = static_cast<unsigned short>(
+            reinterpret_cast<char *>(nlmsg_tail(nlmsg_hdr(msg))) - reinterpret_cast<char *>(rtnh));
+    }
+    nla_nest_end(msg, mp);
+
+    RouteMsgView view(nlmsg_hdr(msg));
+    ASSERT_TRUE(view.isValid());
+    EXPECT_TRUE(view.hasMultipath());
+
+    vector<RouteNextHop> nextHops;
+    ASSERT_TRUE(view.getNextHops(nextHops));
+    ASSERT_EQ(nextHops.size(), 2u);
+    EXPECT_TRUE(nextHops[0].hasGateway);
+    EXPECT_EQ(nextHops[0].gateway.to_string(), "10.0.0.1");
+    EXPECT_EQ(nextHops[0].ifindex, 11u);
+    EXPECT_EQ(nextHops[1].gateway.to_string(), "10.0.0.2");
+    EXPECT_EQ(nextHops[1].ifindex, 12u);
+
+    nlmsg_free(msg);
+}
+
+TEST(NetMsgView, defaultRoute)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(RTM_DELROUTE, 0);
+    struct rtmsg rtm = {};
+    rtm.rtm_family = AF_INET6;
+    rtm.rtm_table = RT_TABLE_MAIN;
+    nlmsg_append(msg, &rtm, sizeof(rtm), NLMSG_ALIGNTO);
+
+    RouteMsgView view(nlmsg_hdr(msg));
+    IpPrefix prefix;
+    EXPECT_TRUE(view.getDst(prefix));
+    EXPECT_EQ(prefix.to_string(), "::/0");
+    EXPECT_EQ(view.getTable(), (uint32_t)RT_TABLE_MAIN);
+
+    IpAddress gateway;
+    EXPECT_FALSE(view.getGateway(gateway));
+
+    nlmsg_free(msg);
+}
+
+TEST(NetMsgView, neigh)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(RTM_NEWNEIGH, 0);
+    struct ndmsg ndm = {};
+    ndm.ndm_family = AF_INET6;
+    ndm.ndm_ifindex = 12;
+    ndm.ndm_state = NUD_REACHABLE;
+    nlmsg_append(msg, &ndm, sizeof(ndm), NLMSG_ALIGNTO);
+
+    IpAddress dst("fc00::1");
+    MacAddress mac("00:11:22:33:44:55");
+    nla_put(msg, NDA_DST, 16, dst.getV6Addr());
+    nla_put(msg, NDA_LLADDR, ETHER_ADDR_LEN, mac.getMac());
+
+    NeighMsgView view(nlmsg_hdr(msg));
+    ASSERT_TRUE(view.isValid());
+    EXPECT_EQ(view.getIfindex(), 12);
+    EXPECT_EQ(view.getState(), NUD_REACHABLE);
+
+    IpAddress ip;
+    EXPECT_TRUE(view.getDst(ip));
+    EXPECT_EQ(ip, dst);
+
+    MacAddress lladdr;
+    EXPECT_TRUE(view.getLladdr(lladdr));
+    EXPECT_EQ(lladdr, mac);
+
+    nlmsg_free(msg);
+}
+
+TEST(NetMsgView, link)
+{
+    const uint8_t operUp = 6; // IF_OPER_UP
+    struct nl_msg *msg = nlmsg_alloc_simple(RTM_NEWLINK, 0);
+    struct ifinfomsg ifi = {};
+    ifi.ifi_index = 3;
+    nlmsg_append(msg, &ifi, sizeof(ifi), NLMSG_ALIGNTO);
+    nla_put_string(msg, IFLA_IFNAME, "Ethernet0");
+    nla_put_u32(msg, IFLA_MTU, 9100);
+    nla_put_u8(msg, IFLA_OPERSTATE, operUp);
+
+    LinkMsgView view(nlmsg_hdr(msg));
+    ASSERT_TRUE(view.isValid());
+    EXPECT_EQ(view.getIfindex(), 3);
+    ASSERT_NE(view.getName(), nullptr);
+    EXPECT_STREQ(view.getName(), "Ethernet0");
+
+    uint32_t mtu = 0, master = 0;
+    uint8_t operState = 0;
+    EXPECT_TRUE(view.getMtu(mtu));
+    EXPECT_EQ(mtu, 9100u);
+    EXPECT_TRUE(view.getOperState(operState));
+    EXPECT_EQ(operState, operUp);
+    EXPECT_FALSE(view.getMaster(master));
+
+    MacAddress mac;
+    EXPECT_FALSE(view.getAddress(mac));
+
+    nlmsg_free(msg);
+}
+
+TEST(NetMsgView, truncated)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(RTM_NEWLINK, 0);
+
+    LinkMsgView view(nlmsg_hdr(msg));
+    EXPECT_FALSE(view.isValid());
+    EXPECT_FALSE(view.hasAttr(IFLA_IFNAME));
+
+    nlmsg_free(msg);
+}
+
+static void putTuple(struct nl_msg *msg, int type, const char *src, const char *dst,
+                     uint16_t srcPort, uint16_t dstPort)
+{
+    struct nlattr *tuple = nla_nest_start(msg, type);
+
+    struct nlattr *ip = nla_nest_start(msg, CTA_TUPLE_IP);
+    uint32_t addr = inet_addr(src);
+    nla_put(msg, CTA_IP_V4_SRC, sizeof(addr), &addr);
+    addr = inet_addr(dst);
+    nla_put(msg, CTA_IP_V4_DST, sizeof(addr), &addr);
+    nla_nest_end(msg, ip);
+
+    struct nlattr *proto = nla_nest_start(msg, CTA_TUPLE_PROTO);
+    nla_put_u8(msg, CTA_PROTO_NUM, IPPROTO_TCP);
+    nla_put_u16(msg, CTA_PROTO_SRC_PORT, htons(srcPort));
+    nla_put_u16(msg, CTA_PROTO_DST_PORT, htons(dstPort));
+    nla_nest_end(msg, proto);
+
+    nla_nest_end(msg, tuple);
+}
+
+TEST(NetMsgView, connTrack)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple((NFNL_SUBSYS_CTNETLINK << 8) | IPCTNL_MSG_CT_NEW, 0);
+    struct nfgenmsg nfg = {};
+    nfg.nfgen_family = AF_INET;
+    nfg.version = NFNETLINK_V0;
+    nlmsg_append(msg, &nfg, sizeof(nfg), NLMSG_ALIGNTO);
+
+    putTuple(msg, CTA_TUPLE_ORIG, "192.168.0.2", "8.8.8.8", 40000, 53);
+    putTuple(msg, CTA_TUPLE_REPLY, "8.8.8.8", "10.0.0.1", 53, 1024);
+    nla_put_u32(msg, CTA_STATUS, htonl(IPS_CONFIRMED | IPS_SRC_NAT));
+    nla_put_u32(msg, CTA_MARK, htonl(0x100));
+    nla_put_u16(msg, CTA_ZONE, htons(3));
+
+    ConnTrackMsgView view(nlmsg_hdr(msg));
+    ASSERT_TRUE(view.isValid());
+    EXPECT_EQ(view.getFamily(), AF_INET);
+    EXPECT_TRUE(view.isNat());
+    EXPECT_EQ(view.getZone(), 3);
+
+    uint32_t mark;
+    EXPECT_TRUE(view.getMark(mark));
+    EXPECT_EQ(mark, 0x100u);
+
+    ConnTrackTuple tuple;
+    ASSERT_TRUE(view.getOrigTuple(tuple));
+    EXPECT_EQ(tuple.src.to_string(), "192.168.0.2");
+    EXPECT_EQ(tuple.dst.to_string(), "8.8.8.8");
+    EXPECT_EQ(tuple.protocol, IPPROTO_TCP);
+    EXPECT_EQ(tuple.srcPort, 40000);
+    EXPECT_EQ(tuple.dstPort, 53);
+
+    ASSERT_TRUE(view.getReplyTuple(tuple));
+    EXPECT_EQ(tuple.dst.to_string(), "10.0.0.1");
+    EXPECT_EQ(tuple.dstPort, 1024);
+
+    uint32_t timeout;
+    EXPECT_FALSE(view.getTimeout(timeout));
+
+    nlmsg_free(msg);
+}
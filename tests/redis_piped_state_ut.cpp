@@ -351,6 +351,81 @@ TEST(ConsumerStateTable, async_set_del_set)
     }
 }
 
+TEST(ConsumerStateTable, async_batched_set_del)
+{
+    clearDB();
+
+    /* Prepare producer */
+    int index = 0;
+    string tableName = "UT_REDIS_THREAD_" + to_string(index);
+    DBConnector db(TEST_DB, 0, true);
+    RedisPipeline pipeline(&db);
+    ProducerStateTable p(&pipeline, tableName, true);
+    int numOfKeys = 100;
+    int maxNumOfFields = 3;
+
+    /* Batched set operation */
+    {
+        vector<KeyOpFieldsValuesTuple> kfvs;
+        for (int i = 0; i < numOfKeys; i++)
+        {
+            vector<FieldValueTuple> fields;
+            for (int j = 0; j < maxNumOfFields; j++)
+            {
+                FieldValueTuple t(field(j), value(j));
+                fields.push_back(t);
+            }
+            kfvs.push_back(KeyOpFieldsValuesTuple(key(i), "SET", fields));
+        }
+        p.set(kfvs);
+    }
+
+    /* Batched del of the odd keys */
+    {
+        vector<string> keys;
+        for (int i = 1; i < numOfKeys; i += 2)
+        {
+            keys.push_back(key(i));
+        }
+        p.del(keys);
+    }
+
+    /* Empty batches are no-ops */
+    p.set(vector<KeyOpFieldsValuesTuple>());
+    p.del(vector<string>());
+    p.flush();
+
+    /* Prepare consumer */
+    ConsumerStateTable c(&db, tableName, numOfKeys * 2);
+    Select cs;
+    Selectable *selectcs;
+    cs.addSelectable(&c);
+
+    int numOfSet = 0;
+    int numOfDel = 0;
+    while (cs.select(&selectcs, 1000) == Select::OBJECT)
+    {
+        std::deque<KeyOpFieldsValuesTuple> vkco;
+        c.pops(vkco);
+
+        for (auto &kco : vkco)
+        {
+            if (kfvOp(kco) == "SET")
+            {
+                numOfSet++;
+                EXPECT_EQ(kfvFieldsValues(kco).size(), (size_t)maxNumOfFields);
+            }
+            else
+            {
+                numOfDel++;
+                EXPECT_EQ(kfvOp(kco), "DEL");
+            }
+        }
+    }
+    EXPECT_EQ(numOfSet, numOfKeys / 2);
+    EXPECT_EQ(numOfDel, numOfKeys / 2);
+}
+
 TEST(ConsumerStateTable, async_singlethread)
 {
     clearDB();
@@ -2,6 +2,8 @@
 #include "common/stringutility.h"
 #include "common/boolean.h"
 
+#include <boost/optional/optional_io.hpp>
+
 #include "gtest/gtest.h"
 
 TEST(REDISUTILITY, fvsGetValue)
@@ -30,3 +32,68 @@ TEST(REDISUTILITY, fvsGetValue)
     EXPECT_TRUE(swss::fvsGetValue(fvt, "Int", true));
     EXPECT_FALSE(swss::fvsGetValue(fvt, "double"));
 }
+
+static constexpr swss::FieldKey ADMIN_STATUS("admin_status");
+static_assert(ADMIN_STATUS.hash() == swss::fieldHash("admin_status"), "FieldKey hash is computed at compile time");
+
+TEST(REDISUTILITY, FieldValueIndex)
+{
+    std::vector<swss::FieldValueTuple> fvt;
+    fvt.push_back(std::make_pair("mtu", "9100"));
+    fvt.push_back(std::make_pair("admin_status", "up"));
+    fvt.push_back(std::make_pair("Speed", "100000"));
+    fvt.push_back(std::make_pair("mtu", "1500"));
+    fvt.push_back(std::make_pair("", "empty"));
+
+    swss::FieldValueIndex index(fvt);
+    EXPECT_EQ(index.size(), fvt.size());
+
+    /* Same answers as fvsGetValue, first field wins */
+    for (std::string field : {"mtu", "admin_status", "Speed", "speed", "", "alias", "mtu "})
+    {
+        EXPECT_EQ(index.get(field), swss::fvsGetValue(fvt, field)) << field;
+    }
+
+    const std::string *value = index.find(ADMIN_STATUS);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(value, &fvValue(fvt[1]));
+    EXPECT_EQ(*index.find("mtu"), "9100");
+    EXPECT_EQ(index.find("lanes"), nullptr);
+
+    std::string buffer("speed,mtu");
+    EXPECT_EQ(*index.find(swss::FieldKey(buffer.c_str() + 6, 3)), "9100");
+
+    swss::FieldValueIndex icase(fvt, true);
+    for (std::string field : {"MTU", "Admin_Status", "speed", "SPEED", "alias"})
+    {
+        EXPECT_EQ(icase.get(field), swss::fvsGetValue(fvt, field, true)) << field;
+    }
+    EXPECT_EQ(*icase.find(ADMIN_STATUS), "up");
+
+    /* Past the inline table */
+    std::vector<swss::FieldValueTuple> many;
+    for (int i = 0; i < 100; i++)
+        many.push_back(std::make_pair("field" + std::to_string(i), std::to_string(i)));
+
+    swss::FieldValueIndex large(many);
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(*large.find("field" + std::to_string(i)), std::to_string(i));
+    EXPECT_EQ(large.find("field100"), nullptr);
+
+    std::vector<swss::FieldValueTuple> none;
+    swss::FieldValueIndex empty(none);
+    EXPECT_EQ(empty.find("mtu"), nullptr);
+}
+
+TEST(REDISUTILITY, fieldHash)
+{
+    EXPECT_EQ(swss::fieldHash("admin_status"), swss::fieldHash("admin_status", 12));
+    EXPECT_EQ(swss::fieldHash(""), swss::fieldHash("", 0));
+    EXPECT_EQ(swss::fieldHash("SAI_PORT_ATTR_ADMIN_STATE"), swss::fieldHash("SAI_PORT_ATTR_ADMIN_STATE", 25));
+    EXPECT_EQ(swss::fieldHash("12345678"), swss::fieldHash("12345678", 8));
+    EXPECT_EQ(swss::fieldHash("123456789"), swss::fieldHash("123456789", 9));
+    EXPECT_NE(swss::fieldHash("a"), swss::fieldHash("a\0", 2));
+    EXPECT_EQ(swss::fieldHash("mtu"), swss::fieldHashNoCase("MTU", 3));
+    EXPECT_EQ(swss::fieldHash("admin_status"), swss::fieldHashNoCase("Admin_Status", 12));
+    EXPECT_NE(swss::fieldHash("mtu"), swss::fieldHash("MTU", 3));
+}
@@ -0,0 +1,279 @@
+#include "common/routetablesync.h"
+#include "common/consumerstatetable.h"
+#include "common/redispipeline.h"
+#include "common/select.h"
+
+#include "gtest/gtest.h"
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <arpa/inet.h>
+
+#include <deque>
+#include <map>
+
+using namespace std;
+using namespace swss;
+
+#define TEST_DB "APPL_DB"
+#define TEST_TABLE "UT_ROUTE_TABLE"
+
+static struct nl_msg *routeMsg(int type, const char *dst, int dstLen, const char *gw, uint32_t oif,
+                               uint8_t routeType = RTN_UNICAST, uint8_t table = RT_TABLE_MAIN)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(type, 0);
+    struct rtmsg rtm = {};
+    rtm.rtm_family = AF_INET;
+    rtm.rtm_dst_len = static_cast<unsigned char>(dstLen);
+    rtm.rtm_table = table;
+    rtm.rtm_type = routeType;
+    nlmsg_append(msg, &rtm, sizeof(rtm), NLMSG_ALIGNTO);
+
+    uint32_t addr = inet_addr(dst);
+    nla_put(msg, RTA_DST, sizeof(addr), &addr);
+
+    if (gw)
+    {
+        uint32_t gwAddr = inet_addr(gw);
+        nla_put(msg, RTA_GATEWAY, sizeof(gwAddr), &gwAddr);
+    }
+
+    if (oif)
+        nla_put_u32(msg, RTA_OIF, oif);
+
+    return msg;
+}
+
+static struct nl_msg *route6Msg(int type, const char *dst, int dstLen, const char *gw, uint32_t oif, int flags = 0)
+{
+    struct nl_msg *msg = nlmsg_alloc_simple(type, flags);
+    struct rtmsg rtm = {};
+    rtm.rtm_family = AF_INET6;
+    rtm.rtm_dst_len = static_cast<unsigned char>(dstLen);
+    rtm.rtm_table = RT_TABLE_MAIN;
+    rtm.rtm_type = RTN_UNICAST;
+    nlmsg_append(msg, &rtm, sizeof(rtm), NLMSG_ALIGNTO);
+
+    struct in6_addr addr;
+    inet_pton(AF_INET6, dst, &addr);
+    nla_put(msg, RTA_DST, sizeof(addr), &addr);
+
+    struct in6_addr gwAddr;
+    inet_pton(AF_INET6, gw, &gwAddr);
+    nla_put(msg, RTA_GATEWAY, sizeof(gwAddr), &gwAddr);
+    nla_put_u32(msg, RTA_OIF, oif);
+
+    return msg;
+}
+
+static void feed(RouteTableSync &sync, struct nl_msg *msg)
+{
+    struct nlmsghdr *hdr = nlmsg_hdr(msg);
+    sync.onMsg(hdr->nlmsg_type, hdr);
+    nlmsg_free(msg);
+}
+
+static void clearTable(DBConnector &db)
+{
+    RedisReply r(&db, "FLUSHDB", REDIS_REPLY_STATUS);
+    r.checkStatusOK();
+}
+
+static map<string, KeyOpFieldsValuesTuple> popAll(DBConnector &db)
+{
+    ConsumerStateTable c(&db, TEST_TABLE, 1000);
+    Select cs;
+    Selectable *selectcs;
+    cs.addSelectable(&c);
+
+    map<string, KeyOpFieldsValuesTuple> result;
+    while (cs.select(&selectcs, 1000) == Select::OBJECT)
+    {
+        std::deque<KeyOpFieldsValuesTuple> entries;
+        c.pops(entries);
+        for (auto &entry : entries)
+            result[kfvKey(entry)] = entry;
+    }
+
+    return result;
+}
+
+static string fieldValue(const KeyOpFieldsValuesTuple &kfv, const string &field)
+{
+    for (const auto &fv : kfvFieldsValues(kfv))
+    {
+        if (fvField(fv) == field)
+            return fvValue(fv);
+    }
+
+    return string();
+}
+
+static string ifname(int ifindex)
+{
+    return "Ethernet" + to_string(ifindex);
+}
+
+TEST(RouteTableSync, routes)
+{
+    DBConnector db(TEST_DB, 0, true);
+    clearTable(db);
+
+    RedisPipeline pipeline(&db);
+    ProducerStateTable p(&pipeline, TEST_TABLE, true);
+    RouteTableSync sync(p);
+    sync.setIfNameResolver(ifname);
+
+    feed(sync, routeMsg(RTM_NEWROUTE, "10.1.0.0", 16, "10.0.0.1", 4));
+    feed(sync, routeMsg(RTM_NEWROUTE, "10.2.0.0", 16, NULL, 8));
+    feed(sync, routeMsg(RTM_NEWROUTE, "10.3.0.0", 16, NULL, 0, RTN_BLACKHOLE));
+
+    /* Not written: other table, other route type */
+    feed(sync, routeMsg(RTM_NEWROUTE, "10.4.0.0", 16, "10.0.0.1", 4, RTN_UNICAST, RT_TABLE_LOCAL));
+    feed(sync, routeMsg(RTM_NEWROUTE, "10.5.0.0", 16, NULL, 4, RTN_BROADCAST));
+
+    sync.flush();
+
+    EXPECT_EQ(sync.getRouteCount(), 3u);
+    EXPECT_EQ(sync.getSkippedCount(), 2u);
+    EXPECT_EQ(sync.getBatchCount(), 1u);
+    EXPECT_EQ(sync.getWriteCount(), 3u);
+
+    auto routes = popAll(db);
+    ASSERT_EQ(routes.size(), 3u);
+
+    EXPECT_EQ(fieldValue(routes["10.1.0.0/16"], "nexthop"), "10.0.0.1");
+    EXPECT_EQ(fieldValue(routes["10.1.0.0/16"], "ifname"), "Ethernet4");
+    EXPECT_EQ(fieldValue(routes["10.2.0.0/16"], "nexthop"), "0.0.0.0");
+    EXPECT_EQ(fieldValue(routes["10.2.0.0/16"], "ifname"), "Ethernet8");
+    EXPECT_EQ(fieldValue(routes["10.3.0.0/16"], "blackhole"), "true");
+}
+
+TEST(RouteTableSync, coalesce)
+{
+    DBConnector db(TEST_DB, 0, true);
+    clearTable(db);
+
+    RedisPipeline pipeline(&db);
+    ProducerStateTable p(&pipeline, TEST_TABLE, true);
+
+    /* Write the first route so it exists before the batch deleting it */
+    {
+        RouteTableSync sync(p);
+        sync.setIfNameResolver(ifname);
+        feed(sync, routeMsg(RTM_NEWROUTE, "10.1.0.0", 16, NULL, 0, RTN_BLACKHOLE));
+        sync.flush();
+        popAll(db);
+    }
+
+    RouteTableSync sync(p);
+    sync.setIfNameResolver(ifname);
+
+    /* Replaced route, only the last fields remain */
+    feed(sync, routeMsg(RTM_DELROUTE, "10.1.0.0", 16, NULL, 0, RTN_BLACKHOLE));
+    feed(sync, routeMsg(RTM_NEWROUTE, "10.1.0.0", 16, "10.0.0.1", 4));
+
+    /* Added then removed */
+    feed(sync, routeMsg(RTM_NEWROUTE, "10.2.0.0", 16, "10.0.0.1", 4));
+    feed(sync, routeMsg(RTM_DELROUTE, "10.2.0.0", 16, "10.0.0.1", 4));
+
+    /* Updated twice */
+    feed(sync, routeMsg(RTM_NEWROUTE, "10.3.0.0", 16, "10.0.0.1", 4));
+    feed(sync, routeMsg(RTM_NEWROUTE, "10.3.0.0", 16, "10.0.0.2", 8));
+
+    sync.flush();
+
+    EXPECT_EQ(sync.getRouteCount(), 6u);
+    EXPECT_EQ(sync.getCoalescedCount(), 3u);
+    EXPECT_EQ(sync.getWriteCount(), 3u);
+
+    auto routes = popAll(db);
+
+    ASSERT_EQ(routes.count("10.1.0.0/16"), 1u);
+    EXPECT_EQ(kfvOp(routes["10.1.0.0/16"]), SET_COMMAND);
+    EXPECT_EQ(kfvFieldsValues(routes["10.1.0.0/16"]).size(), 2u);
+    EXPECT_EQ(fieldValue(routes["10.1.0.0/16"], "blackhole"), "");
+    EXPECT_EQ(fieldValue(routes["10.1.0.0/16"], "nexthop"), "10.0.0.1");
+
+    ASSERT_EQ(routes.count("10.2.0.0/16"), 1u);
+    EXPECT_EQ(kfvOp(routes["10.2.0.0/16"]), DEL_COMMAND);
+
+    ASSERT_EQ(routes.count("10.3.0.0/16"), 1u);
+    EXPECT_EQ(fieldValue(routes["10.3.0.0/16"], "nexthop"), "10.0.0.2");
+    EXPECT_EQ(fieldValue(routes["10.3.0.0/16"], "ifname"), "Ethernet8");
+}
+
+TEST(RouteTableSync, batchSize)
+{
+    DBConnector db(TEST_DB, 0, true);
+    clearTable(db);
+
+    RedisPipeline pipeline(&db);
+    ProducerStateTable p(&pipeline, TEST_TABLE, true);
+    RouteTableSync sync(p, 16);
+    sync.setIfNameResolver(ifname);
+
+    for (int i = 0; i < 100; i++)
+    {
+        string dst = "10.0." + to_string(i) + ".0";
+        feed(sync, routeMsg(RTM_NEWROUTE, dst.c_str(), 24, "10.255.0.1", 4));
+    }
+
+    /* Full batches are written before the flush */
+    EXPECT_EQ(sync.getBatchCount(), 6u);
+    EXPECT_EQ(sync.getWriteCount(), 96u);
+
+    sync.flush();
+    EXPECT_EQ(sync.getBatchCount(), 7u);
+    EXPECT_EQ(sync.getWriteCount(), 100u);
+
+    EXPECT_EQ(popAll(db).size(), 100u);
+}
+
+TEST(RouteTableSync, appendIpv6)
+{
+    DBConnector db(TEST_DB, 0, true);
+    clearTable(db);
+
+    RedisPipeline pipeline(&db);
+    ProducerStateTable p(&pipeline, TEST_TABLE, true);
+    RouteTableSync sync(p);
+    sync.setIfNameResolver(ifname);
+
+    /* ECMP route sent one nexthop per message, in one batch then in the next */
+    feed(sync, route6Msg(RTM_NEWROUTE, "2001:db8::", 64, "fe80::1", 4, NLM_F_CREATE));
+    feed(sync, route6Msg(RTM_NEWROUTE, "2001:db8::", 64, "fe80::2", 8, NLM_F_CREATE | NLM_F_APPEND));
+    sync.flush();
+
+    auto routes = popAll(db);
+    EXPECT_EQ(fieldValue(routes["2001:db8::/64"], "nexthop"), "fe80::1,fe80::2");
+    EXPECT_EQ(fieldValue(routes["2001:db8::/64"], "ifname"), "Ethernet4,Ethernet8");
+
+    feed(sync, route6Msg(RTM_NEWROUTE, "2001:db8::", 64, "fe80::3", 12, NLM_F_CREATE | NLM_F_APPEND));
+    sync.flush();
+
+    routes = popAll(db);
+    EXPECT_EQ(fieldValue(routes["2001:db8::/64"], "nexthop"), "fe80::1,fe80::2,fe80::3");
+    EXPECT_EQ(fieldValue(routes["2001:db8::/64"], "ifname"), "Ethernet4,Ethernet8,Ethernet12");
+
+    /* The same append sent twice is not added twice */
+    feed(sync, route6Msg(RTM_NEWROUTE, "2001:db8::", 64, "fe80::3", 12, NLM_F_CREATE | NLM_F_APPEND));
+    feed(sync, route6Msg(RTM_NEWROUTE, "2001:db8::", 64, "fe80::3", 12, NLM_F_CREATE | NLM_F_APPEND));
+    sync.flush();
+
+    routes = popAll(db);
+    EXPECT_EQ(fieldValue(routes["2001:db8::/64"], "nexthop"), "fe80::1,fe80::2,fe80::3");
+    EXPECT_EQ(fieldValue(routes["2001:db8::/64"], "ifname"), "Ethernet4,Ethernet8,Ethernet12");
+
+    /* A replace or a delete starts over */
+    feed(sync, route6Msg(RTM_NEWROUTE, "2001:db8::", 64, "fe80::4", 16, NLM_F_REPLACE));
+    feed(sync, route6Msg(RTM_NEWROUTE, "2001:db8::", 64, "fe80::5", 20, NLM_F_APPEND));
+    feed(sync, route6Msg(RTM_DELROUTE, "2001:db9::", 64, "fe80::1", 4));
+    feed(sync, route6Msg(RTM_NEWROUTE, "2001:db9::", 64, "fe80::6", 24, NLM_F_APPEND));
+    sync.flush();
+
+    routes = popAll(db);
+    EXPECT_EQ(fieldValue(routes["2001:db8::/64"], "nexthop"), "fe80::4,fe80::5");
+    EXPECT_EQ(fieldValue(routes["2001:db9::/64"], "nexthop"), "fe80::6");
+    EXPECT_EQ(fieldValue(routes["2001:db9::/64"], "ifname"), "Ethernet24");
+}
@@ -0,0 +1,223 @@
+#include "common/threadednetlink.h"
+#include "common/netdispatcher.h"
+#include "common/netmsg.h"
+#include "common/select.h"
+
+#include "gtest/gtest.h"
+
+#include <netlink/msg.h>
+#include <netlink/attr.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace swss;
+
+namespace
+{
+    class OrderRecorder : public RawNetMsg
+    {
+    public:
+        void onMsg(int nlmsg_type, const struct nlmsghdr *hdr) override
+        {
+            m_types.push_back(nlmsg_type);
+        }
+
+        vector<int> m_types;
+    };
+
+    /* Sends count datagrams of one message of nlmsg_type to the socket of reader */
+    void inject(ThreadedNetLink &reader, int nlmsg_type, int count)
+    {
+        struct sockaddr_nl dst;
+        socklen_t len = sizeof(dst);
+        ASSERT_EQ(getsockname(reader.getSocketFd(), (struct sockaddr *)&dst, &len), 0);
+
+        struct nl_msg *msg = nlmsg_alloc_simple(nlmsg_type, 0);
+        struct rtgenmsg rtg = {};
+        nlmsg_append(msg, &rtg, sizeof(rtg), NLMSG_ALIGNTO);
+        struct nlmsghdr *hdr = nlmsg_hdr(msg);
+
+        int fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+        ASSERT_GE(fd, 0);
+        for (int i = 0; i < count; i++)
+        {
+            ASSERT_GT(sendto(fd, hdr, hdr->nlmsg_len, 0, (struct sockaddr *)&dst, sizeof(dst)), 0);
+        }
+        close(fd);
+        nlmsg_free(msg);
+    }
+
+    void waitPending(ThreadedNetLink &reader, size_t count)
+    {
+        for (int i = 0; i < 2000 && reader.getPendingCount() < count; i++)
+        {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        ASSERT_EQ(reader.getPendingCount(), count);
+    }
+
+    class ResyncRecorder : public RawNetMsg
+    {
+    public:
+        void onMsg(int nlmsg_type, const struct nlmsghdr *hdr) override
+        {
+        }
+
+        void onResyncBegin() override
+        {
+            m_resyncBegin++;
+        }
+
+        void onResyncEnd() override
+        {
+            m_resyncEnd++;
+        }
+
+        int m_resyncBegin = 0;
+        int m_resyncEnd = 0;
+    };
+
+    /* Multicast link messages to a group until listeners overflow */
+    void floodGroup(int group)
+    {
+        struct sockaddr_nl dst = {};
+        dst.nl_family = AF_NETLINK;
+        dst.nl_groups = 1u << (group - 1);
+
+        struct nl_msg *msg = nlmsg_alloc_simple(RTM_NEWLINK, 0);
+        struct ifinfomsg ifi = {};
+        nlmsg_append(msg, &ifi, sizeof(ifi), NLMSG_ALIGNTO);
+        nla_put_string(msg, IFLA_IFNAME, "Ethernet100");
+        struct nlmsghdr *hdr = nlmsg_hdr(msg);
+
+        int fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+        ASSERT_GE(fd, 0);
+        for (int i = 0; i < 1000; i++)
+        {
+            sendto(fd, hdr, hdr->nlmsg_len, MSG_DONTWAIT, (struct sockaddr *)&dst, sizeof(dst));
+        }
+        close(fd);
+        nlmsg_free(msg);
+    }
+
+    void runSelect(Select &s, OrderRecorder &recorder, size_t count)
+    {
+        for (int i = 0; i < 1000 && recorder.m_types.size() < count; i++)
+        {
+            Selectable *sel;
+            s.select(&sel, 100);
+        }
+    }
+}
+
+TEST(ThreadedNetLink, priority)
+{
+    OrderRecorder recorder;
+    NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWROUTE, &recorder);
+    NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &recorder);
+
+    ThreadedNetLink routes(0);
+    ThreadedNetLink links(10);
+    routes.setReadBudget(8);
+    routes.start();
+    links.start();
+
+    inject(routes, RTM_NEWROUTE, 100);
+    waitPending(routes, 100);
+    inject(links, RTM_NEWLINK, 1);
+    waitPending(links, 1);
+
+    Select s;
+    s.addSelectable(&routes);
+    s.addSelectable(&links);
+
+    /* Link event goes first although the route events were received before */
+    Selectable *sel;
+    EXPECT_EQ(s.select(&sel, 100), Select::OBJECT);
+    EXPECT_EQ(sel, &links);
+    ASSERT_EQ(recorder.m_types.size(), 1u);
+    EXPECT_EQ(recorder.m_types[0], RTM_NEWLINK);
+
+    /* Route events come by read budget */
+    EXPECT_EQ(s.select(&sel, 100), Select::OBJECT);
+    EXPECT_EQ(sel, &routes);
+    EXPECT_EQ(recorder.m_types.size(), 9u);
+
+    inject(links, RTM_NEWLINK, 1);
+    waitPending(links, 1);
+    EXPECT_EQ(s.select(&sel, 100), Select::OBJECT);
+    EXPECT_EQ(sel, &links);
+    EXPECT_EQ(recorder.m_types.back(), RTM_NEWLINK);
+
+    runSelect(s, recorder, 102);
+    EXPECT_EQ(recorder.m_types.size(), 102u);
+    EXPECT_EQ(routes.getPendingCount(), 0u);
+    EXPECT_EQ(routes.getDatagramCount(), 100u);
+    EXPECT_EQ(routes.getOverflowCount(), 0u);
+
+    NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWROUTE);
+    NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWLINK);
+}
+
+TEST(ThreadedNetLink, ringFull)
+{
+    OrderRecorder recorder;
+    NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &recorder);
+
+    ThreadedNetLink links(0, 4);
+    links.start();
+    inject(links, RTM_NEWLINK, 100);
+    waitPending(links, 4);
+
+    Select s;
+    s.addSelectable(&links);
+    runSelect(s, recorder, 100);
+
+    EXPECT_EQ(recorder.m_types.size(), 100u);
+    EXPECT_EQ(links.getDatagramCount(), 100u);
+
+    links.stop();
+    links.stop();
+
+    NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWLINK);
+}
+
+TEST(ThreadedNetLink, overflowResync)
+{
+    ResyncRecorder recorder;
+    NetDispatcher::getInstance().registerRawMessageHandler(RTM_NEWLINK, &recorder);
+
+    /* The ring fills up at once, the socket overflows behind it */
+    ThreadedNetLink links(0, 4);
+    links.setSockBufSize(4096);
+    links.setAdaptiveSockBufSize(65536);
+    links.enableAutoResync({ RTM_GETLINK });
+    links.registerGroup(RTNLGRP_NOTIFY);
+    links.start();
+
+    floodGroup(RTNLGRP_NOTIFY);
+
+    Select s;
+    s.addSelectable(&links);
+    for (int i = 0; i < 1000 && recorder.m_resyncEnd == 0; i++)
+    {
+        Selectable *sel;
+        s.select(&sel, 100);
+    }
+
+    EXPECT_GE(links.getOverflowCount(), 1u);
+    EXPECT_EQ(recorder.m_resyncBegin, 1);
+    EXPECT_EQ(recorder.m_resyncEnd, 1);
+    EXPECT_FALSE(links.isResyncInProgress());
+    EXPECT_GT(links.getSockBufSize(), 4096u);
+    EXPECT_LE(links.getSockBufSize(), 65536u);
+
+    links.stop();
+    NetDispatcher::getInstance().unregisterRawMessageHandler(RTM_NEWLINK);
+}
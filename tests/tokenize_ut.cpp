@@ -54,6 +54,13 @@ TEST(TOKENIZE, IP_2)
     EXPECT_EQ(origin, result);
 }
 
+TEST(TOKENIZE, IP_invalid)
+{
+    EXPECT_THROW(IpAddresses("192.168.0.1,192.168.0"), invalid_argument);
+    EXPECT_THROW(IpAddresses("192.168.0.1,,fc00::1"), invalid_argument);
+    EXPECT_EQ(IpAddresses("192.168.0.1,fc00::1,").getSize(), 2u);
+}
+
 TEST(TOKENIZEFIRST, zero)
 {
     string key("Hello world!");
@@ -115,3 +122,91 @@ TEST(TOKENIZEFISRT, not_found)
 
     EXPECT_EQ(tokens_2[0], key_2);
 }
+
+TEST(TOKENIZE, empty_tokens)
+{
+    EXPECT_EQ(tokenize("", ':'), vector<string>());
+    EXPECT_EQ(tokenize("a:", ':'), vector<string>({"a"}));
+    EXPECT_EQ(tokenize("a::", ':'), vector<string>({"a", ""}));
+    EXPECT_EQ(tokenize(":a", ':'), vector<string>({"", "a"}));
+
+    EXPECT_EQ(tokenize("", ':', 1), vector<string>({""}));
+    EXPECT_EQ(tokenize("a:", ':', 1), vector<string>({"a", ""}));
+    EXPECT_EQ(tokenize("a::", ':', 5), vector<string>({"a", "", ""}));
+}
+
+static vector<string> collect(Tokenizer tokenizer)
+{
+    vector<string> tokens;
+    StringRef tok;
+
+    while (tokenizer.next(tok))
+        tokens.push_back(tok.str());
+
+    return tokens;
+}
+
+TEST(Tokenizer, same_as_tokenize)
+{
+    vector<string> keys = {
+        "", ":", "::", "a", "a:", ":a", "a::b", "Ethernet0|10.0.0.1/31",
+        "VLAN|Vlan100", "NEIGH_TABLE:lo:fc00::79", "neigh:00:00:00:00:00:00",
+    };
+
+    for (const auto &key : keys)
+    {
+        for (char token : {':', '|'})
+        {
+            EXPECT_EQ(collect(Tokenizer(key, token)), tokenize(key, token)) << key;
+
+            for (size_t firstN = 0; firstN < 8; firstN++)
+            {
+                EXPECT_EQ(collect(Tokenizer(key, token, firstN)), tokenize(key, token, firstN))
+                    << key << " " << firstN;
+            }
+        }
+    }
+}
+
+TEST(Tokenizer, rest)
+{
+    string key("NEIGH_TABLE:lo:fc00::79");
+    Tokenizer tokenizer(key, ':');
+    StringRef tok;
+
+    EXPECT_TRUE(tokenizer.next(tok));
+    EXPECT_EQ(tok, "NEIGH_TABLE");
+    EXPECT_EQ(tokenizer.rest(), "lo:fc00::79");
+
+    EXPECT_TRUE(tokenizer.next(tok));
+    EXPECT_EQ(tok, "lo");
+    EXPECT_EQ(tokenizer.rest(), "fc00::79");
+}
+
+TEST(Tokenizer, fixed_array)
+{
+    StringRef tokens[2];
+    string intf("Ethernet0|10.0.0.1/31");
+    string vlan("VLAN|Vlan100|extra");
+    string single("Vlan100");
+
+    EXPECT_EQ(tokenize(intf, '|', tokens), 2u);
+    EXPECT_EQ(tokens[0], "Ethernet0");
+    EXPECT_EQ(tokens[1], "10.0.0.1/31");
+
+    EXPECT_EQ(tokenize(vlan, '|', tokens), 2u);
+    EXPECT_EQ(tokens[0], "VLAN");
+    EXPECT_EQ(tokens[1], "Vlan100|extra");
+
+    EXPECT_EQ(tokenize(single, '|', tokens), 1u);
+    EXPECT_EQ(tokens[0], "Vlan100");
+
+    StringRef many[4];
+    string key("NEIGH_TABLE:lo:fc00::79");
+    EXPECT_EQ(tokenize(key, ':', many), 4u);
+    EXPECT_EQ(many[0], "NEIGH_TABLE");
+    EXPECT_EQ(many[1], "lo");
+    EXPECT_EQ(many[2], "fc00");
+    EXPECT_EQ(many[3], ":79");
+    EXPECT_EQ(many[0].data(), key.data());
+}
@@ -0,0 +1,221 @@
+#include <time.h>
+#include <unistd.h>
+#include <fstream>
+#include <map>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "common/trace.h"
+#include "common/dbconnector.h"
+#include "common/select.h"
+#include "common/producerstatetable.h"
+#include "common/consumerstatetable.h"
+
+using namespace std;
+using namespace swss;
+
+static const string TRACE_FILE = "./trace_ut.trace";
+
+static void clearTraceTable(DBConnector &db, const string &tableName)
+{
+    for (const auto &key : db.keys("*" + tableName + "*"))
+        db.del(key);
+}
+
+TEST(Trace, records)
+{
+    Trace::open(TRACE_FILE, 16);
+    EXPECT_TRUE(Trace::isEnabled());
+
+    uint64_t before = static_cast<uint64_t>(time(NULL)) * 1000000000ULL;
+    {
+        TraceSpan span(TRACE_PRODUCER_SET, string("ROUTE_TABLE"), string("10.0.0.0/8"));
+    }
+    {
+        TraceSpan span(TRACE_CONSUMER_POPS, string("ROUTE_TABLE"));
+        span.setCount(42);
+    }
+    uint64_t after = static_cast<uint64_t>(time(NULL) + 1) * 1000000000ULL;
+
+    Trace::close();
+    EXPECT_FALSE(Trace::isEnabled());
+    {
+        TraceSpan span(TRACE_PRODUCER_DEL, string("ROUTE_TABLE"), string("not traced"));
+    }
+
+    TraceReader reader(TRACE_FILE);
+    EXPECT_EQ(reader.getPid(), static_cast<uint64_t>(getpid()));
+
+    auto entries = reader.read();
+    ASSERT_EQ(entries.size(), 2U);
+
+    EXPECT_EQ(entries[0].seq, 0U);
+    EXPECT_EQ(entries[0].event, TRACE_PRODUCER_SET);
+    EXPECT_EQ(entries[0].table, "ROUTE_TABLE");
+    EXPECT_EQ(entries[0].key, "10.0.0.0/8");
+    EXPECT_EQ(entries[0].count, 0U);
+    EXPECT_GE(entries[0].timestamp, before);
+    EXPECT_LE(entries[0].timestamp + entries[0].duration, after);
+
+    EXPECT_EQ(entries[1].seq, 1U);
+    EXPECT_EQ(entries[1].event, TRACE_CONSUMER_POPS);
+    EXPECT_EQ(entries[1].key, "");
+    EXPECT_EQ(entries[1].count, 42U);
+    EXPECT_GE(entries[1].timestamp, entries[0].timestamp);
+
+    unlink(TRACE_FILE.c_str());
+}
+
+TEST(Trace, truncate)
+{
+    Trace::open(TRACE_FILE, 4);
+
+    string table(100, 't');
+    string key(100, 'k');
+    {
+        TraceSpan span(TRACE_PRODUCER_SET, table, key);
+    }
+    Trace::close();
+
+    auto entries = TraceReader(TRACE_FILE).read();
+    ASSERT_EQ(entries.size(), 1U);
+    EXPECT_EQ(entries[0].table, table.substr(0, TRACE_TABLE_SIZE));
+    EXPECT_EQ(entries[0].key, key.substr(0, TRACE_KEY_SIZE));
+
+    unlink(TRACE_FILE.c_str());
+}
+
+TEST(Trace, wraparound)
+{
+    /* Rounded up to 8 records */
+    Trace::open(TRACE_FILE, 5);
+
+    for (int i = 0; i < 20; i++)
+    {
+        TraceSpan span(TRACE_PRODUCER_SET, string("TABLE"), to_string(i));
+    }
+    Trace::close();
+
+    auto entries = TraceReader(TRACE_FILE).read();
+    ASSERT_EQ(entries.size(), 8U);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        EXPECT_EQ(entries[i].seq, 12 + i);
+        EXPECT_EQ(entries[i].key, to_string(12 + i));
+    }
+
+    unlink(TRACE_FILE.c_str());
+}
+
+TEST(Trace, threads)
+{
+    const int threads = 4;
+    const int records = 2000;
+
+    Trace::open(TRACE_FILE, threads * records);
+
+    vector<thread> writers;
+    for (int t = 0; t < threads; t++)
+    {
+        writers.emplace_back([t, records]() {
+            string table = "TABLE_" + to_string(t);
+            for (int i = 0; i < records; i++)
+            {
+                TraceSpan span(TRACE_PRODUCER_SET, table, to_string(i));
+            }
+        });
+    }
+
+    /* Reading while written only returns complete records */
+    for (int i = 0; i < 10; i++)
+    {
+        for (const auto &entry : TraceReader(TRACE_FILE).read())
+            EXPECT_EQ(entry.table.compare(0, 6, "TABLE_"), 0);
+    }
+
+    for (auto &writer : writers)
+        writer.join();
+    Trace::close();
+
+    auto entries = TraceReader(TRACE_FILE).read();
+    ASSERT_EQ(entries.size(), static_cast<size_t>(threads * records));
+
+    map<string, int> next;
+    map<string, uint32_t> tids;
+    for (const auto &entry : entries)
+    {
+        /* In order within each thread */
+        EXPECT_EQ(entry.key, to_string(next[entry.table]++));
+
+        auto it = tids.emplace(entry.table, entry.tid).first;
+        EXPECT_EQ(it->second, entry.tid);
+    }
+    EXPECT_EQ(tids.size(), static_cast<size_t>(threads));
+
+    unlink(TRACE_FILE.c_str());
+}
+
+TEST(Trace, invalidFile)
+{
+    EXPECT_THROW(TraceReader reader("./trace_ut.missing"), runtime_error);
+
+    {
+        ofstream file(TRACE_FILE);
+        file << string(2 * TRACE_HEADER_SIZE, 'x');
+    }
+    EXPECT_THROW(TraceReader reader(TRACE_FILE), runtime_error);
+
+    unlink(TRACE_FILE.c_str());
+}
+
+TEST(Trace, tables)
+{
+    string tableName = "UT_TRACE_TABLE";
+    DBConnector db("APPL_DB", 0, true);
+    clearTraceTable(db, tableName);
+
+    ProducerStateTable p(&db, tableName);
+    ConsumerStateTable c(&db, tableName);
+    Select s;
+    s.addSelectable(&c);
+
+    Trace::open(TRACE_FILE);
+
+    p.set("key1", { { "field", "value" } });
+    p.set("key2", { { "field", "value" } });
+    p.del("key1");
+
+    Selectable *sel;
+    ASSERT_EQ(s.select(&sel, 1000), Select::OBJECT);
+    deque<KeyOpFieldsValuesTuple> kcos;
+    c.pops(kcos);
+    EXPECT_EQ(kcos.size(), 2U);
+
+    Trace::close();
+
+    map<TraceEvent, vector<TraceEntry>> events;
+    for (const auto &entry : TraceReader(TRACE_FILE).read())
+        events[entry.event].push_back(entry);
+
+    ASSERT_EQ(events[TRACE_PRODUCER_SET].size(), 2U);
+    EXPECT_EQ(events[TRACE_PRODUCER_SET][0].table, tableName);
+    EXPECT_EQ(events[TRACE_PRODUCER_SET][0].key, "key1");
+    EXPECT_EQ(events[TRACE_PRODUCER_SET][1].key, "key2");
+
+    ASSERT_EQ(events[TRACE_PRODUCER_DEL].size(), 1U);
+    EXPECT_EQ(events[TRACE_PRODUCER_DEL][0].key, "key1");
+
+    /* Each unbuffered operation flushes one reply */
+    ASSERT_EQ(events[TRACE_PIPELINE_FLUSH].size(), 3U);
+    EXPECT_EQ(events[TRACE_PIPELINE_FLUSH][0].count, 1U);
+
+    ASSERT_EQ(events[TRACE_CONSUMER_POPS].size(), 1U);
+    EXPECT_EQ(events[TRACE_CONSUMER_POPS][0].table, tableName);
+    EXPECT_EQ(events[TRACE_CONSUMER_POPS][0].count, 2U);
+
+    ASSERT_EQ(events[TRACE_SELECT_DISPATCH].size(), 1U);
+    EXPECT_EQ(events[TRACE_SELECT_DISPATCH][0].table, typeid(ConsumerStateTable).name());
+    EXPECT_EQ(events[TRACE_SELECT_DISPATCH][0].count, static_cast<uint32_t>(c.getFd()));
+
+    unlink(TRACE_FILE.c_str());
+}